@@ -0,0 +1,75 @@
+// Semantic analysis: one large generated source whose functions are all well
+// typed is parsed once and analyzed with the function bodies checked on 1, 2,
+// 4, ... threads up to the hardware thread count. Bodies only read the frozen
+// global table, so the check should scale with the threads while the
+// sequential collection of the globals stays the same; the speedup column is
+// against a single thread.
+
+#include <memory>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <analyzer.hpp>
+
+int main()
+{
+    const size_t SOURCE_SIZE = 16 << 20;
+    const unsigned int REPEAT = 3;
+
+    std::string input;
+    SourceGenerator generator(23);
+    generator.generate(SHAPE_CHECKED, SOURCE_SIZE, &input);
+
+    TokenStack stack;
+    AST* ast = parse(input, &stack);
+
+    if(ast == nullptr)
+    {
+        printf("analyzer: failed to parse the generated source\n");
+        return 1;
+    }
+
+    unsigned int threads = ThreadPool::HardwareThreads();
+    printf("%zu MB of checked source, %u hardware threads\n", input.size() >> 20, threads);
+    printf("%-8s %10s %10s %12s %8s\n", "threads", "globals", "functions", "ms", "speedup");
+
+    std::vector<unsigned int> counts;
+    for(unsigned int count = 1; count < threads; count *= 2)
+    {
+        counts.push_back(count);
+    }
+    counts.push_back(threads);
+
+    int result = 0;
+    double single = 0.0;
+    for(unsigned int j = 0; (result == 0) && (j < counts.size()); j++)
+    {
+        unsigned int count = counts[j];
+        std::unique_ptr<ThreadPool> pool((count > 1) ? new ThreadPool(count) : nullptr);
+
+        double best = 1e30;
+        Analyzer::Stats stats = {};
+        for(unsigned int i = 0; i < REPEAT; i++)
+        {
+            Timer timer;
+            if(!Analyzer::Analyze(ast, pool.get(), &stats))
+            {
+                printf("analyzer: %u errors in a source that should have none\n", stats.errors);
+                result = 1;
+                break;
+            }
+            double seconds = timer.seconds();
+            best = (seconds < best) ? seconds : best;
+        }
+
+        if(result == 0)
+        {
+            single = (count == 1) ? best : single;
+            printf("%-8u %10u %10u %12.2f %7.2fx\n", count, stats.globals, stats.functions, best * 1e3, single / best);
+        }
+    }
+
+    delete_ast(ast);
+    return result;
+}
@@ -0,0 +1,135 @@
+// AST allocation: parse throughput with every node coming from the AST's
+// arena, and the same number of node-sized allocations made one by one with
+// new and delete, as the parser did before, to show what the arena saves in
+// time and resident memory. The tree is parsed from tokens lexed up front so
+// the lexer does not dilute the numbers.
+
+#include <string.h>
+
+#include <vector>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+static char* volatile sink;
+
+int main()
+{
+    const unsigned int SIZE = 8 * 1024 * 1024;
+    const unsigned int REPEAT = 3;
+
+    std::string input;
+    SourceGenerator generator(5);
+    generator.generate(SHAPE_MIXED, SIZE, &input);
+
+    TokenStack stack;
+    if(!Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &stack))
+    {
+        printf("ast: tokenizer failure\n");
+        return 1;
+    }
+
+    // resident memory first, before this process has parsed anything
+    size_t arena_resident = measure_resident([&]
+    {
+        Parser::Parse(stack);
+    });
+
+    size_t heap_resident = measure_resident([&]
+    {
+        // the tree's chunks are returned to the system when it is deleted
+        stack.rewind(0);
+        AST* ast = Parser::Parse(stack);
+        Arena::Stats stats = ast->arena.get_stats();
+        delete_ast(ast);
+
+        // each block links to the previous one so no array is needed to
+        // keep them alive
+        size_t size = stats.allocated / stats.allocations;
+        char* chain = nullptr;
+        for(size_t j = 0; j < stats.allocations; j++)
+        {
+            char* block = new char[size]();
+            memcpy(block, &chain, sizeof(chain));
+            chain = block;
+        }
+        sink = chain;
+    });
+
+    double parse_best = 1e30;
+    double teardown_best = 1e30;
+    Arena::Stats nodes = {};
+
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        stack.rewind(0);
+
+        Timer timer;
+        AST* ast = Parser::Parse(stack);
+        double t = timer.seconds();
+        parse_best = (t < parse_best) ? t : parse_best;
+
+        if(ast == nullptr)
+        {
+            printf("ast: parser failure\n");
+            return 1;
+        }
+
+        nodes = ast->arena.get_stats();
+
+        timer.reset();
+        delete_ast(ast);
+        t = timer.seconds();
+        teardown_best = (t < teardown_best) ? t : teardown_best;
+    }
+
+    report("parse", "arena", (double) input.size(), parse_best);
+
+    // the same allocations, one heap block per node of the average node size
+    size_t size = (nodes.allocations > 0) ? (nodes.allocated / nodes.allocations) : 0;
+    std::vector<char*> blocks(nodes.allocations);
+
+    double heap_best = 1e30;
+    double free_best = 1e30;
+
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        Timer timer;
+        for(size_t j = 0; j < blocks.size(); j++)
+        {
+            blocks[j] = new char[size]();
+        }
+        double t = timer.seconds();
+        heap_best = (t < heap_best) ? t : heap_best;
+
+        timer.reset();
+        for(size_t j = 0; j < blocks.size(); j++)
+        {
+            delete[] blocks[j];
+        }
+        t = timer.seconds();
+        free_best = (t < free_best) ? t : free_best;
+    }
+
+    double arena_best = 1e30;
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        AstArena arena;
+        Timer timer;
+        for(size_t j = 0; j < blocks.size(); j++)
+        {
+            blocks[j] = (char*) arena.allocate(size, alignof(void*));
+        }
+        double t = timer.seconds();
+        arena_best = (t < arena_best) ? t : arena_best;
+    }
+
+    double count = (nodes.allocations > 0) ? (double) nodes.allocations : 1.0;
+    printf("nodes: %zu allocations, %zu bytes in %zu chunks, %zu bytes wasted\n",
+           nodes.allocations, nodes.allocated, nodes.chunks, nodes.reserved - nodes.allocated);
+    printf("allocate: arena %.2f ns/node, heap %.2f ns/node\n", arena_best * 1e9 / count, heap_best * 1e9 / count);
+    printf("teardown: arena %.3f ms, heap %.3f ms\n", teardown_best * 1e3, free_best * 1e3);
+    printf("resident: arena %zu KB, heap %zu KB\n", arena_resident / 1024, heap_resident / 1024);
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <parser.hpp>
+#include <tokenizer.hpp>
+
+// Small helpers shared by the benchmark executables in this directory.
+
+class Timer
+{
+private:
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    Timer() { reset(); }
+
+    void reset() { m_start = std::chrono::steady_clock::now(); }
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+};
+
+// deterministic xorshift generator so every run lexes the same input
+class Random
+{
+private:
+    uint64_t m_state;
+
+public:
+    Random(uint64_t seed) { m_state = (seed != 0) ? seed : 0x9E3779B97F4A7C15ull; }
+
+    uint64_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+    unsigned int range(unsigned int lo, unsigned int hi) { return lo + (unsigned int) (next() % (hi - lo + 1)); }
+};
+
+static inline void append_identifier(std::string& out, Random& rng, unsigned int len)
+{
+    static const char FIRST[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char REST[]  = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+
+    out.push_back(FIRST[rng.next() % (sizeof(FIRST) - 1)]);
+    for(unsigned int i = 1; i < len; i++)
+    {
+        out.push_back(REST[rng.next() % (sizeof(REST) - 1)]);
+    }
+}
+
+// resident set size of this process, 0 where /proc is not available
+static inline size_t resident_bytes()
+{
+    size_t bytes = 0;
+
+    FILE* file = fopen("/proc/self/statm", "r");
+    if(file != nullptr)
+    {
+        unsigned long size = 0, resident = 0;
+        if(fscanf(file, "%lu %lu", &size, &resident) == 2)
+        {
+            bytes = (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+        }
+        fclose(file);
+    }
+
+    return bytes;
+}
+
+// how much resident memory fn() adds while it runs. It runs in a forked
+// child, so memory an earlier measurement freed but the allocator kept does
+// not hide the cost. fn should leave what it measures allocated.
+template<typename F>
+static inline size_t measure_resident(F fn)
+{
+    size_t growth = 0;
+
+    int fds[2];
+    if(pipe(fds) == 0)
+    {
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            size_t before = resident_bytes();
+            fn();
+            size_t after = resident_bytes();
+
+            growth = (after > before) ? (after - before) : 0;
+            ssize_t written = write(fds[1], &growth, sizeof(growth));
+            _exit((written == (ssize_t) sizeof(growth)) ? 0 : 1);
+        }
+        else if(pid > 0)
+        {
+            if(read(fds[0], &growth, sizeof(growth)) != (ssize_t) sizeof(growth))
+            {
+                growth = 0;
+            }
+            waitpid(pid, nullptr, 0);
+        }
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    return growth;
+}
+
+// lexes and parses input, nullptr if either fails; the tree refers to the
+// names and strings kept by stack
+static inline AST* parse(const std::string& input, TokenStack* stack)
+{
+    AST* ast = nullptr;
+    if(Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), (unsigned int) input.size()), stack))
+    {
+        ast = Parser::Parse(*stack);
+    }
+    return ast;
+}
+
+static inline void report(const char* name, const char* variant, double bytes, double seconds)
+{
+    printf("%-24s %-8s %10.2f MB/s\n", name, variant, (bytes / (1024.0 * 1024.0)) / seconds);
+}
+
+// Timings of small primitives. Each run() calls fn a few times to warm up,
+// then takes a number of samples; fn runs the primitive in a loop and returns
+// how many operations it did, and each sample is kept as nanoseconds per
+// operation. A result holds percentiles over the samples, so one preempted
+// sample shows up in the tail instead of moving the median.
+class MicroBench
+{
+public:
+    struct Result
+    {
+        std::string name;
+        double ops;   // operations per sample
+        double min;   // nanoseconds per operation from here on
+        double p50;
+        double p90;
+        double p99;
+        double max;
+        double mean;
+    };
+
+private:
+    std::vector<Result> m_results;
+    unsigned int m_warmup;
+    unsigned int m_samples;
+
+public:
+    MicroBench(unsigned int warmup = 3, unsigned int samples = 31)
+    {
+        m_warmup = warmup;
+        m_samples = (samples > 0) ? samples : 1;
+    }
+
+    template<typename F>
+    const Result& run(const char* name, F fn)
+    {
+        for(unsigned int i = 0; i < m_warmup; i++)
+        {
+            fn();
+        }
+
+        std::vector<double> samples;
+        double ops = 0.0;
+        for(unsigned int i = 0; i < m_samples; i++)
+        {
+            Timer timer;
+            ops = (double) fn();
+            double t = timer.seconds();
+            samples.push_back((ops > 0.0) ? (t * 1e9 / ops) : 0.0);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        // nearest rank
+        size_t last = samples.size() - 1;
+        Result result;
+        result.name = name;
+        result.ops = ops;
+        result.min = samples[0];
+        result.p50 = samples[last * 50 / 100];
+        result.p90 = samples[last * 90 / 100];
+        result.p99 = samples[last * 99 / 100];
+        result.max = samples[last];
+        result.mean = 0.0;
+        for(double sample : samples)
+        {
+            result.mean += sample / (double) samples.size();
+        }
+
+        m_results.push_back(result);
+        printf("%-28s %10.0f %9.2f %9.2f %9.2f %9.2f %9.2f\n", name, ops, result.min, result.p50, result.p90, result.p99, result.max);
+        return m_results.back();
+    }
+
+    static void PrintHeader()
+    {
+        printf("%-28s %10s %9s %9s %9s %9s %9s\n", "ns per op", "ops", "min", "p50", "p90", "p99", "max");
+    }
+
+    bool write_json(const char* path) const
+    {
+        FILE* file = fopen(path, "w");
+        bool status = (file != nullptr);
+        if(status)
+        {
+            fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"samples\": %u,\n  \"results\": [\n", m_samples);
+            for(size_t i = 0; i < m_results.size(); i++)
+            {
+                const Result& r = m_results[i];
+                fprintf(file, "    { \"name\": \"%s\", \"ops\": %.0f, \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+                              "\"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f }%s\n",
+                        r.name.c_str(), r.ops, r.min, r.p50, r.p90, r.p99, r.max, r.mean, (i + 1 < m_results.size()) ? "," : "");
+            }
+            fprintf(file, "  ]\n}\n");
+            fclose(file);
+        }
+        return status;
+    }
+};
+
+#endif // BENCH_HPP
@@ -0,0 +1,133 @@
+// Constant evaluation: a chain of const globals, each defined in terms of the
+// two before it, is evaluated name by name. Every name is a tree that doubles
+// with each step when unfolded, so without results kept per node the last
+// ones could not be evaluated at all; with them every node is evaluated once.
+// Then generated sources of the checked shape are folded, and the folded tree
+// must still pass semantic analysis, as a fold keeps the type of what it
+// replaces.
+
+#include <vector>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <analyzer.hpp>
+#include <constant_evaluator.hpp>
+
+// const U32 c_0 = 1; const U32 c_1 = 1; const U32 c_k = c_{k-1} + c_{k-2} * 3u32 ...
+static std::string make_chain(unsigned int count)
+{
+    std::string out = "const U32 c_0 = 1;\nconst U32 c_1 = 1;\n";
+    for(unsigned int k = 2; k < count; k++)
+    {
+        out += "const U32 c_" + std::to_string(k) + " = c_" + std::to_string(k - 1) + " + c_" + std::to_string(k - 2) + " * 3u32;\n";
+    }
+    return out;
+}
+
+static int chain()
+{
+    const unsigned int COUNT = 100000;
+
+    std::string input = make_chain(COUNT);
+    TokenStack stack;
+    AST* ast = parse(input, &stack);
+    if(ast == nullptr)
+    {
+        printf("constant_evaluator: failed to parse the chain\n");
+        return 1;
+    }
+
+    SymbolTable globals;
+    for(const Statement* stmt : ast->statements)
+    {
+        const Declaration* decl = stmt->data.declarations[0];
+        globals.insert(SymbolTable::Entry { SYM_VARIABLE, decl->name, decl, decl->data.variable.type });
+    }
+
+    // the chain wraps at 32 bits, which is its value as a U32 constant
+    uint32_t expected[2] = { 1, 1 };
+
+    // a reference to each name, as a consumer would hold one
+    std::vector<Expression> names(COUNT);
+    for(unsigned int k = 0; k < COUNT; k++)
+    {
+        names[k].type = EXPR_IDENTIFIER;
+        names[k].data.identifier = ast->statements[k]->data.declarations[0]->name;
+    }
+
+    int result = 0;
+    ConstantEvaluator evaluator(&globals);
+    Timer timer;
+    for(unsigned int k = 0; (result == 0) && (k < COUNT); k++)
+    {
+        Constant value = {};
+        const char* error = nullptr;
+        uint32_t want = (k < 2) ? 1 : (expected[(k - 1) & 1] + expected[k & 1] * 3u);
+        if(!evaluator.evaluate(&names[k], nullptr, &value, &error) || (value.type != TYPE_U32) || (value.data.integer != want))
+        {
+            printf("constant_evaluator: c_%u is wrong\n", k);
+            result = 1;
+        }
+        expected[k & 1] = want;
+    }
+    double seconds = timer.seconds();
+
+    if(result == 0)
+    {
+        printf("%u chained constants: %zu nodes evaluated, %.1f ns per constant\n", COUNT, evaluator.size(), seconds * 1e9 / COUNT);
+    }
+
+    delete_ast(ast);
+    return result;
+}
+
+static int fold()
+{
+    printf("%-8s %10s %10s %12s %10s\n", "MB", "folded", "ms", "MB/s", "checked");
+
+    int result = 0;
+    for(unsigned int mb = 1; (result == 0) && (mb <= 16); mb *= 4)
+    {
+        std::string input;
+        SourceGenerator generator(24 + mb);
+        generator.generate(SHAPE_CHECKED, (size_t) mb << 20, &input);
+
+        TokenStack stack;
+        AST* ast = parse(input, &stack);
+        if(ast == nullptr)
+        {
+            printf("constant_evaluator: failed to parse %u MB\n", mb);
+            result = 1;
+            break;
+        }
+
+        Timer timer;
+        unsigned int folded = ConstantEvaluator::Fold(ast);
+        double seconds = timer.seconds();
+
+        Analyzer::Stats stats = {};
+        bool checked = Analyzer::Analyze(ast, nullptr, &stats);
+        printf("%-8u %10u %10.2f %12.1f %10s\n", mb, folded, seconds * 1e3, (double) input.size() / (1 << 20) / seconds, checked ? "yes" : "no");
+
+        if(!checked || (folded == 0))
+        {
+            printf("constant_evaluator: the folded tree has %u errors\n", stats.errors);
+            result = 1;
+        }
+
+        delete_ast(ast);
+    }
+
+    return result;
+}
+
+int main()
+{
+    int result = chain();
+    if(result == 0)
+    {
+        result = fold();
+    }
+    return result;
+}
@@ -0,0 +1,101 @@
+// Multi-file compilation: a directory of generated translation units compiled
+// by the driver with 1, 2, 4, ... jobs up to the hardware thread count. Files
+// share nothing, so throughput should scale with the jobs until the cores run
+// out; the speedup column is against a single job.
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <stdlib.h>
+
+#include <driver.hpp>
+#include <thread_pool.hpp>
+
+static bool write_file(const std::string& path, const std::string& data)
+{
+    bool status = false;
+
+    FILE* file = fopen(path.c_str(), "w");
+    if(file != nullptr)
+    {
+        status = fwrite(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+    }
+
+    return status;
+}
+
+int main()
+{
+    const unsigned int FILES = 256;
+    const unsigned int FILE_SIZE = 32 * 1024;
+    const unsigned int REPEAT = 3;
+
+    char dir[] = "/tmp/c64_driver_XXXXXX";
+    if(mkdtemp(dir) == nullptr)
+    {
+        printf("driver: could not create a temporary directory\n");
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    for(unsigned int i = 0; i < FILES; i++)
+    {
+        std::string source;
+        SourceGenerator generator(8 + i);
+        generator.generate(SHAPE_MIXED, FILE_SIZE, &source);
+
+        std::string path = std::string(dir) + "/unit" + std::to_string(i) + ".c";
+        if(!write_file(path, source))
+        {
+            printf("driver: could not write %s\n", path.c_str());
+            return 1;
+        }
+        paths.push_back(path);
+    }
+
+    unsigned int threads = ThreadPool::HardwareThreads();
+    printf("%u files of %u KB, %u hardware threads\n", FILES, FILE_SIZE / 1024, threads);
+    printf("%-6s %12s %12s %10s %8s\n", "jobs", "wall ms", "cpu ms", "files/s", "speedup");
+
+    std::vector<unsigned int> counts;
+    for(unsigned int jobs = 1; jobs < threads; jobs *= 2)
+    {
+        counts.push_back(jobs);
+    }
+    counts.push_back(threads);
+
+    int result = 0;
+    double single = 0.0;
+    for(unsigned int j = 0; (result == 0) && (j < counts.size()); j++)
+    {
+        unsigned int jobs = counts[j];
+        Driver::Summary best = {};
+        best.wall_seconds = 1e30;
+
+        for(unsigned int i = 0; i < REPEAT; i++)
+        {
+            std::vector<Driver::Unit> units;
+            Driver::Summary summary = {};
+            if(!Driver::Compile(paths, jobs, false, &units, &summary))
+            {
+                printf("driver: compile failure\n");
+                result = 1;
+                break;
+            }
+            best = (summary.wall_seconds < best.wall_seconds) ? summary : best;
+        }
+
+        single = (jobs == 1) ? best.wall_seconds : single;
+        printf("%-6u %12.2f %12.2f %10.1f %7.2fx\n", jobs, best.wall_seconds * 1e3, best.cpu_seconds * 1e3,
+               (double) FILES / best.wall_seconds, single / best.wall_seconds);
+    }
+
+    for(const std::string& path : paths)
+    {
+        remove(path.c_str());
+    }
+    remove(dir);
+
+    return result;
+}
@@ -0,0 +1,53 @@
+// Expression parsing: function bodies made almost entirely of long
+// expressions mixing every precedence level, prefix and postfix operators,
+// calls, indexing and casts. The tokens are lexed up front so only the parser
+// is timed.
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+int main()
+{
+    const unsigned int SIZE = 8 * 1024 * 1024;
+    const unsigned int REPEAT = 5;
+
+    std::string input;
+    SourceGenerator generator(7);
+    generator.generate(SHAPE_EXPRESSIONS, SIZE, &input);
+
+    TokenStack stack;
+    if(!Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &stack))
+    {
+        printf("expressions: tokenizer failure\n");
+        return 1;
+    }
+
+    double best = 1e30;
+    Arena::Stats nodes = {};
+
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        stack.rewind(0);
+
+        Timer timer;
+        AST* ast = Parser::Parse(stack);
+        double t = timer.seconds();
+        best = (t < best) ? t : best;
+
+        if(ast == nullptr)
+        {
+            printf("expressions: parser failure\n");
+            return 1;
+        }
+
+        nodes = ast->arena.get_stats();
+        delete_ast(ast);
+    }
+
+    report("expressions", "parse", (double) input.size(), best);
+    printf("nodes: %zu allocations, %zu bytes, %.2f M allocations/s\n",
+           nodes.allocations, nodes.allocated, (double) nodes.allocations / best / 1e6);
+    printf("tokens: %u, %.2f allocations per token\n", stack.size(), (double) nodes.allocations / (double) stack.size());
+
+    return 0;
+}
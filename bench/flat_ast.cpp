@@ -0,0 +1,239 @@
+// The flat AST against the linked one: bytes held by each form of the same
+// tree, the cost of flattening, and a full walk over every expression and
+// statement of both.
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <flat_ast.hpp>
+
+static size_t walk(const Expression* expr);
+static size_t walk(const Statement* stmt);
+
+static size_t walk(const List<Statement>* list)
+{
+    size_t count = 0;
+    for(const Statement* stmt : *list)
+    {
+        count += walk(stmt);
+    }
+    return count;
+}
+
+static size_t walk(const Expression* expr)
+{
+    size_t count = 0;
+    if(expr != nullptr)
+    {
+        count = 1;
+        switch(expr->type)
+        {
+            case EXPR_OPERATION:   { count += walk(expr->data.operation.lhs) + walk(expr->data.operation.rhs); break; }
+            case EXPR_SUB_EXPR:    { count += walk(expr->data.sub_expr); break; }
+            case EXPR_STATIC_CAST: { count += walk(expr->data.cast.expr); break; }
+            case EXPR_FUNCTION_CALL:
+            {
+                count += walk(expr->data.func_call.function);
+                for(const Expression* arg : expr->data.func_call.arguments)
+                {
+                    count += walk(arg);
+                }
+                break;
+            }
+            default: { break; }
+        }
+    }
+    return count;
+}
+
+static size_t walk(const Statement* stmt)
+{
+    size_t count = 0;
+    if(stmt != nullptr)
+    {
+        count = 1;
+        switch(stmt->type)
+        {
+            case STMT_EXPR:   { count += walk(stmt->data.expr); break; }
+            case STMT_RETURN: { count += walk(stmt->data.ret_stmt.expression); break; }
+            case STMT_BLOCK:  { count += walk(&stmt->data.block.statements); break; }
+            case STMT_IF:
+            {
+                const Statement::CondExec& cond = stmt->data.cond_exec;
+                count += walk(cond.condition) + walk(cond.on_true) + walk(cond.on_false);
+                break;
+            }
+            case STMT_FOR:
+            {
+                const Statement::ForLoop& loop = stmt->data.for_loop;
+                count += walk(loop.init) + walk(loop.cond) + walk(loop.step) + walk(loop.body);
+                break;
+            }
+            case STMT_WHILE:
+            {
+                count += walk(stmt->data.while_loop.cond) + walk(stmt->data.while_loop.body);
+                break;
+            }
+            case STMT_DECLARATION:
+            {
+                for(const Declaration* decl : stmt->data.declarations)
+                {
+                    if(decl->type == DECL_VARIABLE)
+                    {
+                        count += walk(decl->data.variable.value);
+                    }
+                    else if((decl->type == DECL_FUNCTION) && (decl->data.function.body != nullptr))
+                    {
+                        count += walk(decl->data.function.body);
+                    }
+                }
+                break;
+            }
+            default: { break; }
+        }
+    }
+    return count;
+}
+
+static size_t walk(const FlatAST& ast, FlatAST::Ref ref);
+
+static size_t walk(const FlatAST& ast, FlatAST::Range range)
+{
+    size_t count = 0;
+    for(uint32_t i = 0; i < range.count; i++)
+    {
+        count += walk(ast, ast.refs[range.first + i]);
+    }
+    return count;
+}
+
+static size_t walk(const FlatAST& ast, FlatAST::Ref ref)
+{
+    uint32_t index = FlatAST::index_of(ref);
+
+    size_t count = 1;
+    switch(FlatAST::kind_of(ref))
+    {
+        case FLAT_INVALID:         { count = 0; break; }
+        case FLAT_EXPR_OPERATION:  { count += walk(ast, ast.operations[index].lhs) + walk(ast, ast.operations[index].rhs); break; }
+        case FLAT_EXPR_SUB_EXPR:   { count += walk(ast, ast.sub_exprs[index]); break; }
+        case FLAT_EXPR_CAST:       { count += walk(ast, ast.casts[index].expr); break; }
+        case FLAT_EXPR_CALL:       { count += walk(ast, ast.calls[index].function) + walk(ast, ast.calls[index].arguments); break; }
+        case FLAT_STMT_EXPR:       { count += walk(ast, ast.expr_stmts[index]); break; }
+        case FLAT_STMT_RETURN:     { count += walk(ast, ast.return_stmts[index]); break; }
+        case FLAT_STMT_BLOCK:      { count += walk(ast, ast.blocks[index]); break; }
+        case FLAT_STMT_IF:
+        {
+            const FlatAST::If& cond = ast.if_stmts[index];
+            count += walk(ast, cond.condition) + walk(ast, cond.on_true) + walk(ast, cond.on_false);
+            break;
+        }
+        case FLAT_STMT_FOR:
+        {
+            const FlatAST::For& loop = ast.for_stmts[index];
+            count += walk(ast, loop.init) + walk(ast, loop.cond) + walk(ast, loop.step) + walk(ast, loop.body);
+            break;
+        }
+        case FLAT_STMT_WHILE:
+        {
+            count += walk(ast, ast.while_stmts[index].cond) + walk(ast, ast.while_stmts[index].body);
+            break;
+        }
+        case FLAT_STMT_DECLARATION:
+        {
+            // declarations themselves are not counted, as in the linked walk
+            FlatAST::Range decls = ast.declarations[index];
+            for(uint32_t i = 0; i < decls.count; i++)
+            {
+                FlatAST::Ref decl = ast.refs[decls.first + i];
+                if(FlatAST::kind_of(decl) == FLAT_DECL_VARIABLE)
+                {
+                    count += walk(ast, ast.variables[FlatAST::index_of(decl)].value);
+                }
+                else if(FlatAST::kind_of(decl) == FLAT_DECL_FUNCTION)
+                {
+                    const FlatAST::Function& function = ast.functions[FlatAST::index_of(decl)];
+                    if(function.body.first != FlatAST::NONE)
+                    {
+                        count += walk(ast, function.body);
+                    }
+                }
+            }
+            break;
+        }
+        default: { break; }
+    }
+    return count;
+}
+
+int main()
+{
+    const unsigned int SIZE = 8 * 1024 * 1024;
+    const unsigned int REPEAT = 5;
+
+    std::string input;
+    SourceGenerator generator(6);
+    generator.generate(SHAPE_MIXED, SIZE, &input);
+
+    TokenStack stack;
+    AST* ast = parse(input, &stack);
+    if(ast == nullptr)
+    {
+        printf("flat: failed to parse the generated source\n");
+        return 1;
+    }
+
+    double flatten_best = 1e30;
+    FlatAST flat = {};
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        flat = FlatAST();
+
+        Timer timer;
+        bool status = flatten_ast(ast, &flat);
+        double t = timer.seconds();
+        flatten_best = (t < flatten_best) ? t : flatten_best;
+
+        if(!status)
+        {
+            printf("flat: tree too large\n");
+            return 1;
+        }
+    }
+    report("flatten", "flat", (double) input.size(), flatten_best);
+
+    size_t linked_nodes = 0;
+    double linked_best = 1e30;
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        Timer timer;
+        linked_nodes = walk(&ast->statements);
+        double t = timer.seconds();
+        linked_best = (t < linked_best) ? t : linked_best;
+    }
+
+    size_t flat_nodes = 0;
+    double flat_best = 1e30;
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        Timer timer;
+        flat_nodes = walk(flat, flat.statements);
+        double t = timer.seconds();
+        flat_best = (t < flat_best) ? t : flat_best;
+    }
+
+    if(linked_nodes != flat_nodes)
+    {
+        printf("flat: walks disagree, %zu linked nodes, %zu flat nodes\n", linked_nodes, flat_nodes);
+        return 1;
+    }
+
+    Arena::Stats stats = ast->arena.get_stats();
+    printf("nodes: %zu linked allocations, %zu flat records\n", stats.allocations, flat.nodes());
+    printf("bytes: linked %zu, flat %zu (%.2fx smaller)\n", stats.allocated, flat.bytes(), (double) stats.allocated / (double) flat.bytes());
+    printf("walk: linked %.3f ms, flat %.3f ms over %zu nodes\n", linked_best * 1e3, flat_best * 1e3, flat_nodes);
+
+    delete_ast(ast);
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+// End-to-end front end: generated sources from 1 KB up to 4 MB, or up to a
+// size given in MB on the command line (1024 for 1 GB), are tokenized, parsed
+// and printed, and each phase reports its throughput and the peak resident
+// set reached by its end. Every size runs in a forked child so the peaks of
+// one size do not carry over to the next. Each shape also runs at 1 MB.
+//
+//     frontend.exe [max MB]
+//     frontend.exe --emit <shape> <bytes> [seed]   writes a source to stdout
+//
+// Shapes are mixed, expressions, globals, declarators, comments, literals and
+// checked.
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <ast_printer.hpp>
+#include <parser.hpp>
+#include <tokenizer.hpp>
+
+// most memory this process has held so far
+static size_t peak_resident_bytes()
+{
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return (size_t) usage.ru_maxrss;
+#else
+    return (size_t) usage.ru_maxrss * 1024;
+#endif
+}
+
+static void print_phase(const char* size, unsigned int shape, const char* phase, double bytes, double tokens, double nodes, double seconds)
+{
+    printf("%-8s %-12s %-9s %10.2f %11.2f ", size, SourceGenerator::ShapeName(shape), phase,
+           (bytes / (1024.0 * 1024.0)) / seconds, tokens / seconds / 1e6);
+
+    if(nodes > 0.0)
+    {
+        printf("%10.2f", nodes / seconds / 1e6);
+    }
+    else
+    {
+        printf("%10s", "-");
+    }
+
+    printf(" %12.1f\n", (double) peak_resident_bytes() / (1024.0 * 1024.0));
+}
+
+static std::string size_name(size_t size)
+{
+    return (size >= 1024 * 1024) ? std::to_string(size >> 20) + " MB" : std::to_string(size >> 10) + " KB";
+}
+
+// runs every phase over one generated source, in the calling process
+static bool measure(unsigned int shape, size_t size)
+{
+    std::string input;
+    SourceGenerator generator(10 + shape);
+    generator.generate(shape, size, &input);
+
+    // small inputs are repeated until about 4 MB has gone through each phase
+    unsigned int repeat = (unsigned int) ((4u << 20) / input.size());
+    repeat = (repeat < 1) ? 1 : ((repeat > 1000) ? 1000 : repeat);
+
+    std::string name = size_name(size);
+
+    TokenStack* stack = nullptr;
+    double tokenize_best = 1e30;
+    bool status = true;
+    for(unsigned int i = 0; status && (i < repeat); i++)
+    {
+        delete stack;
+        stack = new TokenStack();
+
+        Timer timer;
+        status = Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), (unsigned int) input.size()), stack);
+        double t = timer.seconds();
+        tokenize_best = (t < tokenize_best) ? t : tokenize_best;
+    }
+
+    if(!status)
+    {
+        printf("frontend: tokenizer failure on %s %s\n", name.c_str(), SourceGenerator::ShapeName(shape));
+    }
+    else
+    {
+        print_phase(name.c_str(), shape, "tokenize", (double) input.size(), (double) stack->size(), 0.0, tokenize_best);
+    }
+
+    AST* ast = nullptr;
+    double parse_best = 1e30;
+    for(unsigned int i = 0; status && (i < repeat); i++)
+    {
+        if(ast != nullptr)
+        {
+            delete_ast(ast);
+        }
+        stack->rewind(0);
+
+        Timer timer;
+        ast = Parser::Parse(*stack);
+        double t = timer.seconds();
+        parse_best = (t < parse_best) ? t : parse_best;
+
+        status = (ast != nullptr);
+    }
+
+    double nodes = 0.0;
+    if(!status)
+    {
+        printf("frontend: parser failure on %s %s\n", name.c_str(), SourceGenerator::ShapeName(shape));
+    }
+    else
+    {
+        nodes = (double) ast->arena.get_stats().allocations;
+        print_phase(name.c_str(), shape, "parse", (double) input.size(), (double) stack->size(), nodes, parse_best);
+    }
+
+    if(status)
+    {
+        // the printer writes to stdout, which is pointed at /dev/null meanwhile
+        fflush(stdout);
+        int saved = dup(STDOUT_FILENO);
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+
+        double print_best = 1e30;
+        for(unsigned int i = 0; i < repeat; i++)
+        {
+            Timer timer;
+            AST_Printer::Print(ast);
+            fflush(stdout);
+            double t = timer.seconds();
+            print_best = (t < print_best) ? t : print_best;
+        }
+
+        dup2(saved, STDOUT_FILENO);
+        close(null);
+        close(saved);
+
+        print_phase(name.c_str(), shape, "print", (double) input.size(), (double) stack->size(), nodes, print_best);
+    }
+
+    if(ast != nullptr)
+    {
+        delete_ast(ast);
+    }
+    delete stack;
+
+    return status;
+}
+
+static bool measure_in_child(unsigned int shape, size_t size)
+{
+    bool status = false;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        bool result = measure(shape, size);
+        fflush(stdout);
+        _exit(result ? 0 : 1);
+    }
+    else if(pid > 0)
+    {
+        int code = 0;
+        waitpid(pid, &code, 0);
+        status = WIFEXITED(code) && (WEXITSTATUS(code) == 0);
+    }
+
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    int result = 0;
+
+    if((argc >= 4) && (strcmp(argv[1], "--emit") == 0))
+    {
+        unsigned int shape = SourceGenerator::FindShape(argv[2]);
+        if(shape == SHAPE_COUNT)
+        {
+            printf("frontend: unknown shape \"%s\"\n", argv[2]);
+            result = 1;
+        }
+        else
+        {
+            std::string out;
+            SourceGenerator generator((argc >= 5) ? strtoull(argv[4], nullptr, 10) : 10 + shape);
+            generator.generate(shape, (size_t) strtoull(argv[3], nullptr, 10), &out);
+            fwrite(out.data(), 1, out.size(), stdout);
+        }
+    }
+    else
+    {
+        size_t max_size = (size_t) ((argc >= 2) ? strtoul(argv[1], nullptr, 10) : 4) << 20;
+
+        printf("%-8s %-12s %-9s %10s %11s %10s %12s\n", "size", "shape", "phase", "MB/s", "Mtokens/s", "Mnodes/s", "peak RSS MB");
+
+        for(size_t size = 1024; (result == 0) && (size <= max_size); size *= 16)
+        {
+            result = measure_in_child(SHAPE_MIXED, size) ? 0 : 1;
+        }
+
+        for(unsigned int shape = SHAPE_MIXED + 1; (result == 0) && (shape < SHAPE_COUNT); shape++)
+        {
+            result = measure_in_child(shape, 1 << 20) ? 0 : 1;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,524 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <bench.hpp>
+
+// Shapes of generated source, each a different mix of top-level items.
+enum SOURCE_SHAPE
+{
+    SHAPE_MIXED       = 0x0, // a bit of everything
+    SHAPE_EXPRESSIONS = 0x1, // functions of long, deeply nested expressions
+    SHAPE_GLOBALS     = 0x2, // variable and struct declarations
+    SHAPE_DECLARATORS = 0x3, // nested function pointer declarators as in test/test.c
+    SHAPE_COMMENTS    = 0x4, // long block and line comments
+    SHAPE_LITERALS    = 0x5, // string, character and number literals
+    SHAPE_CHECKED     = 0x6, // functions that pass semantic analysis
+    SHAPE_COUNT       = 0x7
+};
+
+// Writes valid C64 source of a requested size and shape. The output only
+// depends on the seed, so every run measures the same bytes. Names carry a
+// prefix and a counter so none of them can be a keyword. Only the checked
+// shape is also well typed: the others call functions that do not exist.
+class SourceGenerator
+{
+private:
+    enum ITEM
+    {
+        ITEM_GLOBAL     = 0x0,
+        ITEM_STRUCT     = 0x1,
+        ITEM_DECLARATOR = 0x2,
+        ITEM_FUNCTION   = 0x3,
+        ITEM_COMMENT    = 0x4,
+        ITEM_LITERALS   = 0x5,
+        ITEM_CHECKED    = 0x6,
+        ITEM_COUNT      = 0x7
+    };
+
+    Random m_rng;
+    std::string* m_out;
+    unsigned int m_depth; // deepest expression nesting
+    unsigned int m_names; // counter behind every generated name
+    std::vector<unsigned int> m_checked; // names of the well typed functions so far
+
+private:
+    unsigned int pick(unsigned int count) { return m_rng.range(0, count - 1); }
+
+    void name(const char* prefix)
+    {
+        *m_out += prefix;
+        *m_out += std::to_string(m_names++);
+    }
+
+    void words(unsigned int count)
+    {
+        for(unsigned int i = 0; i < count; i++)
+        {
+            append_identifier(*m_out, m_rng, m_rng.range(2, 10));
+            m_out->push_back(' ');
+        }
+    }
+
+    void number()
+    {
+        switch(pick(6))
+        {
+            case 0:  { *m_out += std::to_string(m_rng.range(0, 100000)); break; }
+            case 1:
+            {
+                static const char HEX[] = "0123456789ABCDEF";
+                *m_out += "0x";
+                for(unsigned int i = m_rng.range(1, 8); i > 0; i--)
+                {
+                    m_out->push_back(HEX[pick(16)]);
+                }
+                break;
+            }
+            case 2:  { *m_out += std::to_string(m_rng.range(0, 1000)) + "." + std::to_string(m_rng.range(0, 9999)); break; }
+            case 3:  { *m_out += std::to_string(m_rng.range(1, 9)) + "." + std::to_string(m_rng.range(0, 99)) + "e" + std::to_string(m_rng.range(1, 30)); break; }
+            case 4:  { *m_out += std::to_string(m_rng.range(0, 255)) + "u8"; break; }
+            default: { *m_out += std::to_string(m_rng.range(0, 1000000)) + "u32"; break; }
+        }
+    }
+
+    void string()
+    {
+        static const char* ESCAPES[] = { "\\n", "\\t", "\\\\", "\\\"", "\\0" };
+
+        m_out->push_back('"');
+        for(unsigned int i = m_rng.range(1, 12); i > 0; i--)
+        {
+            append_identifier(*m_out, m_rng, m_rng.range(1, 8));
+            *m_out += (pick(4) == 0) ? ESCAPES[pick(5)] : " ";
+        }
+        m_out->push_back('"');
+    }
+
+    void literal()
+    {
+        switch(pick(4))
+        {
+            case 0:  { string(); break; }
+            case 1:  { *m_out += "'"; m_out->push_back((char) ('a' + pick(26))); *m_out += "'"; break; }
+            default: { number(); break; }
+        }
+    }
+
+    void operand(unsigned int depth)
+    {
+        static const char* LOCALS[] = { "a", "b", "x", "i" };
+
+        switch((depth >= m_depth) ? pick(3) : pick(10))
+        {
+            case 0:  { *m_out += LOCALS[pick(4)]; break; }
+            case 1:  { number(); break; }
+            case 2:  { *m_out += "p[i]"; break; }
+            case 3:  { *m_out += "*p++"; break; }
+            case 4:  { *m_out += "&a"; break; }
+            case 5:  { *m_out += "(U32) "; operand(depth + 1); break; }
+            case 6:  { *m_out += "!"; operand(depth + 1); break; }
+            case 7:
+            {
+                *m_out += "f_call(";
+                expression(depth + 1);
+                *m_out += ", ";
+                operand(depth + 1);
+                *m_out += ")";
+                break;
+            }
+            default:
+            {
+                *m_out += "(";
+                expression(depth + 1);
+                *m_out += ")";
+                break;
+            }
+        }
+    }
+
+    void expression(unsigned int depth)
+    {
+        static const char* OPS[] =
+        {
+            " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " < ", " <= ", " > ", " >= ",
+            " == ", " != ", " & ", " ^ ", " | ", " and ", " or "
+        };
+
+        operand(depth);
+        for(unsigned int i = m_rng.range(0, 4); i > 0; i--)
+        {
+            *m_out += OPS[pick(sizeof(OPS) / sizeof(OPS[0]))];
+            operand(depth);
+        }
+    }
+
+    void statement(unsigned int indent)
+    {
+        m_out->append(indent, '\t');
+        switch((indent > 2) ? pick(2) : pick(6))
+        {
+            case 0:  { *m_out += "x = "; expression(0); *m_out += ";\n"; break; }
+            case 1:  { *m_out += "U32 "; name("v_"); *m_out += " = "; expression(0); *m_out += ";\n"; break; }
+            case 2:
+            {
+                *m_out += "if(";
+                expression(1);
+                *m_out += ")\n";
+                block(indent);
+                m_out->append(indent, '\t');
+                *m_out += "else\n";
+                block(indent);
+                break;
+            }
+            case 3:
+            {
+                *m_out += "for(U32 i = 0; i < ";
+                expression(1);
+                *m_out += "; i++)\n";
+                block(indent);
+                break;
+            }
+            case 4:
+            {
+                *m_out += "while(";
+                expression(1);
+                *m_out += ")\n";
+                block(indent);
+                break;
+            }
+            default: { *m_out += "f_call(a, "; literal(); *m_out += ");\n"; break; }
+        }
+    }
+
+    void block(unsigned int indent)
+    {
+        m_out->append(indent, '\t');
+        *m_out += "{\n";
+        for(unsigned int i = m_rng.range(1, 4); i > 0; i--)
+        {
+            statement(indent + 1);
+        }
+        m_out->append(indent, '\t');
+        *m_out += "}\n";
+    }
+
+    // the well typed counterparts of operand() and statement(), over the
+    // parameters U32 a, U32 b, U32* p and a local U32 x
+    void typed_operand(unsigned int depth)
+    {
+        static const char* LOCALS[] = { "a", "b", "x", "*p", "p[a]" };
+
+        switch((depth >= m_depth) ? pick(4) : pick(10))
+        {
+            case 0:
+            case 1:  { *m_out += LOCALS[pick(5)]; break; }
+            case 2:
+            case 3:
+            {
+                switch(pick(3))
+                {
+                    case 0:  { *m_out += std::to_string(m_rng.range(0, 100000)); break; }
+                    case 1:  { *m_out += std::to_string(m_rng.range(0, 255)) + "u8"; break; }
+                    default: { *m_out += std::to_string(m_rng.range(0, 1000000)) + "u32"; break; }
+                }
+                break;
+            }
+            case 4:  { *m_out += "(U32) "; typed_operand(depth + 1); break; }
+            case 5:  { *m_out += "!"; typed_operand(depth + 1); break; }
+            case 6:
+            case 7:
+            {
+                if(!m_checked.empty())
+                {
+                    *m_out += "f_" + std::to_string(m_checked[pick((unsigned int) m_checked.size())]) + "(";
+                    typed_expression(depth + 1);
+                    *m_out += ", ";
+                    typed_operand(depth + 1);
+                    *m_out += ", p)";
+                    break;
+                }
+                // no function to call yet
+            }
+            // fall through
+            default:
+            {
+                *m_out += "(";
+                typed_expression(depth + 1);
+                *m_out += ")";
+                break;
+            }
+        }
+    }
+
+    void typed_expression(unsigned int depth)
+    {
+        static const char* OPS[] =
+        {
+            " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " < ", " <= ", " > ", " >= ",
+            " == ", " != ", " & ", " ^ ", " | ", " and ", " or "
+        };
+
+        typed_operand(depth);
+        for(unsigned int i = m_rng.range(0, 2); i > 0; i--)
+        {
+            *m_out += OPS[pick(sizeof(OPS) / sizeof(OPS[0]))];
+            typed_operand(depth);
+        }
+    }
+
+    void typed_statement(unsigned int indent)
+    {
+        m_out->append(indent, '\t');
+        switch((indent > 2) ? pick(3) : pick(7))
+        {
+            case 0:  { *m_out += "x = "; typed_expression(0); *m_out += ";\n"; break; }
+            case 1:  { *m_out += "*p = "; typed_expression(0); *m_out += ";\n"; break; }
+            case 2:  { *m_out += "U32 "; name("v_"); *m_out += " = "; typed_expression(0); *m_out += ";\n"; break; }
+            case 3:
+            {
+                *m_out += "if(";
+                typed_expression(1);
+                *m_out += ")\n";
+                typed_block(indent);
+                m_out->append(indent, '\t');
+                *m_out += "else\n";
+                typed_block(indent);
+                break;
+            }
+            case 4:
+            {
+                *m_out += "for(U32 i = 0; i < ";
+                typed_expression(1);
+                *m_out += "; i++)\n";
+                typed_block(indent);
+                break;
+            }
+            case 5:
+            {
+                *m_out += "while(";
+                typed_expression(1);
+                *m_out += ")\n";
+                typed_block(indent);
+                break;
+            }
+            default: { *m_out += "p = p + "; typed_operand(1); *m_out += ";\n"; break; }
+        }
+    }
+
+    void typed_block(unsigned int indent)
+    {
+        m_out->append(indent, '\t');
+        *m_out += "{\n";
+        for(unsigned int i = m_rng.range(1, 4); i > 0; i--)
+        {
+            typed_statement(indent + 1);
+        }
+        m_out->append(indent, '\t');
+        *m_out += "}\n";
+    }
+
+    // type (*(*...name...)())(U32) with the given number of pointer levels
+    void declarator(unsigned int levels, bool function)
+    {
+        *m_out += "U32";
+        for(unsigned int i = 0; i < levels; i++)
+        {
+            *m_out += "(*";
+        }
+        name(function ? "f_" : "v_");
+        *m_out += function ? "()" : "";
+        for(unsigned int i = 1; i < levels; i++)
+        {
+            *m_out += ")()";
+        }
+        *m_out += ")(U32)";
+    }
+
+    void item(unsigned int type)
+    {
+        switch(type)
+        {
+            case ITEM_GLOBAL:
+            {
+                switch(pick(4))
+                {
+                    case 0:  { *m_out += "U32 "; name("g_"); *m_out += " = "; number(); break; }
+                    case 1:  { *m_out += "U8* "; name("g_"); *m_out += " = "; string(); break; }
+                    case 2:  { *m_out += "U8 "; name("g_"); *m_out += " = 'c'"; break; }
+                    default: { *m_out += "U32* "; name("g_"); break; }
+                }
+                *m_out += ";\n";
+                break;
+            }
+            case ITEM_STRUCT:
+            {
+                *m_out += "struct ";
+                name("s_");
+                *m_out += "\n{\n";
+                for(unsigned int i = m_rng.range(1, 8); i > 0; i--)
+                {
+                    *m_out += (pick(2) == 0) ? "\tU32 " : "\tU8* ";
+                    name("m_");
+                    *m_out += ";\n";
+                }
+                *m_out += "};\n";
+                break;
+            }
+            case ITEM_DECLARATOR:
+            {
+                unsigned int levels = m_rng.range(1, 4);
+                declarator(levels, true);
+                *m_out += "\n{\n\t";
+                declarator(levels + 1, false);
+                *m_out += " = &a;\n\treturn *p;\n}\n";
+                break;
+            }
+            case ITEM_FUNCTION:
+            {
+                *m_out += "U32 ";
+                name("f_");
+                *m_out += "(U32 a, U32 b, U8* p)\n{\n\tU32 x = 0;\n";
+                for(unsigned int i = m_rng.range(2, 10); i > 0; i--)
+                {
+                    statement(1);
+                }
+                *m_out += "\treturn x;\n}\n";
+                break;
+            }
+            case ITEM_COMMENT:
+            {
+                if(pick(2) == 0)
+                {
+                    *m_out += "/*\n";
+                    for(unsigned int i = m_rng.range(1, 16); i > 0; i--)
+                    {
+                        *m_out += " * ";
+                        words(m_rng.range(4, 14));
+                        m_out->push_back('\n');
+                    }
+                    *m_out += " */\n";
+                }
+                else
+                {
+                    for(unsigned int i = m_rng.range(1, 6); i > 0; i--)
+                    {
+                        *m_out += "// ";
+                        words(m_rng.range(4, 14));
+                        m_out->push_back('\n');
+                    }
+                }
+                break;
+            }
+            case ITEM_CHECKED:
+            {
+                unsigned int id = m_names;
+                *m_out += "U32 ";
+                name("f_");
+                *m_out += "(U32 a, U32 b, U32* p)\n{\n\tU32 x = a;\n";
+                for(unsigned int i = m_rng.range(2, 10); i > 0; i--)
+                {
+                    typed_statement(1);
+                }
+                *m_out += "\treturn x;\n}\n";
+
+                // only later functions call it, so there is no recursion
+                m_checked.push_back(id);
+                break;
+            }
+            default:
+            {
+                *m_out += "U32 ";
+                name("f_");
+                *m_out += "(U32 a, U8* p)\n{\n";
+                for(unsigned int i = m_rng.range(2, 10); i > 0; i--)
+                {
+                    *m_out += "\tf_call(";
+                    literal();
+                    for(unsigned int j = m_rng.range(0, 4); j > 0; j--)
+                    {
+                        *m_out += ", ";
+                        literal();
+                    }
+                    *m_out += ");\n";
+                }
+                *m_out += "\treturn a;\n}\n";
+                break;
+            }
+        }
+        m_out->push_back('\n');
+    }
+
+public:
+    SourceGenerator(uint64_t seed, unsigned int depth = 4) : m_rng(seed)
+    {
+        m_out = nullptr;
+        m_depth = depth;
+        m_names = 0;
+    }
+
+    static const char* ShapeName(unsigned int shape)
+    {
+        static const char* NAMES[] = { "mixed", "expressions", "globals", "declarators", "comments", "literals", "checked" };
+        return (shape < SHAPE_COUNT) ? NAMES[shape] : "invalid";
+    }
+
+    // SHAPE_COUNT when there is no shape of that name
+    static unsigned int FindShape(const char* name)
+    {
+        unsigned int shape = 0;
+        while((shape < SHAPE_COUNT) && (strcmp(ShapeName(shape), name) != 0))
+        {
+            shape++;
+        }
+        return shape;
+    }
+
+    // appends whole items to out until it holds at least size bytes
+    void generate(unsigned int shape, size_t size, std::string* out)
+    {
+        // relative weight of each ITEM per shape
+        static const unsigned int WEIGHTS[SHAPE_COUNT][ITEM_COUNT] =
+        {
+            //  global struct declarator function comment literals checked
+            {   4,     1,     1,         6,       2,      2,       0 }, // SHAPE_MIXED
+            {   0,     0,     0,         1,       0,      0,       0 }, // SHAPE_EXPRESSIONS
+            {   8,     2,     0,         0,       0,      0,       0 }, // SHAPE_GLOBALS
+            {   0,     0,     1,         0,       0,      0,       0 }, // SHAPE_DECLARATORS
+            {   1,     0,     0,         0,       4,      0,       0 }, // SHAPE_COMMENTS
+            {   1,     0,     0,         0,       0,      4,       0 }, // SHAPE_LITERALS
+            {   1,     1,     0,         0,       1,      0,       8 }  // SHAPE_CHECKED
+        };
+
+        const unsigned int* weights = WEIGHTS[(shape < SHAPE_COUNT) ? shape : (unsigned int) SHAPE_MIXED];
+
+        unsigned int total = 0;
+        for(unsigned int i = 0; i < ITEM_COUNT; i++)
+        {
+            total += weights[i];
+        }
+
+        m_out = out;
+        out->reserve(out->size() + size + 4096);
+
+        while(out->size() < size)
+        {
+            unsigned int roll = pick(total);
+            unsigned int type = 0;
+            while(roll >= weights[type])
+            {
+                roll -= weights[type++];
+            }
+            item(type);
+        }
+
+        m_out = nullptr;
+    }
+};
+
+#endif // GENERATOR_HPP
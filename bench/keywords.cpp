@@ -0,0 +1,268 @@
+// Keyword recognition: the compile-time perfect hash in Keywords::Find
+// against the nested switch that read_identifier used before it, over an
+// identifier mix modelled on typical source (about a third keywords).
+
+#include <string.h>
+
+#include <vector>
+
+#include <bench.hpp>
+
+#include <keywords.hpp>
+#include <token.hpp>
+
+#define _strncmp(s0, s1, len) (strncmp((s0), (s1), (len)) == 0)
+
+static uint8_t legacy_find(const char* str, unsigned int len, uint8_t* subtype)
+{
+    uint8_t type = TK_INVALID;
+
+    switch(len)
+    {
+        case 2:
+        {
+            switch(str[0])
+            {
+                case 'i': { if(_strncmp(str, "if", 2)) { type = TK_IF; } break; }
+                case 'o': { if(_strncmp(str, "or", 2)) { type = TK_OR; } break; }
+                case 'I':
+                {
+                    switch(str[1])
+                    {
+                        case '8': { type = TK_TYPE; *subtype = TK_TYPE_I8; break; }
+                    }
+                    break;
+                }
+                case 'U':
+                {
+                    switch(str[1])
+                    {
+                        case '8': { type = TK_TYPE; *subtype = TK_TYPE_U8; break; }
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case 3:
+        {
+            switch(str[0])
+            {
+                case 'a': { if(_strncmp(str, "and", 3)) { type = TK_AND; } break; }
+                case 'f': { if(_strncmp(str, "for", 3)) { type = TK_FOR; } break; }
+                case 'F':
+                {
+                    switch(str[1])
+                    {
+                        case '3': { if(_strncmp(str, "F32", 3)) { type = TK_TYPE; *subtype = TK_TYPE_F32; } break; }
+                        case '6': { if(_strncmp(str, "F64", 3)) { type = TK_TYPE; *subtype = TK_TYPE_F64; } break; }
+                    }
+                    break;
+                }
+                case 'I':
+                {
+                    switch(str[1])
+                    {
+                        case '1': { if(_strncmp(str, "I16", 3)) { type = TK_TYPE; *subtype = TK_TYPE_I16; } break; }
+                        case '3': { if(_strncmp(str, "I32", 3)) { type = TK_TYPE; *subtype = TK_TYPE_I32; } break; }
+                        case '6': { if(_strncmp(str, "I64", 3)) { type = TK_TYPE; *subtype = TK_TYPE_I64; } break; }
+                    }
+                    break;
+                }
+                case 'U':
+                {
+                    switch(str[1])
+                    {
+                        case '1': { if(_strncmp(str, "U16", 3)) { type = TK_TYPE; *subtype = TK_TYPE_U16; } break; }
+                        case '3': { if(_strncmp(str, "U32", 3)) { type = TK_TYPE; *subtype = TK_TYPE_U32; } break; }
+                        case '6': { if(_strncmp(str, "U64", 3)) { type = TK_TYPE; *subtype = TK_TYPE_U64; } break; }
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case 4:
+        {
+            switch(str[0])
+            {
+                case 'c':
+                {
+                    switch(str[3])
+                    {
+                        case 'e': { if(_strncmp(str, "case", 4)) { type = TK_CASE; } break; }
+                        case 't': { if(_strncmp(str, "cast", 4)) { type = TK_STATIC_CAST; } break; }
+                    }
+                    break;
+                }
+                case 'e':
+                {
+                    switch(str[1])
+                    {
+                        case 'l': { if(_strncmp(str, "else", 4)) { type = TK_ELSE; } break; }
+                        case 'n': { if(_strncmp(str, "enum", 4)) { type = TK_ENUM; } break; }
+                    }
+                    break;
+                }
+                case 'v': { if(_strncmp(str, "void", 4)) { type = TK_TYPE; *subtype = TK_TYPE_VOID; } break; }
+            }
+            break;
+        }
+        case 5:
+        {
+            switch(str[0])
+            {
+                case 'c': { if(_strncmp(str, "const", 5)) { type = TK_CONST; } break; }
+                case 'w': { if(_strncmp(str, "while", 5)) { type = TK_WHILE; } break; }
+                case 'u': { if(_strncmp(str, "union", 5)) { type = TK_UNION; } break; }
+            }
+            break;
+        }
+        case 6:
+        {
+            switch(str[0])
+            {
+                case 'e': { if(_strncmp(str, "extern", 6)) { type = TK_EXTERN; } break; }
+                case 'r':
+                {
+                    switch(str[1])
+                    {
+                        case 'e': { if(_strncmp(str, "return", 6)) { type = TK_RETURN; } break; }
+                        case '_': { if(_strncmp(str, "r_cast", 6)) { type = TK_REINTERPRET_CAST; } break; }
+                    }
+                    break;
+                }
+                case 's':
+                {
+                    switch(str[1])
+                    {
+                        case 't': { if(_strncmp(str, "struct", 6)) { type = TK_STRUCT; } break; }
+                        case 'w': { if(_strncmp(str, "switch", 6)) { type = TK_SWITCH; } break; }
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case 7:
+        {
+            switch(str[0])
+            {
+                case 'd': { if(_strncmp(str, "default", 7)) { type = TK_DEFAULT; } break; }
+            }
+            break;
+        }
+        case 8:
+        {
+            switch(str[0])
+            {
+                case 'c': { if(_strncmp(str, "continue", 8)) { type = TK_CONTINUE; } break; }
+            }
+            break;
+        }
+    }
+
+    return type;
+}
+
+struct Word
+{
+    const char*  ptr;
+    unsigned int len;
+};
+
+static std::vector<Word> make_mix(unsigned int count)
+{
+    static const char* KEYWORDS[] =
+    {
+        "U32", "U32", "U32", "U8", "I32", "void", "void", "const", "return", "return",
+        "if", "if", "else", "for", "while", "struct", "case", "switch", "break", "F64"
+    };
+
+    static const char* NAMES[] =
+    {
+        "i", "j", "x", "y", "n", "ptr", "len", "size", "count", "index", "value", "result",
+        "buffer", "status", "next", "prev", "head", "tail", "data", "node", "token", "stack",
+        "expr", "stmt", "type", "flags", "offset", "length", "capacity", "position",
+        "parse_expression", "read_identifier", "m_status", "m_stack", "get_pfn", "val_ptr",
+        "ifc", "forward", "casts", "void_ptr", "U32_MAX", "Int32", "constant", "returned",
+        "structure", "unionize", "elsewhere", "enumerate", "cast_to", "default_value"
+    };
+
+    Random rng(7);
+    std::vector<Word> words;
+    words.reserve(count);
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const char* str = nullptr;
+        if(rng.range(0, 99) < 35)
+        {
+            str = KEYWORDS[rng.next() % (sizeof(KEYWORDS) / sizeof(KEYWORDS[0]))];
+        }
+        else
+        {
+            str = NAMES[rng.next() % (sizeof(NAMES) / sizeof(NAMES[0]))];
+        }
+
+        Word w = { str, (unsigned int) strlen(str) };
+        words.push_back(w);
+    }
+
+    return words;
+}
+
+int main()
+{
+    const unsigned int COUNT  = 1 << 20;
+    const unsigned int REPEAT = 20;
+
+    std::vector<Word> words = make_mix(COUNT);
+
+    // both recognizers must agree before their speed is worth comparing
+    for(unsigned int i = 0; i < COUNT; i++)
+    {
+        uint8_t subtype = 0;
+        uint8_t type = legacy_find(words[i].ptr, words[i].len, &subtype);
+
+        const Keyword* kw = Keywords::Find(words[i].ptr, words[i].len);
+        uint8_t expected = (kw != nullptr) ? kw->token : (uint8_t) TK_INVALID;
+
+        // the switch never knew about break/goto/static/namespace/typedef
+        if((type != expected) && (type != TK_INVALID))
+        {
+            printf("mismatch for \"%.*s\"\n", words[i].len, words[i].ptr);
+            return -1;
+        }
+    }
+
+    unsigned int hits = 0;
+
+    Timer timer;
+    for(unsigned int r = 0; r < REPEAT; r++)
+    {
+        for(unsigned int i = 0; i < COUNT; i++)
+        {
+            uint8_t subtype = 0;
+            hits += legacy_find(words[i].ptr, words[i].len, &subtype) != TK_INVALID;
+        }
+    }
+    double legacy = timer.seconds();
+
+    timer.reset();
+    for(unsigned int r = 0; r < REPEAT; r++)
+    {
+        for(unsigned int i = 0; i < COUNT; i++)
+        {
+            hits += Keywords::Find(words[i].ptr, words[i].len) != nullptr;
+        }
+    }
+    double hashed = timer.seconds();
+
+    double lookups = (double) COUNT * REPEAT;
+    printf("%-24s %10.2f Mlookups/s\n", "switch", lookups / legacy / 1e6);
+    printf("%-24s %10.2f Mlookups/s\n", "perfect-hash", lookups / hashed / 1e6);
+    printf("(%u keyword hits)\n", hits);
+
+    return 0;
+}
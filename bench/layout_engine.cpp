@@ -0,0 +1,161 @@
+// Struct layout: a generated source of structs with fields of mixed widths,
+// some of them nested, is laid out in declaration order and again with the
+// fields reordered, reporting the time and the padding each leaves. Then the
+// struct that reordering shrinks the most is laid out in memory both ways,
+// as an array too large for the caches, and one field of every element is read,
+// as a loop over a hot array would: the scan is bound by the cache lines it
+// pulls in, so it should be faster by about the bytes the reordering saves.
+
+#include <vector>
+
+#include <bench.hpp>
+
+#include <layout_engine.hpp>
+
+// struct s_k { U8 m_0; U32* m_1; struct { I32 m_2; U8 m_3; } m_4; ... };
+static std::string make_structs(unsigned int count, Random& rng)
+{
+    static const char* const TYPES[] = { "U8", "U8", "U32", "I32", "U8*", "U32*" };
+
+    std::string out;
+    for(unsigned int k = 0; k < count; k++)
+    {
+        out += "struct s_" + std::to_string(k) + "\n{\n";
+        unsigned int fields = rng.range(2, 16);
+        for(unsigned int f = 0; f < fields; f++)
+        {
+            std::string name = " m_" + std::to_string(f) + ";\n";
+            if(rng.range(0, 7) == 0)
+            {
+                out += "    struct { " + std::string(TYPES[rng.range(0, 5)]) + " n_0; " + TYPES[rng.range(0, 5)] + " n_1; }" + name;
+            }
+            else
+            {
+                out += "    " + std::string(TYPES[rng.range(0, 5)]) + name;
+            }
+        }
+        out += "};\n";
+    }
+    return out;
+}
+
+// sums the field declared first over every element
+static uint64_t scan(const std::vector<uint8_t>& memory, const Layout* layout)
+{
+    const Layout::Field* field = layout->fields;
+    for(unsigned int i = 0; i < layout->count; i++)
+    {
+        field = (layout->fields[i].index == 0) ? &layout->fields[i] : field;
+    }
+
+    uint64_t sum = 0;
+    for(size_t at = field->offset; at + field->size <= memory.size(); at += layout->size)
+    {
+        const uint8_t* p = &memory[at];
+        switch(field->size)
+        {
+            case 1:  { sum += *p; break; }
+            case 4:  { sum += *reinterpret_cast<const uint32_t*>(p); break; }
+            default: { sum += *reinterpret_cast<const uint64_t*>(p); break; }
+        }
+    }
+    return sum;
+}
+
+int main()
+{
+    const unsigned int STRUCTS = 20000;
+    const size_t ELEMENTS = 4 << 20;
+    const unsigned int REPEAT = 3;
+
+    Random rng(25);
+    std::string input = make_structs(STRUCTS, rng);
+
+    printf("%-10s %10s %10s %12s %12s\n", "order", "structs", "ms", "padding", "saved");
+
+    int result = 0;
+    const Layout* layouts[2] = { nullptr, nullptr };
+    AST* asts[2] = { nullptr, nullptr };
+    TokenStack stacks[2];
+    for(unsigned int reorder = 0; (result == 0) && (reorder < 2); reorder++)
+    {
+        AST* ast = parse(input, &stacks[reorder]);
+        if(ast == nullptr)
+        {
+            printf("layout_engine: failed to parse the generated structs\n");
+            result = 1;
+            break;
+        }
+        asts[reorder] = ast;
+
+        LayoutEngine::Report report = {};
+        Timer timer;
+        bool status = LayoutEngine::Compute(ast, reorder != 0, &report);
+        double seconds = timer.seconds();
+        if(!status)
+        {
+            printf("layout_engine: the generated structs cannot be laid out\n");
+            result = 1;
+            break;
+        }
+
+        printf("%-10s %10zu %10.2f %12llu %12llu\n", reorder ? "reordered" : "declared", report.composites.size(), seconds * 1e3,
+               (unsigned long long) report.padding, (unsigned long long) report.savings);
+
+        // the top-level struct the reordering shrinks the most, the same one in both trees
+        uint64_t best = 0;
+        for(const Statement* stmt : ast->statements)
+        {
+            const Layout* layout = stmt->data.declarations[0]->data.composite.data->layout;
+            uint64_t saved = layout->declared_size - layout->optimal_size;
+            if((layouts[reorder] == nullptr) || (saved * layouts[reorder]->declared_size > best * layout->declared_size))
+            {
+                layouts[reorder] = layout;
+                best = saved;
+            }
+        }
+    }
+
+    if(result == 0)
+    {
+        printf("\n%-10s %10s %10s %12s\n", "order", "bytes", "ms", "M elem/s");
+
+        uint64_t sums[2] = { 0, 0 };
+        for(unsigned int reorder = 0; reorder < 2; reorder++)
+        {
+            const Layout* layout = layouts[reorder];
+            std::vector<uint8_t> memory(ELEMENTS * layout->size);
+            for(size_t i = 0; i < memory.size(); i++)
+            {
+                memory[i] = (uint8_t) (i * 131);
+            }
+
+            double best = 1e30;
+            for(unsigned int i = 0; i < REPEAT; i++)
+            {
+                Timer timer;
+                sums[reorder] += scan(memory, layout);
+                double seconds = timer.seconds();
+                best = (seconds < best) ? seconds : best;
+            }
+
+            printf("%-10s %10llu %10.2f %12.1f\n", reorder ? "reordered" : "declared", (unsigned long long) layout->size, best * 1e3,
+                   (double) ELEMENTS / 1e6 / best);
+        }
+
+        // keeps the scans from being optimized away
+        if(sums[0] == 1)
+        {
+            printf("\n");
+        }
+    }
+
+    for(AST* ast : asts)
+    {
+        if(ast != nullptr)
+        {
+            delete_ast(ast);
+        }
+    }
+    return result;
+}
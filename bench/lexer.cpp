@@ -0,0 +1,122 @@
+// Tokenizer throughput on comment-, whitespace- and identifier-heavy inputs,
+// once per available Scan level so the SIMD kernels can be compared against
+// the scalar fallback.
+
+#include <bench.hpp>
+
+#include <scan.hpp>
+#include <tokenizer.hpp>
+
+static std::string make_comment_heavy(unsigned int size)
+{
+    Random rng(1);
+    std::string out;
+
+    while(out.size() < size)
+    {
+        out += "/*";
+        unsigned int lines = rng.range(1, 8);
+        for(unsigned int i = 0; i < lines; i++)
+        {
+            out += " * ";
+            unsigned int words = rng.range(4, 12);
+            for(unsigned int w = 0; w < words; w++)
+            {
+                append_identifier(out, rng, rng.range(2, 10));
+                out.push_back(' ');
+            }
+            out.push_back('\n');
+        }
+        out += " */\n";
+
+        out += "// ";
+        append_identifier(out, rng, rng.range(20, 80));
+        out += "\nU32 x = 1;\n";
+    }
+
+    return out;
+}
+
+static std::string make_identifier_heavy(unsigned int size)
+{
+    Random rng(2);
+    std::string out;
+
+    // long names drawn from a fixed vocabulary, as in generated code
+    std::string vocabulary[4096];
+    for(unsigned int i = 0; i < 4096; i++)
+    {
+        append_identifier(vocabulary[i], rng, rng.range(8, 32));
+    }
+
+    while(out.size() < size)
+    {
+        out += vocabulary[rng.next() % 4096];
+        out += " = ";
+        out += vocabulary[rng.next() % 4096];
+        out += " + ";
+        out += vocabulary[rng.next() % 4096];
+        out += ";\n";
+    }
+
+    return out;
+}
+
+static std::string make_whitespace_heavy(unsigned int size)
+{
+    Random rng(3);
+    std::string out;
+
+    while(out.size() < size)
+    {
+        out.append(rng.range(16, 96), ' ');
+        out += "U32";
+        out.append(rng.range(1, 8), '\t');
+        out += "x;\n";
+        out.append(rng.range(0, 4), '\n');
+    }
+
+    return out;
+}
+
+static void run(const char* name, const std::string& input)
+{
+    const unsigned int REPEAT = 3;
+
+    for(unsigned int level = Scan::LEVEL_SCALAR; level <= Scan::LEVEL_AVX2; level++)
+    {
+        if(!Scan::Select((Scan::LEVEL) level))
+        {
+            continue;
+        }
+
+        double best = 1e30;
+        for(unsigned int i = 0; i < REPEAT; i++)
+        {
+            TokenStack stack;
+            Timer timer;
+            if(!Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &stack))
+            {
+                printf("%s: tokenizer failure\n", name);
+                return;
+            }
+            double t = timer.seconds();
+            best = (t < best) ? t : best;
+        }
+
+        report(name, Scan::LevelName((Scan::LEVEL) level), (double) input.size(), best);
+    }
+
+    Scan::Select(Scan::Detect());
+}
+
+int main()
+{
+    const unsigned int SIZE = 16 * 1024 * 1024;
+
+    run("comment-heavy", make_comment_heavy(SIZE));
+    run("identifier-heavy", make_identifier_heavy(SIZE));
+    run("whitespace-heavy", make_whitespace_heavy(SIZE));
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Source locations: tokens only record a byte offset while lexing, and the
+// line table is built on the first diagnostic. This measures the tokenizer
+// with offsets next to the one-off cost of building the line table at each
+// Scan level and the cost of turning an offset into a line and column.
+
+#include <vector>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <line_table.hpp>
+#include <scan.hpp>
+#include <tokenizer.hpp>
+
+int main()
+{
+    const unsigned int SIZE = 16 * 1024 * 1024;
+    const unsigned int REPEAT = 3;
+    const unsigned int LOOKUPS = 4 * 1024 * 1024;
+
+    std::string input;
+    SourceGenerator generator(4);
+    generator.generate(SHAPE_MIXED, SIZE, &input);
+
+    double best = 1e30;
+    std::vector<uint32_t> offsets;
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        TokenStack stack;
+        Timer timer;
+        if(!Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &stack))
+        {
+            printf("tokenizer failure\n");
+            return 1;
+        }
+        double t = timer.seconds();
+        best = (t < best) ? t : best;
+
+        if(offsets.empty())
+        {
+            for(unsigned int j = 0; j < stack.size(); j++)
+            {
+                offsets.push_back(stack.get_offset(j));
+            }
+        }
+    }
+    report("tokenize", Scan::LevelName(Scan::Level()), (double) input.size(), best);
+
+    for(unsigned int level = Scan::LEVEL_SCALAR; level <= Scan::LEVEL_AVX2; level++)
+    {
+        if(!Scan::Select((Scan::LEVEL) level))
+        {
+            continue;
+        }
+
+        best = 1e30;
+        for(unsigned int i = 0; i < REPEAT; i++)
+        {
+            LineTable lines;
+            Timer timer;
+            lines.build(input.data(), input.size());
+            double t = timer.seconds();
+            best = (t < best) ? t : best;
+        }
+
+        report("line table build", Scan::LevelName((Scan::LEVEL) level), (double) input.size(), best);
+    }
+    Scan::Select(Scan::Detect());
+
+    LineTable lines;
+    lines.build(input.data(), input.size());
+
+    Random rng(5);
+    uint64_t checksum = 0;
+
+    Timer timer;
+    for(unsigned int i = 0; i < LOOKUPS; i++)
+    {
+        SourceLocation location = lines.locate(offsets[rng.next() % offsets.size()]);
+        checksum += location.line + location.column;
+    }
+    double t = timer.seconds();
+
+    printf("%-24s %-8s %10.2f ns/lookup (checksum %llu)\n", "locate", "", (t * 1e9) / LOOKUPS, (unsigned long long) checksum);
+
+    return 0;
+}
@@ -0,0 +1,298 @@
+// Building blocks of the front end, timed one primitive at a time with sizes
+// drawn from realistic distributions: list building, the token cursor and its
+// speculation marks, interning, name comparison, arena allocation, string
+// pooling and reading source files.
+//
+//     micro.exe [--json path]
+
+#include <stdlib.h>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <ast.hpp>
+#include <file.hpp>
+#include <interner.hpp>
+#include <list.hpp>
+#include <string_pool.hpp>
+#include <tokenizer.hpp>
+
+// results are folded in here so the loops are not optimized away
+static volatile uint64_t s_sink = 0;
+
+// list lengths as the parser meets them: mostly empty to a few elements,
+// with the occasional long argument list or block
+static unsigned int list_length(Random& rng)
+{
+    unsigned int roll = rng.range(0, 99);
+    return (roll < 70) ? rng.range(0, 2) : ((roll < 95) ? rng.range(3, 8) : rng.range(9, 64));
+}
+
+// names as an identifier stream uses them: a few very common, most rare
+static std::vector<strptr> make_names(std::string& text, unsigned int vocabulary, unsigned int count)
+{
+    Random rng(12);
+
+    std::vector<size_t> offsets;
+    std::vector<unsigned int> lengths;
+    for(unsigned int i = 0; i < vocabulary; i++)
+    {
+        offsets.push_back(text.size());
+        lengths.push_back(rng.range(3, 16));
+        append_identifier(text, rng, lengths.back());
+    }
+
+    std::vector<strptr> names;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        unsigned int bits = rng.range(0, 16);
+        unsigned int index = rng.range(0, (1u << bits) - 1) % vocabulary;
+
+        strptr name = { &text[offsets[index]], lengths[index] };
+        names.push_back(name);
+    }
+
+    return names;
+}
+
+static bool write_file(const std::string& path, const std::string& data)
+{
+    bool status = false;
+
+    FILE* file = fopen(path.c_str(), "w");
+    if(file != nullptr)
+    {
+        status = fwrite(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+    }
+
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* json = ((argc >= 3) && (strcmp(argv[1], "--json") == 0)) ? argv[2] : nullptr;
+
+    MicroBench bench;
+    MicroBench::PrintHeader();
+
+    // ListBuilder insert and seal, as the parser builds statement and argument lists
+    {
+        Random rng(11);
+        std::vector<unsigned int> lengths;
+        for(unsigned int i = 0; i < 16384; i++)
+        {
+            lengths.push_back(list_length(rng));
+        }
+
+        Expression dummy = {};
+        bench.run("list_insert_seal", [&]() {
+            AstArena arena;
+            std::vector<void*> stack;
+            size_t inserted = 0;
+            for(unsigned int length : lengths)
+            {
+                ListBuilder<Expression> builder(&stack);
+                for(unsigned int i = 0; i < length; i++)
+                {
+                    builder.insert(&dummy);
+                }
+
+                List<Expression> list;
+                builder.seal(&list, &arena);
+                s_sink += list.size();
+                inserted += length;
+            }
+            return inserted;
+        });
+    }
+
+    // the token cursor over a lexed source, and the mark/rewind pairs of speculation
+    {
+        std::string input;
+        SourceGenerator generator(13);
+        generator.generate(SHAPE_MIXED, 1 << 20, &input);
+
+        TokenStack stack;
+        if(!Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), (unsigned int) input.size()), &stack))
+        {
+            printf("micro: tokenizer failure\n");
+            return 1;
+        }
+
+        bench.run("cursor_peek_advance", [&]() {
+            stack.rewind(0);
+            size_t count = 0;
+            while(stack.peek_type() != TK_EOF)
+            {
+                s_sink += stack.peek_type(1);
+                stack.advance();
+                count++;
+            }
+            return count;
+        });
+
+        Random rng(14);
+        std::vector<uint8_t> depths;
+        for(unsigned int i = 0; i < 4096; i++)
+        {
+            // most speculation is decided within a token or two
+            depths.push_back((uint8_t) ((rng.range(0, 9) < 8) ? rng.range(1, 2) : rng.range(3, 12)));
+        }
+
+        bench.run("cursor_mark_rewind", [&]() {
+            stack.rewind(0);
+            size_t count = 0;
+            for(unsigned int i = 0; (stack.peek_type(16) != TK_EOF); i++)
+            {
+                uint32_t mark = stack.mark();
+                for(unsigned int j = depths[i & 4095]; j > 0; j--)
+                {
+                    stack.advance();
+                }
+                stack.rewind(mark);
+                stack.release();
+                stack.advance();
+                count++;
+            }
+            return count;
+        });
+    }
+
+    // interning, which the lexer does for every identifier
+    {
+        std::string text;
+        std::vector<strptr> names = make_names(text, 16384, 1 << 18);
+
+        Interner warm;
+        for(const strptr& name : names)
+        {
+            warm.intern(name.ptr, name.len);
+        }
+
+        bench.run("interner_intern_hit", [&]() {
+            for(const strptr& name : names)
+            {
+                s_sink += warm.intern(name.ptr, name.len);
+            }
+            return names.size();
+        });
+
+        bench.run("interner_find", [&]() {
+            for(const strptr& name : names)
+            {
+                s_sink += warm.find(name.ptr, name.len);
+            }
+            return names.size();
+        });
+
+        bench.run("interner_intern_new", [&]() {
+            // a fresh table each time, so most names are insertions
+            Interner fresh;
+            for(const strptr& name : names)
+            {
+                s_sink += fresh.intern(name.ptr, name.len);
+            }
+            return names.size();
+        });
+
+        bench.run("strptr_less", [&]() {
+            size_t count = names.size() - 1;
+            for(size_t i = 0; i < count; i++)
+            {
+                s_sink += names[i] < names[i + 1];
+            }
+            return count;
+        });
+
+        bench.run("string_pool_add", [&]() {
+            StringPool pool;
+            for(const strptr& name : names)
+            {
+                s_sink += pool.add(name.ptr, name.len);
+            }
+            return names.size();
+        });
+    }
+
+    // node-sized allocations from the AST arena
+    {
+        Random rng(15);
+        std::vector<uint8_t> sizes;
+        for(unsigned int i = 0; i < 1 << 16; i++)
+        {
+            sizes.push_back((uint8_t) (8 * rng.range(2, 8)));
+        }
+
+        bench.run("arena_allocate", [&]() {
+            AstArena arena;
+            for(uint8_t size : sizes)
+            {
+                s_sink += (uintptr_t) arena.allocate(size, 8) & 0xFF;
+            }
+            return sizes.size();
+        });
+    }
+
+    // reading whole source files of typical sizes, through File and SourceBuffer
+    {
+        char dir[] = "/tmp/c64_micro_XXXXXX";
+        if(mkdtemp(dir) == nullptr)
+        {
+            printf("micro: could not create a temporary directory\n");
+            return 1;
+        }
+
+        Random rng(16);
+        std::vector<std::string> paths;
+        for(unsigned int i = 0; i < 64; i++)
+        {
+            std::string source;
+            SourceGenerator generator(100 + i);
+            generator.generate(SHAPE_MIXED, 1024u << rng.range(0, 8), &source);
+
+            paths.push_back(std::string(dir) + "/file" + std::to_string(i) + ".c");
+            if(!write_file(paths.back(), source))
+            {
+                printf("micro: could not write %s\n", paths.back().c_str());
+                return 1;
+            }
+        }
+
+        bench.run("file_read", [&]() {
+            for(const std::string& path : paths)
+            {
+                unsigned int size = 0;
+                char* data = File::Read(path.c_str(), size);
+                s_sink += size;
+                delete[] data;
+            }
+            return paths.size();
+        });
+
+        bench.run("source_buffer_load", [&]() {
+            for(const std::string& path : paths)
+            {
+                SourceBuffer* buffer = SourceBuffer::Load(path.c_str());
+                s_sink += buffer->data()[buffer->size() / 2];
+                delete buffer;
+            }
+            return paths.size();
+        });
+
+        for(const std::string& path : paths)
+        {
+            remove(path.c_str());
+        }
+        remove(dir);
+    }
+
+    int result = 0;
+    if((json != nullptr) && !bench.write_json(json))
+    {
+        printf("micro: could not write %s\n", json);
+        result = 1;
+    }
+
+    return result;
+}
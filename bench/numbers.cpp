@@ -0,0 +1,140 @@
+// Numeric literal scanning: Number::Read against the buffer-and-strtoul/strtof
+// code that read_decimal used before it, over the same decimal literals, then
+// the whole tokenizer on a numeric-heavy source.
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include <bench.hpp>
+
+#include <ascii.hpp>
+#include <number.hpp>
+#include <tokenizer.hpp>
+
+static const char* legacy_read(const char* ptr, const char* end, std::vector<char>& buffer, Literal* literal)
+{
+    bool is_float = false;
+
+    while((ptr < end) && (IS_NUM(*ptr) || (*ptr == '.')))
+    {
+        is_float |= (*ptr == '.');
+        buffer.push_back(*ptr++);
+    }
+    buffer.push_back(0);
+
+    if(!is_float)
+    {
+        literal->type = LITERAL_INTEGER;
+        literal->data.integer_value = strtoul(buffer.data(), nullptr, 10);
+    }
+    else
+    {
+        literal->type = LITERAL_FLOAT;
+        literal->data.float_value = strtof(buffer.data(), nullptr);
+    }
+
+    buffer.clear();
+    return ptr;
+}
+
+static std::string make_numbers(unsigned int size, std::vector<unsigned int>& starts)
+{
+    Random rng(6);
+    std::string out;
+
+    while(out.size() < size)
+    {
+        starts.push_back((unsigned int) out.size());
+        switch(rng.next() % 4)
+        {
+            case 0: { out += std::to_string(rng.range(0, 255)); break; }
+            case 1: { out += std::to_string(rng.next() % 100000000000ull); break; }
+            case 2:
+            {
+                out += std::to_string(rng.range(0, 99999));
+                out += ".";
+                out += std::to_string(rng.range(0, 999999));
+                break;
+            }
+            default:
+            {
+                out += "0.";
+                out += std::to_string(rng.next() % 10000000000000000ull);
+                break;
+            }
+        }
+        out += ", ";
+    }
+
+    return out;
+}
+
+int main()
+{
+    const unsigned int SIZE = 16 * 1024 * 1024;
+    const unsigned int REPEAT = 3;
+
+    std::vector<unsigned int> starts;
+    std::string input = make_numbers(SIZE, starts);
+
+    const char* base = input.data();
+    const char* end = base + input.size();
+
+    double legacy_best = 1e30, number_best = 1e30;
+    double checksum = 0.0;
+
+    for(unsigned int r = 0; r < REPEAT; r++)
+    {
+        std::vector<char> buffer;
+        buffer.reserve(256);
+
+        Timer timer;
+        for(unsigned int i = 0; i < starts.size(); i++)
+        {
+            Literal literal = {};
+            legacy_read(base + starts[i], end, buffer, &literal);
+            checksum += (double) literal.data.integer_value;
+        }
+        double t = timer.seconds();
+        legacy_best = (t < legacy_best) ? t : legacy_best;
+
+        timer.reset();
+        for(unsigned int i = 0; i < starts.size(); i++)
+        {
+            Literal literal = {};
+            const char* error = nullptr;
+            Number::Read(base + starts[i], end, &literal, &error);
+            checksum += (double) literal.data.integer_value;
+        }
+        t = timer.seconds();
+        number_best = (t < number_best) ? t : number_best;
+    }
+
+    report("literals", "strto*", (double) input.size(), legacy_best);
+    report("literals", "number", (double) input.size(), number_best);
+
+    std::string source;
+    source.reserve(input.size() + 64);
+    source += "U64 table = { ";
+    source += input;
+    source += "0 };\n";
+
+    double best = 1e30;
+    for(unsigned int r = 0; r < REPEAT; r++)
+    {
+        TokenStack stack;
+        Timer timer;
+        if(!Tokenizer::Tokenize(SourceBuffer::Wrap(source.data(), source.size()), &stack))
+        {
+            printf("tokenizer failure\n");
+            return 1;
+        }
+        double t = timer.seconds();
+        best = (t < best) ? t : best;
+    }
+    report("numeric-heavy", "tokenize", (double) source.size(), best);
+
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
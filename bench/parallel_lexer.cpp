@@ -0,0 +1,130 @@
+// Tokenizer::TokenizeParallel against the single-threaded Tokenize on a mixed
+// input with long comments and strings, so that many chunk boundaries fall
+// inside them and have to be relexed. Each run is checked against the
+// single-threaded result before it is timed.
+
+#include <bench.hpp>
+
+#include <thread_pool.hpp>
+#include <tokenizer.hpp>
+
+static std::string make_mixed(unsigned int size)
+{
+    Random rng(4);
+    std::string out;
+
+    while(out.size() < size)
+    {
+        switch(rng.range(0, 4))
+        {
+            case 0:
+            {
+                out += "/*\n";
+                unsigned int lines = rng.range(1, 6);
+                for(unsigned int i = 0; i < lines; i++)
+                {
+                    out += " * ";
+                    append_identifier(out, rng, rng.range(10, 60));
+                    out += "\n";
+                }
+                out += " */\n";
+                break;
+            }
+            case 1:
+            {
+                out += "x = \"";
+                append_identifier(out, rng, rng.range(4, 40));
+                out += "\\n\";\n";
+                break;
+            }
+            case 2:
+            {
+                out += "U32 ";
+                append_identifier(out, rng, rng.range(4, 16));
+                out += " = " + std::to_string(rng.next() % 100000) + ";\n";
+                break;
+            }
+            default:
+            {
+                append_identifier(out, rng, rng.range(4, 16));
+                out += "(a, b + 1.5, 'c');\n";
+                break;
+            }
+        }
+    }
+
+    return out;
+}
+
+static bool same(const TokenStack& a, const TokenStack& b)
+{
+    bool status = (a.size() == b.size()) && (a.symbols().size() == b.symbols().size());
+
+    for(unsigned int i = 0; status && (i < a.size()); i++)
+    {
+        Token x = a.get(i);
+        Token y = b.get(i);
+        status = (x.type == y.type) && (a.get_offset(i) == b.get_offset(i));
+
+        if(status && (x.type == TK_IDENTIFIER))
+        {
+            status = (x.data.identifier == y.data.identifier);
+        }
+        else if(status && (x.type == TK_LITERAL) && (x.data.literal.type == LITERAL_STRING))
+        {
+            status = (x.data.literal.data.string.id == y.data.literal.data.string.id);
+        }
+    }
+
+    return status;
+}
+
+int main()
+{
+    const unsigned int SIZE = 32 * 1024 * 1024;
+    const unsigned int REPEAT = 3;
+
+    std::string input = make_mixed(SIZE);
+
+    TokenStack reference;
+    double best = 1e30;
+    for(unsigned int i = 0; i < REPEAT; i++)
+    {
+        TokenStack stack;
+        Timer timer;
+        Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &stack);
+        double t = timer.seconds();
+        best = (t < best) ? t : best;
+    }
+    Tokenizer::Tokenize(SourceBuffer::Wrap(input.data(), input.size()), &reference);
+    report("mixed", "sequential", (double) input.size(), best);
+
+    const unsigned int THREADS[] = { 1, 2, 4, 8 };
+    for(unsigned int threads : THREADS)
+    {
+        ThreadPool pool(threads);
+
+        best = 1e30;
+        for(unsigned int i = 0; i < REPEAT; i++)
+        {
+            TokenStack stack;
+            Timer timer;
+            Tokenizer::TokenizeParallel(SourceBuffer::Wrap(input.data(), input.size()), &stack, &pool);
+            double t = timer.seconds();
+            best = (t < best) ? t : best;
+
+            if(!same(reference, stack))
+            {
+                printf("mixed: parallel result differs with %u threads\n", threads);
+                return 1;
+            }
+        }
+
+        std::string name = std::to_string(threads) + " threads";
+        report("mixed", name.c_str(), (double) input.size(), best);
+    }
+
+    printf("hardware threads: %u\n", ThreadPool::HardwareThreads());
+
+    return 0;
+}
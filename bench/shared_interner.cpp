@@ -0,0 +1,123 @@
+// Interning under contention: 1 to 32 threads each intern the same stream of
+// names drawn from a shared vocabulary, through one SharedInterner and, for
+// comparison, through a private Interner per thread as every token stack had
+// before. The first pass over a vocabulary is all insertions, the later ones
+// are the lock-free hits that dominate real lexing.
+
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include <bench.hpp>
+
+#include <interner.hpp>
+#include <shared_interner.hpp>
+
+struct Name
+{
+    uint32_t offset;
+    uint32_t len;
+};
+
+static const unsigned int VOCABULARY = 64 * 1024;
+static const unsigned int STREAM = 1024 * 1024;
+
+// runs fn(thread) on count threads started together and returns the wall time
+template<typename F>
+static double run_threads(unsigned int count, F fn)
+{
+    std::vector<std::thread> threads;
+
+    Timer timer;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        threads.emplace_back([&fn, i] { fn(i); });
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return timer.seconds();
+}
+
+int main()
+{
+    Random rng(9);
+
+    std::string text;
+    std::vector<Name> vocabulary;
+    for(unsigned int i = 0; i < VOCABULARY; i++)
+    {
+        Name name = { (uint32_t) text.size(), rng.range(3, 16) };
+        append_identifier(text, rng, name.len);
+        vocabulary.push_back(name);
+    }
+
+    // roughly Zipfian: a few names are very common, most are rare
+    std::vector<uint32_t> stream;
+    std::vector<bool> used(VOCABULARY, false);
+    for(unsigned int i = 0; i < STREAM; i++)
+    {
+        unsigned int bits = rng.range(0, 16);
+        stream.push_back(rng.range(0, (1u << bits) - 1) % VOCABULARY);
+        used[stream.back()] = true;
+    }
+
+    printf("%u names, %u lookups per thread\n", VOCABULARY, STREAM);
+    printf("%-8s %14s %14s %14s\n", "threads", "shared Mops/s", "private Mops/s", "shared/thread");
+
+    static const unsigned int THREADS[] = { 1, 2, 4, 8, 16, 32 };
+    for(unsigned int t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++)
+    {
+        unsigned int count = THREADS[t];
+
+        SharedInterner shared;
+        std::vector<uint32_t> checksums(count, 0); // keeps the loops from being optimized away
+        double shared_seconds = run_threads(count, [&](unsigned int thread) {
+            uint32_t sum = 0;
+            for(unsigned int i = 0; i < STREAM; i++)
+            {
+                // each thread walks the stream from its own starting point
+                const Name& name = vocabulary[stream[(i + thread * (STREAM / count)) % STREAM]];
+                sum += shared.intern(&text[name.offset], name.len);
+            }
+            checksums[thread] = sum;
+        });
+
+        // every name that was interned must still be found with its spelling
+        for(unsigned int i = 0; i < VOCABULARY; i++)
+        {
+            if(!used[i])
+            {
+                continue;
+            }
+
+            const Name& name = vocabulary[i];
+            uint32_t id = shared.find(&text[name.offset], name.len);
+            const strptr& str = shared.get(id);
+            if((id == SYMBOL_NULL) || (str.len != name.len) || (memcmp(str.ptr, &text[name.offset], name.len) != 0))
+            {
+                printf("shared interner: name %u lost\n", i);
+                return 1;
+            }
+        }
+
+        double private_seconds = run_threads(count, [&](unsigned int thread) {
+            Interner local;
+            uint32_t sum = 0;
+            for(unsigned int i = 0; i < STREAM; i++)
+            {
+                const Name& name = vocabulary[stream[(i + thread * (STREAM / count)) % STREAM]];
+                sum += local.intern(&text[name.offset], name.len);
+            }
+            checksums[thread] += sum;
+        });
+
+        double ops = (double) STREAM * count;
+        printf("%-8u %14.2f %14.2f %14.2f\n", count, ops / shared_seconds / 1e6, ops / private_seconds / 1e6,
+               ops / shared_seconds / 1e6 / count);
+    }
+
+    return 0;
+}
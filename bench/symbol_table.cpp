@@ -0,0 +1,233 @@
+// Scoped symbol lookup: 100k globals with sorted generated names, then blocks
+// nested a thousand deep that each declare a few locals, some shadowing
+// globals, and look names up from the innermost block. The binary tree per
+// scope that SymbolTable was designed around is timed on the same pattern,
+// with fewer globals since sorted names turn it into a list.
+
+#include <stdio.h>
+
+#include <vector>
+
+#include <bench.hpp>
+
+#include <interner.hpp>
+#include <symbol_table.hpp>
+
+// the former design: an unbalanced binary tree of names per scope, searched
+// from the innermost scope outwards
+class TreeTable
+{
+private:
+    struct Node
+    {
+        strptr name;
+        Node* left;
+        Node* right;
+    };
+
+    std::vector<Node*> m_scopes;
+    std::vector<Node*> m_nodes;
+
+public:
+    TreeTable() { m_scopes.push_back(nullptr); }
+
+    ~TreeTable()
+    {
+        for(Node* node : m_nodes)
+        {
+            delete node;
+        }
+    }
+
+    void push() { m_scopes.push_back(nullptr); }
+    void pop()  { m_scopes.pop_back(); }
+
+    void insert(const strptr& name)
+    {
+        Node* node = new Node { name, nullptr, nullptr };
+        m_nodes.push_back(node);
+
+        Node** link = &m_scopes.back();
+        while(*link != nullptr)
+        {
+            link = (name < (*link)->name) ? &(*link)->left : &(*link)->right;
+        }
+        *link = node;
+    }
+
+    bool search(const strptr& name) const
+    {
+        bool found = false;
+        for(size_t i = m_scopes.size(); (i > 0) && !found; i--)
+        {
+            const Node* node = m_scopes[i - 1];
+            while((node != nullptr) && !found)
+            {
+                if(name < node->name)
+                {
+                    node = node->left;
+                }
+                else if(node->name < name)
+                {
+                    node = node->right;
+                }
+                else
+                {
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+};
+
+static const unsigned int DEPTH = 1000;
+static const unsigned int LOCALS = 4;
+static const unsigned int LOOKUPS = 16;
+
+struct Workload
+{
+    Interner names;
+    std::vector<uint32_t> globals;
+    std::vector<uint32_t> locals;  // LOCALS per block
+    std::vector<uint32_t> lookups; // LOOKUPS per block
+};
+
+static void make_workload(Workload& w, unsigned int globals)
+{
+    Random rng(17);
+    char buffer[32];
+
+    // sorted, as a generator or a table of registers would emit them
+    for(unsigned int i = 0; i < globals; i++)
+    {
+        int len = snprintf(buffer, sizeof(buffer), "g_%07u", i);
+        w.globals.push_back(w.names.intern(buffer, (unsigned int) len));
+    }
+
+    for(unsigned int block = 0; block < DEPTH; block++)
+    {
+        for(unsigned int i = 0; i < LOCALS; i++)
+        {
+            if(rng.range(0, 3) == 0)
+            {
+                // shadows a global
+                w.locals.push_back(w.globals[rng.range(0, globals - 1)]);
+            }
+            else
+            {
+                int len = snprintf(buffer, sizeof(buffer), "v_%u_%u", block, i);
+                w.locals.push_back(w.names.intern(buffer, (unsigned int) len));
+            }
+        }
+
+        for(unsigned int i = 0; i < LOOKUPS; i++)
+        {
+            // half globals, half locals of this or an enclosing block
+            bool global = (rng.range(0, 1) == 0);
+            w.lookups.push_back(global ? w.globals[rng.range(0, globals - 1)] : w.locals[rng.range(0, (block + 1) * LOCALS - 1)]);
+        }
+    }
+}
+
+static void run_table(const Workload& w, const char* label)
+{
+    const unsigned int REPEAT = 5;
+
+    double insert_best = 1e30;
+    double nested_best = 1e30;
+    unsigned int found = 0;
+
+    for(unsigned int r = 0; r < REPEAT; r++)
+    {
+        SymbolTable table;
+
+        Timer timer;
+        for(uint32_t name : w.globals)
+        {
+            SymbolTable::Entry entry = { SYM_VARIABLE, name, nullptr, nullptr };
+            table.insert(entry);
+        }
+        double t = timer.seconds();
+        insert_best = (t < insert_best) ? t : insert_best;
+
+        found = 0;
+        timer.reset();
+        for(unsigned int block = 0; block < DEPTH; block++)
+        {
+            table.push();
+            for(unsigned int i = 0; i < LOCALS; i++)
+            {
+                SymbolTable::Entry entry = { SYM_VARIABLE, w.locals[block * LOCALS + i], nullptr, nullptr };
+                table.insert(entry);
+            }
+            for(unsigned int i = 0; i < LOOKUPS; i++)
+            {
+                found += (table.search(w.lookups[block * LOOKUPS + i]) != nullptr) ? 1 : 0;
+            }
+        }
+        for(unsigned int block = 0; block < DEPTH; block++)
+        {
+            table.pop();
+        }
+        t = timer.seconds();
+        nested_best = (t < nested_best) ? t : nested_best;
+    }
+
+    printf("%-20s %8zu globals %10.2f ns/insert %10.2f ns/lookup (%u of %zu found)\n", label, w.globals.size(),
+           insert_best * 1e9 / (double) w.globals.size(), nested_best * 1e9 / (double) w.lookups.size(), found, w.lookups.size());
+}
+
+static void run_tree(const Workload& w, const char* label)
+{
+    double insert_time = 0.0;
+    double nested_time = 0.0;
+    unsigned int found = 0;
+
+    TreeTable table;
+
+    Timer timer;
+    for(uint32_t name : w.globals)
+    {
+        table.insert(w.names.get(name));
+    }
+    insert_time = timer.seconds();
+
+    timer.reset();
+    for(unsigned int block = 0; block < DEPTH; block++)
+    {
+        table.push();
+        for(unsigned int i = 0; i < LOCALS; i++)
+        {
+            table.insert(w.names.get(w.locals[block * LOCALS + i]));
+        }
+        for(unsigned int i = 0; i < LOOKUPS; i++)
+        {
+            found += table.search(w.names.get(w.lookups[block * LOOKUPS + i])) ? 1 : 0;
+        }
+    }
+    for(unsigned int block = 0; block < DEPTH; block++)
+    {
+        table.pop();
+    }
+    nested_time = timer.seconds();
+
+    printf("%-20s %8zu globals %10.2f ns/insert %10.2f ns/lookup (%u of %zu found)\n", label, w.globals.size(),
+           insert_time * 1e9 / (double) w.globals.size(), nested_time * 1e9 / (double) w.lookups.size(), found, w.lookups.size());
+}
+
+int main()
+{
+    printf("%u nested blocks, %u locals and %u lookups in each; lookup times include the blocks' push, inserts and pop\n", DEPTH, LOCALS, LOOKUPS);
+
+    Workload large;
+    make_workload(large, 100000);
+    run_table(large, "hashed undo log");
+
+    Workload small;
+    make_workload(small, 10000);
+    run_table(small, "hashed undo log");
+    run_tree(small, "tree per scope");
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Canonical types: generated sources of each shape are parsed and the types
+// their declarations and casts ask for are set against the distinct ones the
+// type context keeps. Comparing every pair of declared types is then timed
+// with pointer equality against the structural walk over per-mention copies
+// that each comparison needed while every mention had a type of its own.
+
+#include <vector>
+
+#include <bench.hpp>
+#include <generator.hpp>
+
+#include <type_context.hpp>
+
+// equality as it had to be decided before types were shared
+static bool same_structure(const Type* a, const Type* b)
+{
+    bool same = (a->type == b->type) && (a->flags.all == b->flags.all);
+
+    if(same && (a != b))
+    {
+        switch(a->type)
+        {
+            case TYPE_PTR: { same = same_structure(a->data.pointer, b->data.pointer); break; }
+            case TYPE_FUNCTION:
+            {
+                const List<Type>& pa = a->data.function.parameters;
+                const List<Type>& pb = b->data.function.parameters;
+
+                same = (pa.size() == pb.size()) && same_structure(a->data.function.return_type, b->data.function.return_type);
+                for(unsigned int i = 0; same && (i < pa.size()); i++)
+                {
+                    same = same_structure(pa[i], pb[i]);
+                }
+                break;
+            }
+            case TYPE_COMPOSITE: { same = (a->data.composite == b->data.composite); break; }
+            default: { break; }
+        }
+    }
+
+    return same;
+}
+
+// a tree of its own for one mention, as the parser used to build them
+static Type* clone(const Type* type, AstArena& arena, std::vector<void*>& list_stack)
+{
+    Type* copy = arena.make<Type>();
+    *copy = *type;
+
+    switch(type->type)
+    {
+        case TYPE_PTR: { copy->data.pointer = clone(type->data.pointer, arena, list_stack); break; }
+        case TYPE_FUNCTION:
+        {
+            copy->data.function.return_type = clone(type->data.function.return_type, arena, list_stack);
+
+            ListBuilder<Type> params(&list_stack);
+            for(const Type* param : type->data.function.parameters)
+            {
+                params.insert(clone(param, arena, list_stack));
+            }
+            params.seal(&copy->data.function.parameters, &arena);
+            break;
+        }
+        default: { break; }
+    }
+
+    return copy;
+}
+
+static void collect(const List<Statement>& statements, std::vector<const Type*>& types)
+{
+    for(const Statement* stmt : statements)
+    {
+        if(stmt->type == STMT_DECLARATION)
+        {
+            for(const Declaration* decl : stmt->data.declarations)
+            {
+                switch(decl->type)
+                {
+                    case DECL_VARIABLE: { types.push_back(decl->data.variable.type); break; }
+                    case DECL_FUNCTION:
+                    {
+                        types.push_back(decl->data.function.type);
+                        if(decl->data.function.body != nullptr)
+                        {
+                            collect(*decl->data.function.body, types);
+                        }
+                        break;
+                    }
+                    default: { break; }
+                }
+            }
+        }
+    }
+}
+
+static const unsigned int PAIRS = 1 << 20;
+
+int main()
+{
+    printf("%-12s %10s %10s %12s %10s %12s %12s\n", "shape", "requests", "distinct", "type KB", "was KB", "ptr ns/eq", "walk ns/eq");
+
+    int result = 0;
+    for(unsigned int shape = 0; (result == 0) && (shape < SHAPE_COUNT); shape++)
+    {
+        std::string input;
+        SourceGenerator generator(30 + shape);
+        generator.generate(shape, 1 << 20, &input);
+
+        TokenStack stack;
+        AST* ast = parse(input, &stack);
+
+        if(ast == nullptr)
+        {
+            printf("type_context: failed to parse %s\n", SourceGenerator::ShapeName(shape));
+            result = 1;
+            break;
+        }
+
+        std::vector<const Type*> types;
+        collect(ast->statements, types);
+
+        AstArena arena;
+        std::vector<void*> list_stack;
+        std::vector<const Type*> copies;
+        for(const Type* type : types)
+        {
+            copies.push_back(clone(type, arena, list_stack));
+        }
+
+        Random rng(31);
+        std::vector<uint32_t> pairs;
+        for(unsigned int i = 0; i < 2 * PAIRS; i++)
+        {
+            pairs.push_back(rng.range(0, (uint32_t) types.size() - 1));
+        }
+
+        unsigned int same_ptr = 0;
+        Timer timer;
+        for(unsigned int i = 0; i < PAIRS; i++)
+        {
+            same_ptr += (types[pairs[2 * i]] == types[pairs[2 * i + 1]]) ? 1 : 0;
+        }
+        double ptr_time = timer.seconds();
+
+        unsigned int same_walk = 0;
+        timer.reset();
+        for(unsigned int i = 0; i < PAIRS; i++)
+        {
+            same_walk += same_structure(copies[pairs[2 * i]], copies[pairs[2 * i + 1]]) ? 1 : 0;
+        }
+        double walk_time = timer.seconds();
+
+        if(same_ptr != same_walk)
+        {
+            printf("type_context: %u pairs equal by pointer, %u by structure\n", same_ptr, same_walk);
+            result = 1;
+        }
+
+        // before, every request allocated a node of its own
+        const TypeContext& context = *ast->types;
+        printf("%-12s %10zu %10zu %12.1f %10.1f %12.2f %12.2f\n", SourceGenerator::ShapeName(shape), context.requests(), context.size(),
+               (double) (context.size() * sizeof(Type)) / 1024.0, (double) (context.requests() * sizeof(Type)) / 1024.0,
+               ptr_time * 1e9 / PAIRS, walk_time * 1e9 / PAIRS);
+
+        delete_ast(ast);
+    }
+
+    return result;
+}
@@ -18,6 +18,6 @@ enum
 #define IS_ALPHA(x) ((((x) >= 'a') && ((x) <= 'z')) || (((x) >= 'A') && ((x) <= 'Z')))
 #define IS_ALPHA_NUM(x) (IS_ALPHA(x) || IS_NUM(x))
 #define IS_SPACE(x) (((x) == ' ') || ((x) == '\t') || ((x) == '\n'))
-#define IS_HEXADECIMAL(x) (IS_NUM(x) || ((x >= 'A') && (x <= 'F')))
+#define IS_HEXADECIMAL(x) (IS_NUM(x) || (((x) >= 'A') && ((x) <= 'F')) || (((x) >= 'a') && ((x) <= 'f')))
 
 #endif // ASCII_H
\ No newline at end of file
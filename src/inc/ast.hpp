@@ -5,6 +5,8 @@
 #include <token.hpp>
 
 #include <list.hpp>
+#include <ast_arena.hpp>
+#include <string_pool.hpp>
 
 enum EXPR_TYPE
 {
@@ -115,11 +117,14 @@ struct Expression;
 struct Statement;
 struct Type;
 
+class TypeContext;
+struct Layout;
+
 struct Enumerator
 {
     struct Value
     {
-        strptr      name;
+        uint32_t    name; // symbol id
         Expression* value;
     };
 
@@ -129,24 +134,29 @@ struct Enumerator
 struct Composite
 {
     uint8_t type;
+
+    // computed by LayoutEngine, nullptr until then; composite types are
+    // interned on this node, so every mention of the type shares it
+    const Layout* layout;
 };
 
 struct Function
 {
+    // a parameter as a function declaration names it
     struct Parameter
     {
-        strptr name;
-        Type*  type;
+        uint32_t name; // symbol id
+        Type*    type;
     };
 
     Type* return_type;
-    List<Parameter> parameters;
+    List<Type> parameters; // the names are on the declaration, see Declaration
 };
 
 struct Declaration
 {
-    uint8_t type;
-    strptr  name;
+    uint8_t  type;
+    uint32_t name; // symbol id
 
     union
     {
@@ -160,6 +170,7 @@ struct Declaration
         {
             Type* type;
             List<Statement>* body;
+            List<Function::Parameter>* parameters; // the parameters of type with their names
         } function;
 
         struct
@@ -191,12 +202,17 @@ struct Type
 
     struct Array
     {
-        Expression* size;
-        Type* elements;
+        static const uint64_t UNSIZED     = UINT64_MAX;     // count of T[]
+        static const uint64_t UNEVALUATED = UINT64_MAX - 1; // count until the size is evaluated
+
+        Expression* size; // as written, nullptr for T[]
+        Type*       elements;
+        uint64_t    count; // size evaluated by ConstantEvaluator::Dimensions
     };
 
     uint8_t type;
     Flags flags;
+    Type* unqualified; // this type without flags, itself when it has none
 
     union Data
     {
@@ -234,7 +250,7 @@ struct Expression
     union
     {
         Cast       cast;
-        strptr     identifier;
+        uint32_t   identifier; // symbol id
         Literal    literal;
         Operation  operation;
 		Func_Call  func_call;
@@ -270,8 +286,8 @@ struct Statement
     
     struct TypeDef
     {
-        strptr  name;
-        Type*   type;
+        uint32_t name; // symbol id
+        Type*    type;
     };
 
     struct Return
@@ -281,7 +297,7 @@ struct Statement
 
     struct Goto
     {
-        strptr target;
+        uint32_t target; // symbol id
     };
 
     struct Switch
@@ -297,7 +313,7 @@ struct Statement
 
     struct Label
     {
-        strptr name;
+        uint32_t name; // symbol id
     };
 
     struct Block
@@ -327,9 +343,23 @@ struct Statement
 
 struct AST
 {
+    // owns every node below, delete_ast() frees the tree in one go
+    AstArena arena;
+
     List<Statement> statements;
+
+    // the canonical types the nodes point to, see TypeContext
+    TypeContext* types;
+
+    // resolves the symbol ids stored in the tree
+    const Interner* symbols;
+    // the distinct string literals, by the id stored in each literal
+    const StringPool* strings;
 };
 
 void delete_ast(AST* ast);
 
+// name of a binary EXPR_OP_* as printed in the tree
+const char* op_name(uint8_t op);
+
 #endif // AST_HPP
@@ -0,0 +1,55 @@
+#ifndef AST_ARENA_HPP
+#define AST_ARENA_HPP
+
+#include <new>
+#include <type_traits>
+
+#include <arena.hpp>
+
+// Owns every node of one AST. Nodes are bump-allocated from large chunks and
+// are never freed one at a time: destroying the AST, or reset(), releases the
+// whole tree at once, so node types must not need a destructor. An AST is
+// only ever built by a single parser, so when files are parsed in parallel
+// each thread allocates from its own arena without locking.
+class AstArena
+{
+private:
+    enum
+    {
+        CHUNK_SIZE = 256 * 1024
+    };
+
+    Arena m_arena;
+
+public:
+    AstArena() : m_arena(CHUNK_SIZE) {}
+
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    // a value-initialized T, i.e. zeroed like new T()
+    template<typename T>
+    T* make()
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena nodes are never destroyed");
+        return new (m_arena.allocate(sizeof(T), alignof(T))) T();
+    }
+
+    // raw storage, e.g. for list elements
+    void* allocate(size_t size, size_t align)
+    {
+        return m_arena.allocate(size, align);
+    }
+
+    void reset()
+    {
+        m_arena.reset();
+    }
+
+    Arena::Stats get_stats() const
+    {
+        return m_arena.get_stats();
+    }
+};
+
+#endif // AST_ARENA_HPP
@@ -9,6 +9,7 @@ class AST_Printer
 {
 private:
     std::vector<uint8_t> m_tab_stack;
+    const Interner* m_symbols;
 
     enum TAB
     {
@@ -18,11 +19,12 @@ private:
     };
 
 private:
-    AST_Printer();
+    AST_Printer(const Interner* symbols);
 
     void print(const char* format, ...);
 
-    void print_identifier(unsigned int indent, const strptr* id);
+    void print_identifier(unsigned int indent, uint32_t id);
+    void print_name(uint32_t id);
     void print_body(unsigned int indent, const List<Statement>* body);
 
     void print_statement(unsigned int indent, const Statement* stmt);
@@ -32,11 +34,13 @@ private:
     void print_expr_operation(unsigned int indent, const Expression* lhs, const Expression* rhs);
     void print_func_call(unsigned int indent, const Expression::Func_Call* expr);
 
+    void print_suffix(uint8_t suffix);
     void print_literal(unsigned int indent, const Literal* literal);
     void print_array(unsigned int indent, const Type::Array* array);
-    void print_parameter(unsigned int indent, const Function::Parameter* param);
-    void print_parameter_list(unsigned int indent, const List<Function::Parameter>* list);
-    void print_type(unsigned int indent, const Type* type);
+    void print_parameter(unsigned int indent, uint32_t name, const Type* type);
+    void print_parameter_list(unsigned int indent, const List<Type>* list, const List<Function::Parameter>* names);
+    // names, if given, are the parameters of a function type as its declaration names them
+    void print_type(unsigned int indent, const Type* type, const List<Function::Parameter>* names = nullptr);
     void print_type_flags(unsigned int indent, const Type::Flags* flags);
     void print_for_stmt(unsigned int indent, const Statement::ForLoop* loop);
     void print_while_stmt(unsigned int indent, const Statement::WhileLoop* loop);
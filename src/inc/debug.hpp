@@ -1,6 +1,8 @@
 #ifndef DEBUG_HPP
 #define DEBUG_HPP
 
-#define error(str, ...) printf("[%s]: " str, __FUNCTION__, ##__VA_ARGS__);
+#include <diagnostics.hpp>
+
+#define error(str, ...) Diagnostics::Print("[%s]: " str, __FUNCTION__, ##__VA_ARGS__);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,167 @@
+#ifndef FLAT_AST_HPP
+#define FLAT_AST_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <ast.hpp>
+
+// Kinds of node in a FlatAST. Every kind except the immediate ones has a pool
+// of its own in which each node takes exactly the size of its record.
+enum FLAT_NODE
+{
+    FLAT_INVALID          = 0x00,
+
+    FLAT_EXPR_IDENTIFIER  = 0x01,
+    FLAT_EXPR_LITERAL     = 0x02,
+    FLAT_EXPR_OPERATION   = 0x03,
+    FLAT_EXPR_SUB_EXPR    = 0x04,
+    FLAT_EXPR_CAST        = 0x05,
+    FLAT_EXPR_CALL        = 0x06,
+    FLAT_EXPR_INITIALIZER = 0x07,
+    FLAT_EXPR_COMPOUND    = 0x08,
+
+    FLAT_STMT_EXPR        = 0x09,
+    FLAT_STMT_IF          = 0x0A,
+    FLAT_STMT_RETURN      = 0x0B,
+    FLAT_STMT_FOR         = 0x0C,
+    FLAT_STMT_WHILE       = 0x0D,
+    FLAT_STMT_BLOCK       = 0x0E,
+    FLAT_STMT_DECLARATION = 0x0F,
+
+    FLAT_DECL_VARIABLE    = 0x10,
+    FLAT_DECL_FUNCTION    = 0x11,
+    FLAT_DECL_COMPOSITE   = 0x12,
+    FLAT_DECL_ENUMERATOR  = 0x13,
+
+    FLAT_TYPE_IMMEDIATE   = 0x14, // no pool, see FlatAST::Immediate
+    FLAT_TYPE_POINTER     = 0x15,
+    FLAT_TYPE_ARRAY       = 0x16,
+    FLAT_TYPE_FUNCTION    = 0x17,
+
+    FLAT_NODE_COUNT       = 0x18
+};
+
+// An AST laid out as plain arrays instead of linked nodes. A node is named by
+// a 32-bit Ref holding its kind in the top bits and its index in that kind's
+// pool in the rest, so an identifier costs four bytes instead of the size of
+// the largest Expression. Children with a variable count are a Range in the
+// shared refs array; function parameters, which all have one record type, are
+// a Range straight into their pool. Nothing holds a pointer, so the whole tree
+// can be copied or written out as is.
+struct FlatAST
+{
+    typedef uint32_t Ref;
+
+    static const Ref NONE = 0xFFFFFFFF;
+
+    enum
+    {
+        INDEX_BITS = 27,
+        INDEX_MASK = (1 << INDEX_BITS) - 1
+    };
+
+    struct Range
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // types without children are stored in the Ref itself
+    union Immediate
+    {
+        struct
+        {
+            uint8_t type;      // TYPE_*
+            uint8_t flags;     // Type::Flags::all
+            uint8_t composite; // COMP_TYPE_* of a TYPE_COMPOSITE
+        } fields;
+
+        uint32_t all;
+    };
+
+    struct Literal
+    {
+        uint8_t type;
+        uint8_t suffix;
+
+        union
+        {
+            uint64_t integer_value;
+            double   float_value;
+            char     character;
+            uint32_t string; // id in the StringPool
+        } data;
+    };
+
+    struct Operation { uint8_t op; Ref lhs; Ref rhs; };
+    struct Cast      { Ref type; Ref expr; };
+    struct Call      { Ref function; Range arguments; };
+
+    struct If        { Ref condition; Ref on_true; Ref on_false; };
+    struct For       { Ref init; Ref cond; Ref step; Ref body; };
+    struct While     { Ref cond; Ref body; };
+
+    struct Variable  { uint32_t name; Ref type; Ref value; };
+    struct Function  { uint32_t name; Ref type; Range body; };    // body.first is NONE without a body
+    struct Composite { uint32_t name; uint8_t type; Range body; }; // as above
+
+    struct Pointer   { uint8_t flags; Ref target; };
+    struct Array     { uint8_t flags; Ref size; Ref elements; uint64_t count; }; // size and count as in Type::Array
+    struct Signature { uint8_t flags; Ref return_type; Range parameters; };
+    struct Parameter { uint32_t name; Ref type; };
+
+    // expressions
+    std::vector<uint32_t>  identifiers; // symbol ids
+    std::vector<Literal>   literals;
+    std::vector<Operation> operations;
+    std::vector<Ref>       sub_exprs;
+    std::vector<Cast>      casts;
+    std::vector<Call>      calls;
+    std::vector<Range>     expr_lists; // initializers and compound expressions
+
+    // statements
+    std::vector<Ref>   expr_stmts;
+    std::vector<If>    if_stmts;
+    std::vector<Ref>   return_stmts;
+    std::vector<For>   for_stmts;
+    std::vector<While> while_stmts;
+    std::vector<Range> blocks;
+    std::vector<Range> declarations;
+
+    // declarations
+    std::vector<Variable>  variables;
+    std::vector<Function>  functions;
+    std::vector<Composite> composites;
+    std::vector<uint32_t>  enumerators; // symbol ids
+
+    // types
+    std::vector<Pointer>   pointers;
+    std::vector<Array>     arrays;
+    std::vector<Signature> signatures;
+    std::vector<Parameter> parameters;
+
+    std::vector<Ref> refs;
+    Range statements;
+
+    const Interner* symbols;
+    const StringPool* strings;
+
+    static Ref make_ref(uint8_t kind, uint32_t index) { return ((uint32_t) kind << INDEX_BITS) | index; }
+    static uint8_t kind_of(Ref ref)                 { return (ref == NONE) ? (uint8_t) FLAT_INVALID : (uint8_t) (ref >> INDEX_BITS); }
+    static uint32_t index_of(Ref ref)               { return ref & INDEX_MASK; }
+
+    // bytes used by the pools, not counting unused capacity
+    size_t bytes() const;
+    // nodes in the pools
+    size_t nodes() const;
+};
+
+// Builds the flat form of an AST. The AST may be deleted afterwards; string
+// literals and names are still resolved through its token stack's tables.
+// Returns false if the AST is too large for the index width of a Ref.
+bool flatten_ast(const AST* ast, FlatAST* flat);
+
+#endif // FLAT_AST_HPP
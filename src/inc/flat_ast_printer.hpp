@@ -0,0 +1,60 @@
+#ifndef FLAT_AST_PRINTER_HPP
+#define FLAT_AST_PRINTER_HPP
+
+#include <vector>
+
+#include <flat_ast.hpp>
+
+// Prints a FlatAST in exactly the format of AST_Printer, so that the two
+// outputs of one file can be compared line for line.
+class FlatAST_Printer
+{
+private:
+    typedef FlatAST::Ref Ref;
+    typedef FlatAST::Range Range;
+
+    std::vector<uint8_t> m_tab_stack;
+    const FlatAST* m_ast;
+
+    enum TAB
+    {
+        SPACE = 0,
+        LINE  = 1,
+        JOINT = 2
+    };
+
+private:
+    FlatAST_Printer(const FlatAST* ast);
+
+    void print(const char* format, ...);
+
+    void print_identifier(unsigned int indent, uint32_t id);
+    void print_name(uint32_t id);
+    void print_body(unsigned int indent, Range body);
+
+    void print_statement(unsigned int indent, Ref stmt);
+
+    void print_expr(unsigned int indent, Ref expr);
+    void print_expr_operation(unsigned int indent, Ref expr);
+    void print_expr_operation(unsigned int indent, Ref lhs, Ref rhs);
+    void print_func_call(unsigned int indent, const FlatAST::Call* call);
+
+    void print_suffix(uint8_t suffix);
+    void print_literal(unsigned int indent, const FlatAST::Literal* literal);
+    void print_array(unsigned int indent, const FlatAST::Array* array);
+    void print_parameter(unsigned int indent, const FlatAST::Parameter* param);
+    void print_parameter_list(unsigned int indent, Range list);
+    void print_type(unsigned int indent, Ref type);
+    void print_type_flags(unsigned int indent, uint8_t flags);
+    void print_for_stmt(unsigned int indent, const FlatAST::For* loop);
+    void print_while_stmt(unsigned int indent, const FlatAST::While* loop);
+    void print_if_stmt(unsigned int indent, const FlatAST::If* stmt);
+    void print_decl_list(unsigned int indent, Range decl_list);
+    void print_decl_variable(unsigned int indent, const FlatAST::Variable* decl);
+    void print_decl_function(unsigned int indent, const FlatAST::Function* decl);
+
+public:
+    static void Print(const FlatAST* ast);
+};
+
+#endif // FLAT_AST_PRINTER_HPP
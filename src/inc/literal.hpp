@@ -15,6 +15,7 @@ enum LITERAL
 struct Literal
 {
     uint8_t type;
+    uint8_t suffix; // TK_TYPE_* from a suffix such as 10u8, else TK_TYPE_INVALID
 
     union
     {
@@ -26,6 +27,7 @@ struct Literal
         {
             const char*  ptr;
             unsigned int len;
+            uint32_t     id; // in the StringPool
         } string;
     } data;
 };
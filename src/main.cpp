@@ -4,47 +4,338 @@
 #include "tokenizer.hpp"
 
 #include <parser.hpp>
+#include <analyzer.hpp>
+#include <constant_evaluator.hpp>
 #include <debug.hpp>
 #include <ast_printer.hpp>
+#include <driver.hpp>
+#include <flat_ast_printer.hpp>
+#include <layout_engine.hpp>
+#include <trace.hpp>
 
-bool process(const char* path)
+#include <stdlib.h>
+#include <string.h>
+
+void print_stats(const TokenStack& token_stack, const AST* ast, const FlatAST* flat)
+{
+    TokenStack::Stats stats = token_stack.get_stats();
+    double tokens = (stats.tokens > 0) ? (double) stats.tokens : 1.0;
+
+    printf("tokens:          %zu (%zu literals)\n", stats.tokens, stats.literals);
+    if(stats.ring > 0)
+    {
+        // the ring's size does not depend on the source, so it is not per token
+        printf("token ring:      %zu slots, %zu bytes\n", stats.ring, stats.reserved);
+        printf("peak window:     %zu tokens from the oldest mark or the cursor\n", stats.peak);
+    }
+    else
+    {
+        printf("token bytes:     %zu used, %zu reserved\n", stats.bytes, stats.reserved);
+        printf("bytes per token: %.2f used, %.2f reserved (sizeof(Token) = %zu)\n",
+               stats.bytes / tokens, stats.reserved / tokens, sizeof(Token));
+        printf("peak tokens held: %zu\n", stats.peak);
+    }
+
+    const StringPool& strings = token_stack.strings();
+    printf("string literals: %u distinct, %llu bytes\n", strings.size(), (unsigned long long) strings.bytes());
+
+    if(ast != nullptr)
+    {
+        Arena::Stats nodes = ast->arena.get_stats();
+        printf("ast nodes:       %zu allocations, %zu bytes in %zu chunks, %zu bytes wasted\n",
+               nodes.allocations, nodes.allocated, nodes.chunks, nodes.reserved - nodes.allocated);
+    }
+
+    if(flat != nullptr)
+    {
+        printf("flat ast:        %zu nodes, %zu bytes\n", flat->nodes(), flat->bytes());
+    }
+}
+
+struct Options
+{
+    bool stats;
+    bool stream;
+    bool tokens; // print the token list before parsing
+    bool trace;  // dump the trace ring when done, it is always dumped on error
+    bool flat;   // print the tree through its flat form
+    bool check;  // run semantic analysis before printing
+    bool fold;   // replace constant expressions with their values before printing
+    bool layout; // print the layout of every struct and union before the tree
+    bool reorder; // lay out struct fields in the order with the least padding
+    unsigned int jobs; // lexer threads for one file, files at once for several
+};
+
+// semantic analysis, with the function bodies spread over --jobs threads
+bool check(const AST* ast, const Options& options)
+{
+    ThreadPool* pool = (options.jobs > 1) ? new ThreadPool(options.jobs) : nullptr;
+
+    Analyzer::Stats stats = {};
+    bool status = Analyzer::Analyze(ast, pool, &stats);
+    if(!status)
+    {
+        error("%u errors in semantic analysis\n", stats.errors);
+    }
+    else if(options.stats)
+    {
+        printf("semantic:        %u globals, %u functions checked\n", stats.globals, stats.functions);
+    }
+
+    delete pool;
+    return status;
+}
+
+// replaces the constant expressions of the tree with their values
+void fold(AST* ast, const Options& options)
+{
+    unsigned int folded = ConstantEvaluator::Fold(ast);
+    if(options.stats)
+    {
+        printf("folded:          %u constant expressions\n", folded);
+    }
+}
+
+// lays out the structs and unions of the tree, with a report of each
+bool layout(AST* ast, const Options& options)
+{
+    LayoutEngine::Report report = {};
+    bool status = LayoutEngine::Compute(ast, options.reorder, &report);
+    if(!status)
+    {
+        error("some structs or unions cannot be laid out\n");
+    }
+    else
+    {
+        LayoutEngine::Print(report, ast->symbols);
+    }
+    return status;
+}
+
+bool process(const char* path, const Options& options)
 {
 	TokenStack token_stack;
-    bool status = Tokenizer::Tokenize(path, &token_stack);
+    bool status = true;
+
+    if(options.stream)
+    {
+        // tokens are lexed as the parser asks for them
+        status = Tokenizer::Stream(path, &token_stack);
+    }
+    else if(options.jobs > 1)
+    {
+        ThreadPool pool(options.jobs);
+        status = Tokenizer::TokenizeParallel(path, &token_stack, &pool);
+    }
+    else
+    {
+        status = Tokenizer::Tokenize(path, &token_stack);
+    }
 
-    const std::vector<Token>& tokens = token_stack.get_tokens();
-    for(unsigned int i = 0; i < tokens.size(); i++)
+    if(status && options.tokens && !options.stream)
     {
-        print_token(tokens[i]);
+        for(unsigned int i = 0; i < token_stack.size(); i++)
+        {
+            print_token(token_stack.get(i), &token_stack.symbols());
+        }
     }
 
+    AST* ast = nullptr;
+    FlatAST flat = {};
+    bool flattened = false;
     if(status)
     {
-        AST* ast = Parser::Parse(token_stack);
-        if(ast != nullptr)
+        ast = Parser::Parse(token_stack);
+        if((ast != nullptr) && options.check && !check(ast, options))
         {
-            AST_Printer::Print(ast);
+            // the tree is not printed when it does not check
+            status = false;
         }
-        else
+        else if(ast != nullptr)
+        {
+            if(options.fold)
+            {
+                fold(ast, options);
+            }
+
+            if((options.layout || options.reorder) && !layout(ast, options))
+            {
+                status = false;
+            }
+            else if(options.flat)
+            {
+                flattened = flatten_ast(ast, &flat);
+                if(flattened)
+                {
+                    FlatAST_Printer::Print(&flat);
+                }
+                else
+                {
+                    status = false;
+                    error("the tree is too large to flatten\n");
+                }
+            }
+            else
+            {
+                AST_Printer::Print(ast);
+            }
+        }
+        else if(!token_stack.failed())
         {
             status = false;
             error("an error occurred while parsing\n");
         }
+        else
+        {
+            // a streamed source stopped at a lexing error, already reported
+            status = false;
+        }
         
     }
 
+    if(options.stats)
+    {
+        print_stats(token_stack, ast, flattened ? &flat : nullptr);
+    }
+
+    if(ast != nullptr)
+    {
+        delete_ast(ast);
+    }
+
+    if(options.trace || !status)
+    {
+        Trace::Dump(stdout);
+    }
+
+    return status;
+}
+
+// several files, directories or response files are compiled without
+// printing their trees, see Driver
+bool process_all(const std::vector<std::string>& paths, const Options& options)
+{
+    std::vector<Driver::Unit> units;
+    Driver::Summary summary = {};
+
+    bool status = Driver::Compile(paths, options.jobs, options.check, &units, &summary);
+    Driver::Report(units, summary, options.stats);
+
+    if(options.trace)
+    {
+        Trace::Dump(stdout);
+    }
+
     return status;
 }
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2)
+    std::vector<const char*> inputs;
+    bool valid = true;
+    bool jobs_given = false;
+    Options options = {};
+    options.jobs = 1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--stats") == 0)
+        {
+            options.stats = true;
+        }
+        else if(strcmp(argv[i], "--stream") == 0)
+        {
+            options.stream = true;
+        }
+        else if(strcmp(argv[i], "--tokens") == 0)
+        {
+            options.tokens = true;
+        }
+        else if(strcmp(argv[i], "--trace") == 0)
+        {
+            options.trace = true;
+        }
+        else if(strcmp(argv[i], "--flat") == 0)
+        {
+            options.flat = true;
+        }
+        else if(strcmp(argv[i], "--check") == 0)
+        {
+            options.check = true;
+        }
+        else if(strcmp(argv[i], "--fold") == 0)
+        {
+            options.fold = true;
+        }
+        else if(strcmp(argv[i], "--layout") == 0)
+        {
+            options.layout = true;
+        }
+        else if(strcmp(argv[i], "--reorder") == 0)
+        {
+            options.reorder = true;
+        }
+        else if((strcmp(argv[i], "--jobs") == 0) && (i + 1 < argc))
+        {
+            // 0 picks one per hardware thread
+            options.jobs = (unsigned int) strtoul(argv[++i], nullptr, 10);
+            if(options.jobs == 0)
+            {
+                options.jobs = ThreadPool::HardwareThreads();
+            }
+            jobs_given = true;
+        }
+        else if(argv[i][0] != '-')
+        {
+            inputs.push_back(argv[i]);
+        }
+        else
+        {
+            valid = false;
+            break;
+        }
+    }
+
+    std::vector<std::string> paths;
+    for(unsigned int i = 0; valid && (i < inputs.size()); i++)
+    {
+        valid = Driver::Collect(inputs[i], &paths);
+    }
+
+    // several inputs are compiled without printing, see process_all
+    bool batch = (inputs.size() != 1) || (paths.size() != 1) || (paths[0] != inputs[0]);
+
+    const char* conflict = nullptr;
+    if(valid && options.tokens && options.stream)
+    {
+        conflict = "--tokens cannot be used with --stream";
+    }
+    else if(valid && batch && (options.stream || options.tokens || options.flat || options.fold || options.layout || options.reorder))
     {
-        printf("Invalid arguments\n");
+        conflict = "--stream, --tokens, --flat, --fold, --layout and --reorder take a single file";
+    }
+
+    if (!valid || paths.empty() || (conflict != nullptr))
+    {
+        printf("%s\n", (conflict != nullptr) ? conflict : "Invalid arguments");
+        printf("usage: %s [--stats] [--stream] [--tokens] [--trace] [--flat] [--check] [--fold] [--layout] [--reorder] [--jobs N] <file>\n", argv[0]);
+        printf("       %s [--stats] [--trace] [--check] [--jobs N] <file|directory|@response>...\n", argv[0]);
         return -1;
     }
 
-    if(!process(argv[1]))
+    bool status = true;
+    if(!batch)
+    {
+        status = process(inputs[0], options);
+    }
+    else
+    {
+        // without --jobs use every hardware thread
+        options.jobs = jobs_given ? options.jobs : ThreadPool::HardwareThreads();
+        status = process_all(paths, options);
+    }
+
+    if(!status)
     {
         return -1;
     }
@@ -0,0 +1,1314 @@
+#include <analyzer.hpp>
+
+#include <stdarg.h>
+
+#include <string>
+
+#include <constant_evaluator.hpp>
+#include <diagnostics.hpp>
+#include <interner.hpp>
+#include <token.hpp>
+#include <type_context.hpp>
+
+static_assert(((int) TK_TYPE_VOID == (int) TYPE_VOID) && ((int) TK_TYPE_F64 == (int) TYPE_F64), "literal suffixes are read as TYPE_* values");
+
+namespace
+{
+    // The type of an expression. Taking an address only ever adds pointer
+    // levels over a type the tree already has, so instead of building the
+    // new type, which would need the type context the workers share, a value
+    // counts those levels: &x is { type of x, 1 }.
+    struct Value
+    {
+        const Type*  type; // nullptr for an initializer list
+        unsigned int refs; // pointer levels over type
+        bool lvalue;
+        bool null;         // the literal 0, which converts to any pointer
+    };
+
+    bool is_integer(const Value& v)
+    {
+        return (v.type != nullptr) && (v.refs == 0) && (v.type->type >= TYPE_U8) && (v.type->type <= TYPE_I64);
+    }
+
+    bool is_arithmetic(const Value& v)
+    {
+        return (v.type != nullptr) && (v.refs == 0) && (v.type->type >= TYPE_U8) && (v.type->type <= TYPE_F64);
+    }
+
+    bool is_pointer(const Value& v)
+    {
+        return (v.type != nullptr) && ((v.refs > 0) || (v.type->type == TYPE_PTR) || (v.type->type == TYPE_ARRAY));
+    }
+
+    bool is_function(const Value& v)
+    {
+        return (v.type != nullptr) && (v.refs == 0) && (v.type->type == TYPE_FUNCTION);
+    }
+
+    bool is_scalar(const Value& v)
+    {
+        return is_arithmetic(v) || is_pointer(v);
+    }
+
+    bool is_void(const Value& v)
+    {
+        return (v.type != nullptr) && (v.refs == 0) && (v.type->type == TYPE_VOID);
+    }
+
+    // what a pointer value points to; a function is not an lvalue
+    Value pointee(const Value& v)
+    {
+        Value p = { v.type, 0, true, false };
+        if(v.refs > 0)
+        {
+            p.refs = v.refs - 1;
+        }
+        else if(v.type->type == TYPE_PTR)
+        {
+            p.type = v.type->data.pointer;
+        }
+        else
+        {
+            p.type = v.type->data.array.elements;
+        }
+        p.lvalue = !is_function(p);
+        return p;
+    }
+
+    // Types are canonical, so equal pointers are equal types. Without flags,
+    // the outermost flags of a and b are not compared.
+    bool same_type(const Type* a, const Type* b, bool flags = true)
+    {
+        return flags ? (a == b) : (a->unqualified == b->unqualified);
+    }
+
+    // whether a pointer to target may point at p, which may only gain flags
+    bool same_pointee(const Type* target, const Value& p)
+    {
+        bool same = true;
+        bool outermost = true;
+
+        // the levels counted in refs are pointers without flags
+        for(unsigned int refs = p.refs; same && (refs > 0); refs--)
+        {
+            same = (target->type == TYPE_PTR) && (outermost || (target->flags.all == 0));
+            if(same)
+            {
+                target = target->data.pointer;
+                outermost = false;
+            }
+        }
+
+        if(same && outermost)
+        {
+            same = ((target->flags.all & p.type->flags.all) == p.type->flags.all) && same_type(target, p.type, false);
+        }
+        else if(same)
+        {
+            same = same_type(target, p.type);
+        }
+
+        return same;
+    }
+
+    // whether two pointers point at the same type, or could after gaining flags
+    bool same_pointer(const Value& a, const Value& b)
+    {
+        Value pa = pointee(a);
+        Value pb = pointee(b);
+
+        unsigned int common = (pa.refs < pb.refs) ? pa.refs : pb.refs;
+        pa.refs -= common;
+        pb.refs -= common;
+
+        return (pa.refs == 0) ? same_pointee(pa.type, pb) : same_pointee(pb.type, pa);
+    }
+
+    // whether == and the other comparisons apply
+    bool comparable(const Value& l, const Value& r)
+    {
+        bool pointers = is_pointer(l) && is_pointer(r);
+        return (is_arithmetic(l) && is_arithmetic(r)) ||
+               (pointers && (is_void(pointee(l)) || is_void(pointee(r)) || same_pointer(l, r))) ||
+               (is_pointer(l) && r.null) || (l.null && is_pointer(r));
+    }
+
+    // whether a value can be assigned to, passed as or returned as target
+    bool assignable(const Type* target, const Value& v)
+    {
+        bool ok = false;
+
+        if(v.type == nullptr)
+        {
+            ok = (target->type == TYPE_COMPOSITE) || (target->type == TYPE_ARRAY);
+        }
+        else
+        {
+            switch(target->type)
+            {
+                case TYPE_PTR:
+                {
+                    const Type* to = target->data.pointer;
+                    if(v.null)
+                    {
+                        ok = true;
+                    }
+                    else if(is_function(v))
+                    {
+                        ok = same_type(to, v.type, false);
+                    }
+                    else if(is_pointer(v))
+                    {
+                        Value p = pointee(v);
+                        ok = (to->type == TYPE_VOID) || is_void(p) || same_pointee(to, p);
+                    }
+                    break;
+                }
+                case TYPE_COMPOSITE:
+                {
+                    ok = (v.refs == 0) && (v.type->type == TYPE_COMPOSITE) && (v.type->data.composite == target->data.composite);
+                    break;
+                }
+                case TYPE_VOID:
+                case TYPE_ARRAY:
+                case TYPE_FUNCTION:
+                {
+                    break;
+                }
+                default:
+                {
+                    ok = is_arithmetic(v);
+                    break;
+                }
+            }
+        }
+
+        return ok;
+    }
+
+    void describe(const Type* type, std::string* out)
+    {
+        static const char* NAMES[] = { "?", "void", "U8", "U16", "U32", "U64", "I8", "I16", "I32", "I64", "F32", "F64" };
+
+        if(type->flags.bits.is_constant)
+        {
+            *out += "const ";
+        }
+
+        switch(type->type)
+        {
+            case TYPE_PTR:   { describe(type->data.pointer, out); *out += "*"; break; }
+            case TYPE_ARRAY: { describe(type->data.array.elements, out); *out += "[]"; break; }
+            case TYPE_FUNCTION:
+            {
+                describe(type->data.function.return_type, out);
+                *out += "(";
+                const List<Type>& params = type->data.function.parameters;
+                for(unsigned int i = 0; i < params.size(); i++)
+                {
+                    *out += (i == 0) ? "" : ", ";
+                    describe(params[i], out);
+                }
+                *out += ")";
+                break;
+            }
+            case TYPE_COMPOSITE:
+            {
+                *out += (type->data.composite->type == COMP_TYPE_UNION) ? "union" : "struct";
+                break;
+            }
+            default:
+            {
+                *out += NAMES[(type->type < sizeof(NAMES) / sizeof(NAMES[0])) ? type->type : 0];
+                break;
+            }
+        }
+    }
+
+    std::string describe(const Value& v)
+    {
+        std::string out;
+        if(v.type == nullptr)
+        {
+            out = "an initializer list";
+        }
+        else
+        {
+            describe(v.type, &out);
+            out.append(v.refs, '*');
+        }
+        return out;
+    }
+
+    std::string describe(const Type* type)
+    {
+        std::string out;
+        describe(type, &out);
+        return out;
+    }
+
+    // the operator as it is written, for diagnostics
+    const char* op_symbol(uint8_t op)
+    {
+        static const char* SYMBOLS[] =
+        {
+            "?", "+", "-", "*", "/", "%", "++", "--", "!", "&&", "||", "~", "^", "&", "|", "<<", ">>",
+            "==", "!=", "<", ">", "<=", ">=", "unary &", "unary *", "=", ".", "->", "[]"
+        };
+        return SYMBOLS[(op < EXPR_OP_COUNT) ? op : 0];
+    }
+
+    // enters decl and the composites declared among its fields into
+    // composites; returns a field name declared twice, or SYMBOL_NULL
+    uint32_t enter_composite(const Declaration* decl, std::unordered_map<const Composite*, const Declaration*>& composites)
+    {
+        uint32_t twice = SYMBOL_NULL;
+        composites[decl->data.composite.data] = decl;
+
+        std::vector<uint32_t> fields;
+        if(decl->data.composite.body != nullptr)
+        {
+            for(const Statement* stmt : *decl->data.composite.body)
+            {
+                if(stmt->type != STMT_DECLARATION)
+                {
+                    continue;
+                }
+
+                for(const Declaration* field : stmt->data.declarations)
+                {
+                    if(field->type == DECL_COMPOSITE)
+                    {
+                        uint32_t nested = enter_composite(field, composites);
+                        twice = (twice == SYMBOL_NULL) ? nested : twice;
+                    }
+                    else if(field->name != SYMBOL_NULL)
+                    {
+                        for(uint32_t name : fields)
+                        {
+                            twice = ((twice == SYMBOL_NULL) && (name == field->name)) ? name : twice;
+                        }
+                        fields.push_back(field->name);
+                    }
+                }
+            }
+        }
+
+        return twice;
+    }
+}
+
+// Checks one function body, or one global initializer, against the frozen
+// global table. Names declared inside go into a table of the body's own.
+class Analyzer::Body
+{
+private:
+    const Analyzer& m_analyzer;
+    std::string     m_context; // where diagnostics say they come from
+
+    const Type*       m_return_type; // nullptr outside of a function
+    SymbolTable       m_locals;
+    ConstantEvaluator m_constants;   // for case labels
+    std::unordered_map<const Composite*, const Declaration*> m_composites;
+
+    unsigned int m_loops;    // enclosing loops
+    unsigned int m_switches; // enclosing switches
+    unsigned int m_errors;
+
+private:
+    void error(const char* format, ...)
+    {
+        m_errors++;
+
+        Diagnostics::Print("error: in %s: ", m_context.c_str());
+
+        va_list args;
+        va_start(args, format);
+        Diagnostics::VPrint(format, args);
+        va_end(args);
+    }
+
+    const strptr& name(uint32_t id) const
+    {
+        return m_analyzer.m_ast->symbols->get(id);
+    }
+
+    const Type* primitive(uint8_t type) const
+    {
+        return m_analyzer.m_primitives[type];
+    }
+
+    const SymbolTable::Entry* lookup(uint32_t id) const
+    {
+        const SymbolTable::Entry* entry = m_locals.search(id);
+        return (entry != nullptr) ? entry : m_analyzer.m_globals.search(id);
+    }
+
+    const Declaration* find_composite(const Composite* composite) const
+    {
+        std::unordered_map<const Composite*, const Declaration*>::const_iterator it = m_composites.find(composite);
+        return (it != m_composites.end()) ? it->second : m_analyzer.find_composite(composite);
+    }
+
+    // the type of the named field of a composite type, or nullptr
+    const Type* find_field(const Type* type, uint32_t field) const
+    {
+        const Type* found = nullptr;
+
+        const Declaration* decl = find_composite(type->data.composite);
+        if((decl != nullptr) && (decl->data.composite.body != nullptr))
+        {
+            for(const Statement* stmt : *decl->data.composite.body)
+            {
+                if(stmt->type != STMT_DECLARATION)
+                {
+                    continue;
+                }
+
+                for(const Declaration* d : stmt->data.declarations)
+                {
+                    if((found == nullptr) && (d->type == DECL_VARIABLE) && (d->name == field))
+                    {
+                        found = d->data.variable.type;
+                    }
+                }
+            }
+        }
+
+        return found;
+    }
+
+    void declare(const SymbolTable::Entry& entry)
+    {
+        if(!m_locals.insert(entry))
+        {
+            const strptr& n = name(entry.name);
+            error("'%.*s' is already declared in this scope\n", n.len, n.ptr);
+        }
+    }
+
+    // the usual arithmetic conversions, as the constant evaluator applies them
+    Value arithmetic(const Value& lhs, const Value& rhs) const
+    {
+        Value v = { primitive(arithmetic_type(lhs.type->type, rhs.type->type)), 0, false, false };
+        return v;
+    }
+
+    Value literal(const Literal& literal) const
+    {
+        Value v = { nullptr, 0, false, false };
+        switch(literal.type)
+        {
+            case LITERAL_INTEGER:
+            {
+                v.type = primitive((literal.suffix != TK_TYPE_INVALID) ? literal.suffix : (uint8_t) TYPE_I32);
+                v.null = (literal.data.integer_value == 0);
+                break;
+            }
+            case LITERAL_FLOAT:
+            {
+                v.type = primitive((literal.suffix != TK_TYPE_INVALID) ? literal.suffix : (uint8_t) TYPE_F32);
+                break;
+            }
+            case LITERAL_STRING: { v.type = primitive(TYPE_U8); v.refs = 1; break; }
+            default:             { v.type = primitive(TYPE_U8); break; }
+        }
+        return v;
+    }
+
+    bool identifier(uint32_t id, Value* value)
+    {
+        bool status = true;
+
+        const SymbolTable::Entry* entry = lookup(id);
+        if(entry == nullptr)
+        {
+            const strptr& n = name(id);
+            error("'%.*s' is not declared\n", n.len, n.ptr);
+            status = false;
+        }
+        else
+        {
+            switch(entry->type)
+            {
+                case SYM_VARIABLE:   { *value = Value { entry->data_type, 0, true, false }; break; }
+                case SYM_FUNCTION:
+                case SYM_ENUMERATOR: { *value = Value { entry->data_type, 0, false, false }; break; }
+                default:
+                {
+                    const strptr& n = name(id);
+                    error("'%.*s' is not a value\n", n.len, n.ptr);
+                    status = false;
+                    break;
+                }
+            }
+        }
+
+        return status;
+    }
+
+    bool modifiable(const Value& v, uint8_t op)
+    {
+        bool ok = v.lvalue && (v.type != nullptr) && !v.type->flags.bits.is_constant;
+        if(!ok)
+        {
+            error("cannot apply %s to %s, which is not a modifiable lvalue\n", op_symbol(op), describe(v).c_str());
+        }
+        return ok;
+    }
+
+    bool operation(const Expression::Operation& operation, Value* value)
+    {
+        uint8_t op = operation.op;
+        bool field = (op == EXPR_OP_ACCESS_FIELD) || (op == EXPR_OP_ACCESS_FIELD_PTR);
+
+        // both operands are checked, so each reports its own errors
+        Value lhs = {};
+        Value rhs = {};
+        bool status = true;
+        if(operation.lhs != nullptr)
+        {
+            status = expression(operation.lhs, &lhs);
+        }
+        if((operation.rhs != nullptr) && !field)
+        {
+            status = expression(operation.rhs, &rhs) && status;
+        }
+
+        Value result = { nullptr, 0, false, false };
+        bool valid = true;
+
+        switch(status ? op : (uint8_t) EXPR_OP_INVALID)
+        {
+            case EXPR_OP_INVALID: { break; }
+            case EXPR_OP_ADD:
+            {
+                if(is_arithmetic(lhs) && is_arithmetic(rhs)) { result = arithmetic(lhs, rhs); }
+                else if(is_pointer(lhs) && is_integer(rhs))  { result = Value { lhs.type, lhs.refs, false, false }; }
+                else if(is_integer(lhs) && is_pointer(rhs))  { result = Value { rhs.type, rhs.refs, false, false }; }
+                else                                         { valid = false; }
+                break;
+            }
+            case EXPR_OP_SUB:
+            {
+                if(is_arithmetic(lhs) && is_arithmetic(rhs)) { result = arithmetic(lhs, rhs); }
+                else if(is_pointer(lhs) && is_integer(rhs))  { result = Value { lhs.type, lhs.refs, false, false }; }
+                else if(is_pointer(lhs) && is_pointer(rhs) && same_pointer(lhs, rhs))
+                {
+                    result = Value { primitive(TYPE_I64), 0, false, false };
+                }
+                else { valid = false; }
+                break;
+            }
+            case EXPR_OP_MUL:
+            case EXPR_OP_DIV:
+            {
+                valid = is_arithmetic(lhs) && is_arithmetic(rhs);
+                result = valid ? arithmetic(lhs, rhs) : result;
+                break;
+            }
+            case EXPR_OP_MOD:
+            case EXPR_OP_BITWISE_XOR:
+            case EXPR_OP_BITWISE_AND:
+            case EXPR_OP_BITWISE_OR:
+            {
+                valid = is_integer(lhs) && is_integer(rhs);
+                result = valid ? arithmetic(lhs, rhs) : result;
+                break;
+            }
+            case EXPR_OP_BITWISE_L_SHIFT:
+            case EXPR_OP_BITWISE_R_SHIFT:
+            {
+                valid = is_integer(lhs) && is_integer(rhs);
+                result = Value { lhs.type, 0, false, false };
+                break;
+            }
+            case EXPR_OP_LOGICAL_AND:
+            case EXPR_OP_LOGICAL_OR:
+            {
+                valid = is_scalar(lhs) && is_scalar(rhs);
+                result = Value { primitive(TYPE_I32), 0, false, false };
+                break;
+            }
+            case EXPR_OP_CMP_EQUAL:
+            case EXPR_OP_CMP_NOT_EQUAL:
+            case EXPR_OP_CMP_LESS_THAN:
+            case EXPR_OP_CMP_MORE_THAN:
+            case EXPR_OP_CMP_LESS_THAN_OR_EQUAL:
+            case EXPR_OP_CMP_MORE_THAN_OR_EQUAL:
+            {
+                valid = comparable(lhs, rhs);
+                result = Value { primitive(TYPE_I32), 0, false, false };
+                break;
+            }
+            case EXPR_OP_LOGICAL_NOT:
+            {
+                valid = is_scalar(rhs);
+                result = Value { primitive(TYPE_I32), 0, false, false };
+                break;
+            }
+            case EXPR_OP_BITWISE_COMPLEMENT:
+            {
+                valid = is_integer(rhs);
+                result = Value { rhs.type, 0, false, false };
+                break;
+            }
+            case EXPR_OP_INCREMENT:
+            case EXPR_OP_DECREMENT:
+            {
+                // prefix operators have only a right operand, postfix only a left one
+                const Value& operand = (operation.lhs != nullptr) ? lhs : rhs;
+                status = modifiable(operand, op);
+                valid = (is_arithmetic(operand) || is_pointer(operand));
+                result = Value { operand.type, operand.refs, false, false };
+                break;
+            }
+            case EXPR_OP_REFERENCE:
+            {
+                valid = rhs.lvalue || is_function(rhs);
+                result = Value { rhs.type, rhs.refs + 1, false, false };
+                break;
+            }
+            case EXPR_OP_DEREFERENCE:
+            {
+                // *f is f itself for a function
+                valid = (is_pointer(rhs) && !is_void(pointee(rhs))) || is_function(rhs);
+                result = is_function(rhs) ? rhs : (valid ? pointee(rhs) : result);
+                break;
+            }
+            case EXPR_OP_INDEX:
+            {
+                valid = is_pointer(lhs) && !is_void(pointee(lhs)) && is_integer(rhs);
+                result = valid ? pointee(lhs) : result;
+                break;
+            }
+            case EXPR_OP_ASSIGN:
+            {
+                status = modifiable(lhs, op);
+                if(status && (lhs.refs == 0) && !assignable(lhs.type, rhs))
+                {
+                    error("cannot assign %s to %s\n", describe(rhs).c_str(), describe(lhs).c_str());
+                    status = false;
+                }
+                result = Value { lhs.type, 0, false, false };
+                break;
+            }
+            case EXPR_OP_ACCESS_FIELD:
+            case EXPR_OP_ACCESS_FIELD_PTR:
+            {
+                Value composite = lhs;
+                if(op == EXPR_OP_ACCESS_FIELD_PTR)
+                {
+                    valid = is_pointer(lhs);
+                    composite = valid ? pointee(lhs) : composite;
+                }
+                valid = valid && (composite.type != nullptr) && (composite.refs == 0) && (composite.type->type == TYPE_COMPOSITE);
+
+                if(valid)
+                {
+                    uint32_t id = operation.rhs->data.identifier;
+                    const Type* type = find_field(composite.type, id);
+                    if(type == nullptr)
+                    {
+                        const strptr& n = name(id);
+                        error("%s has no field '%.*s'\n", describe(composite).c_str(), n.len, n.ptr);
+                        status = false;
+                    }
+                    result = Value { type, 0, composite.lvalue, false };
+                }
+                else
+                {
+                    error("%s of %s, which is not a %s\n", op_symbol(op), describe(lhs).c_str(),
+                          (op == EXPR_OP_ACCESS_FIELD) ? "struct or union" : "pointer to a struct or union");
+                    status = false;
+                    valid = true;
+                }
+                break;
+            }
+            default:
+            {
+                valid = false;
+                break;
+            }
+        }
+
+        if(!valid)
+        {
+            if((operation.lhs != nullptr) && (operation.rhs != nullptr))
+            {
+                error("invalid operands to %s: %s and %s\n", op_symbol(op), describe(lhs).c_str(), describe(rhs).c_str());
+            }
+            else
+            {
+                error("invalid operand to %s: %s\n", op_symbol(op), describe((operation.lhs != nullptr) ? lhs : rhs).c_str());
+            }
+            status = false;
+        }
+
+        if(status)
+        {
+            *value = result;
+        }
+
+        return status;
+    }
+
+    bool call(const Expression::Func_Call& call, Value* value)
+    {
+        Value callee = {};
+        bool status = expression(call.function, &callee);
+
+        // a function, or a pointer to one
+        const Type* signature = nullptr;
+        if(status)
+        {
+            if(is_function(callee))
+            {
+                signature = callee.type;
+            }
+            else if(is_pointer(callee) && is_function(pointee(callee)))
+            {
+                signature = pointee(callee).type;
+            }
+            else
+            {
+                error("%s is not a function or a pointer to one\n", describe(callee).c_str());
+                status = false;
+            }
+        }
+
+        unsigned int expected = 0;
+        if(signature != nullptr)
+        {
+            const List<Type>& params = signature->data.function.parameters;
+            expected = params.size();
+
+            // f(void) takes nothing
+            if((expected == 1) && (params[0]->type == TYPE_VOID))
+            {
+                expected = 0;
+            }
+        }
+
+        for(unsigned int i = 0; i < call.arguments.size(); i++)
+        {
+            Value arg = {};
+            if(!expression(call.arguments[i], &arg))
+            {
+                status = false;
+            }
+            else if((signature != nullptr) && (i < expected))
+            {
+                const Type* param = signature->data.function.parameters[i];
+                if(!assignable(param, arg))
+                {
+                    error("argument %u: cannot pass %s as %s\n", i + 1, describe(arg).c_str(), describe(param).c_str());
+                    status = false;
+                }
+            }
+        }
+
+        if((signature != nullptr) && (call.arguments.size() != expected))
+        {
+            error("%u arguments passed to %s, which takes %u\n", call.arguments.size(), describe(signature).c_str(), expected);
+            status = false;
+        }
+
+        if(status)
+        {
+            *value = Value { signature->data.function.return_type, 0, false, false };
+        }
+
+        return status;
+    }
+
+    bool cast(const Expression::Cast& cast, Value* value)
+    {
+        Value operand = {};
+        bool status = expression(cast.expr, &operand);
+
+        const Type* target = cast.type;
+        if(status)
+        {
+            bool valid = false;
+            switch(target->type)
+            {
+                case TYPE_VOID: { valid = true; break; }
+                case TYPE_PTR:  { valid = is_pointer(operand) || is_integer(operand) || is_function(operand); break; }
+                case TYPE_ARRAY:
+                case TYPE_FUNCTION:
+                case TYPE_COMPOSITE:
+                {
+                    break;
+                }
+                default:
+                {
+                    bool integer = (target->type != TYPE_F32) && (target->type != TYPE_F64);
+                    valid = is_arithmetic(operand) || (integer && is_pointer(operand));
+                    break;
+                }
+            }
+
+            if(!valid)
+            {
+                error("cannot cast %s to %s\n", describe(operand).c_str(), describe(target).c_str());
+                status = false;
+            }
+        }
+
+        if(status)
+        {
+            *value = Value { target, 0, false, false };
+        }
+
+        return status;
+    }
+
+    bool expression(const Expression* expr, Value* value)
+    {
+        bool status = true;
+        Value result = { nullptr, 0, false, false };
+
+        switch(expr->type)
+        {
+            case EXPR_SUB_EXPR:       { status = expression(expr->data.sub_expr, &result); break; }
+            case EXPR_LITERAL:        { result = literal(expr->data.literal); break; }
+            case EXPR_IDENTIFIER:     { status = identifier(expr->data.identifier, &result); break; }
+            case EXPR_OPERATION:      { status = operation(expr->data.operation, &result); break; }
+            case EXPR_FUNCTION_CALL:  { status = call(expr->data.func_call, &result); break; }
+            case EXPR_STATIC_CAST:
+            case EXPR_REINTERPRET_CAST:
+            {
+                status = cast(expr->data.cast, &result);
+                break;
+            }
+            case EXPR_INITIALIZER:
+            {
+                for(const Expression* item : expr->data.initializer)
+                {
+                    Value ignored = {};
+                    status = expression(item, &ignored) && status;
+                }
+                break;
+            }
+            case EXPR_COMPOUND_EXPR:
+            {
+                for(const Expression* item : expr->data.compound_expr)
+                {
+                    status = expression(item, &result) && status;
+                }
+                break;
+            }
+            default:
+            {
+                error("unknown expression\n");
+                status = false;
+                break;
+            }
+        }
+
+        if(status)
+        {
+            *value = result;
+        }
+
+        return status;
+    }
+
+    void condition(const Expression* expr, const char* statement)
+    {
+        Value v = {};
+        if(expression(expr, &v) && !is_scalar(v))
+        {
+            error("the condition of '%s' is %s\n", statement, describe(v).c_str());
+        }
+    }
+
+    void declaration(const Declaration* decl)
+    {
+        switch(decl->type)
+        {
+            case DECL_VARIABLE:
+            {
+                const Type* type = decl->data.variable.type;
+                if(type->type == TYPE_VOID)
+                {
+                    const strptr& n = name(decl->name);
+                    error("'%.*s' is declared void\n", n.len, n.ptr);
+                }
+
+                // the name is not in scope in its own initializer
+                if(decl->data.variable.value != nullptr)
+                {
+                    initializer(decl);
+                }
+
+                declare(SymbolTable::Entry { SYM_VARIABLE, decl->name, decl, type });
+                break;
+            }
+            case DECL_FUNCTION:
+            {
+                if(decl->data.function.body != nullptr)
+                {
+                    const strptr& n = name(decl->name);
+                    error("function '%.*s' is defined inside another function\n", n.len, n.ptr);
+                }
+                declare(SymbolTable::Entry { SYM_FUNCTION, decl->name, decl, decl->data.function.type });
+                break;
+            }
+            case DECL_COMPOSITE:
+            {
+                uint32_t twice = enter_composite(decl, m_composites);
+                if(twice != SYMBOL_NULL)
+                {
+                    const strptr& n = name(twice);
+                    error("field '%.*s' is declared twice\n", n.len, n.ptr);
+                }
+                if(decl->name != SYMBOL_NULL)
+                {
+                    declare(SymbolTable::Entry { SYM_COMPOSITE, decl->name, decl, nullptr });
+                }
+                break;
+            }
+            case DECL_ENUMERATOR:
+            {
+                const Type* type = primitive(TYPE_I32);
+                for(const Enumerator::Value* value : *decl->data.enumerator.body)
+                {
+                    declare(SymbolTable::Entry { SYM_ENUMERATOR, value->name, decl, type });
+                }
+                break;
+            }
+            default: { break; }
+        }
+    }
+
+    void statements(const List<Statement>& list)
+    {
+        for(const Statement* stmt : list)
+        {
+            statement(stmt);
+        }
+    }
+
+    void statement(const Statement* stmt)
+    {
+        switch(stmt->type)
+        {
+            case STMT_EXPR:
+            {
+                Value ignored = {};
+                expression(stmt->data.expr, &ignored);
+                break;
+            }
+            case STMT_IF:
+            {
+                condition(stmt->data.cond_exec.condition, "if");
+                statement(stmt->data.cond_exec.on_true);
+                if(stmt->data.cond_exec.on_false != nullptr)
+                {
+                    statement(stmt->data.cond_exec.on_false);
+                }
+                break;
+            }
+            case STMT_WHILE:
+            {
+                condition(stmt->data.while_loop.cond, "while");
+                m_loops++;
+                statement(stmt->data.while_loop.body);
+                m_loops--;
+                break;
+            }
+            case STMT_FOR:
+            {
+                // the declarations of the init statement are local to the loop
+                m_locals.push();
+                if(stmt->data.for_loop.init != nullptr)
+                {
+                    statement(stmt->data.for_loop.init);
+                }
+                if(stmt->data.for_loop.cond != nullptr)
+                {
+                    condition(stmt->data.for_loop.cond, "for");
+                }
+                if(stmt->data.for_loop.step != nullptr)
+                {
+                    Value ignored = {};
+                    expression(stmt->data.for_loop.step, &ignored);
+                }
+                m_loops++;
+                statement(stmt->data.for_loop.body);
+                m_loops--;
+                m_locals.pop();
+                break;
+            }
+            case STMT_BLOCK:
+            {
+                m_locals.push();
+                statements(stmt->data.block.statements);
+                m_locals.pop();
+                break;
+            }
+            case STMT_RETURN:
+            {
+                returned(stmt->data.ret_stmt.expression);
+                break;
+            }
+            case STMT_DECLARATION:
+            {
+                for(const Declaration* decl : stmt->data.declarations)
+                {
+                    declaration(decl);
+                }
+                break;
+            }
+            case STMT_TYPEDEF:
+            {
+                declare(SymbolTable::Entry { SYM_TYPEDEF, stmt->data.type_def.name, nullptr, stmt->data.type_def.type });
+                break;
+            }
+            case STMT_BREAK:
+            {
+                if((m_loops == 0) && (m_switches == 0))
+                {
+                    error("'break' outside of a loop or switch\n");
+                }
+                break;
+            }
+            case STMT_CONTINUE:
+            {
+                if(m_loops == 0)
+                {
+                    error("'continue' outside of a loop\n");
+                }
+                break;
+            }
+            case STMT_SWITCH:
+            {
+                Value v = {};
+                if(expression(stmt->data.switch_stmt.expr, &v) && !is_integer(v))
+                {
+                    error("switch on %s, which is not an integer\n", describe(v).c_str());
+                }
+                m_switches++;
+                statement(stmt->data.switch_stmt.body);
+                m_switches--;
+                break;
+            }
+            case STMT_CASE:
+            case STMT_DEFAULT_CASE:
+            {
+                if(m_switches == 0)
+                {
+                    error("'%s' outside of a switch\n", (stmt->type == STMT_CASE) ? "case" : "default");
+                }
+                Value v = {};
+                Constant c = {};
+                const char* reason = nullptr;
+                if((stmt->type == STMT_CASE) && expression(stmt->data.case_stmt.value, &v))
+                {
+                    if(!is_integer(v))
+                    {
+                        error("case label of %s, which is not an integer\n", describe(v).c_str());
+                    }
+                    else if(!m_constants.evaluate(stmt->data.case_stmt.value, &m_locals, &c, &reason))
+                    {
+                        error("case label is not constant: %s\n", reason);
+                    }
+                }
+                break;
+            }
+            default: { break; }
+        }
+    }
+
+    void returned(const Expression* expr)
+    {
+        bool returns_void = (m_return_type->type == TYPE_VOID);
+
+        Value v = {};
+        if(expr == nullptr)
+        {
+            if(!returns_void)
+            {
+                error("'return' without a value in a function returning %s\n", describe(m_return_type).c_str());
+            }
+        }
+        else if(expression(expr, &v))
+        {
+            if(returns_void && !is_void(v))
+            {
+                error("'return' with a value in a function returning void\n");
+            }
+            else if(!returns_void && !assignable(m_return_type, v))
+            {
+                error("cannot return %s from a function returning %s\n", describe(v).c_str(), describe(m_return_type).c_str());
+            }
+        }
+    }
+
+    void initializer(const Declaration* decl)
+    {
+        Value v = {};
+        const Type* type = decl->data.variable.type;
+        if(expression(decl->data.variable.value, &v) && !assignable(type, v))
+        {
+            const strptr& n = name(decl->name);
+            error("cannot initialize '%.*s' of type %s with %s\n", n.len, n.ptr, describe(type).c_str(), describe(v).c_str());
+        }
+    }
+
+public:
+    Body(const Analyzer& analyzer, const char* kind, uint32_t id) : m_analyzer(analyzer), m_constants(&analyzer.m_globals)
+    {
+        const strptr& n = name(id);
+        m_context = std::string(kind) + " '" + std::string(n.ptr, n.len) + "'";
+
+        m_return_type = nullptr;
+        m_loops = 0;
+        m_switches = 0;
+        m_errors = 0;
+    }
+
+    void check_function(const Declaration* decl)
+    {
+        const Type* type = decl->data.function.type;
+        m_return_type = type->data.function.return_type;
+
+        // the parameters share the scope of the body's outermost block
+        for(const Function::Parameter* param : *decl->data.function.parameters)
+        {
+            if(param->name != SYMBOL_NULL)
+            {
+                if(param->type->type == TYPE_VOID)
+                {
+                    const strptr& n = name(param->name);
+                    error("parameter '%.*s' is declared void\n", n.len, n.ptr);
+                }
+                declare(SymbolTable::Entry { SYM_VARIABLE, param->name, nullptr, param->type });
+            }
+        }
+
+        statements(*decl->data.function.body);
+    }
+
+    void check_variable(const Declaration* decl)
+    {
+        initializer(decl);
+    }
+
+    unsigned int errors() const
+    {
+        return m_errors;
+    }
+};
+
+Analyzer::Analyzer(const AST* ast)
+{
+    m_ast = ast;
+    m_errors = 0;
+
+    m_primitives[TYPE_INVALID] = nullptr;
+    for(uint8_t type = TYPE_VOID; type <= TYPE_F64; type++)
+    {
+        m_primitives[type] = ast->types->primitive(type, Type::Flags {});
+    }
+}
+
+void Analyzer::error(const char* format, ...)
+{
+    m_errors++;
+
+    Diagnostics::Print("error: ");
+
+    va_list args;
+    va_start(args, format);
+    Diagnostics::VPrint(format, args);
+    va_end(args);
+}
+
+const Declaration* Analyzer::find_composite(const Composite* composite) const
+{
+    std::unordered_map<const Composite*, const Declaration*>::const_iterator it = m_composites.find(composite);
+    return (it != m_composites.end()) ? it->second : nullptr;
+}
+
+void Analyzer::collect(const Statement* stmt)
+{
+    switch(stmt->type)
+    {
+        case STMT_DECLARATION:
+        {
+            for(const Declaration* decl : stmt->data.declarations)
+            {
+                collect(decl);
+            }
+            break;
+        }
+        case STMT_TYPEDEF:
+        {
+            const strptr& name = m_ast->symbols->get(stmt->data.type_def.name);
+            if(!m_globals.insert(SymbolTable::Entry { SYM_TYPEDEF, stmt->data.type_def.name, nullptr, stmt->data.type_def.type }))
+            {
+                error("'%.*s' is already declared\n", name.len, name.ptr);
+            }
+            break;
+        }
+        default:
+        {
+            error("statements other than declarations must be inside a function\n");
+            break;
+        }
+    }
+}
+
+void Analyzer::collect(const Declaration* decl)
+{
+    const strptr& name = m_ast->symbols->get(decl->name);
+
+    switch(decl->type)
+    {
+        case DECL_VARIABLE:
+        {
+            if(decl->data.variable.type->type == TYPE_VOID)
+            {
+                error("global '%.*s' is declared void\n", name.len, name.ptr);
+            }
+            else if(!m_globals.insert(SymbolTable::Entry { SYM_VARIABLE, decl->name, decl, decl->data.variable.type }))
+            {
+                error("'%.*s' is already declared\n", name.len, name.ptr);
+            }
+            else if(decl->data.variable.value != nullptr)
+            {
+                m_variables.push_back(decl);
+            }
+            break;
+        }
+        case DECL_FUNCTION:
+        {
+            // a function may be declared any number of times but defined once
+            const Type* type = decl->data.function.type;
+            bool defined = (decl->data.function.body != nullptr);
+
+            const SymbolTable::Entry* previous = m_globals.search(decl->name);
+            if(previous == nullptr)
+            {
+                m_globals.insert(SymbolTable::Entry { SYM_FUNCTION, decl->name, decl, type });
+            }
+            else if((previous->type != SYM_FUNCTION) || !same_type(previous->data_type, type))
+            {
+                error("'%.*s' is redeclared as %s\n", name.len, name.ptr, describe(type).c_str());
+                defined = false;
+            }
+            else if(defined && (m_defined.count(decl->name) > 0))
+            {
+                error("function '%.*s' is defined twice\n", name.len, name.ptr);
+                defined = false;
+            }
+
+            if(defined)
+            {
+                m_defined.insert(decl->name);
+                m_functions.push_back(decl);
+            }
+            break;
+        }
+        case DECL_COMPOSITE:
+        {
+            uint32_t twice = enter_composite(decl, m_composites);
+            if(twice != SYMBOL_NULL)
+            {
+                const strptr& field = m_ast->symbols->get(twice);
+                error("field '%.*s' is declared twice\n", field.len, field.ptr);
+            }
+
+            if((decl->name != SYMBOL_NULL) && !m_globals.insert(SymbolTable::Entry { SYM_COMPOSITE, decl->name, decl, nullptr }))
+            {
+                error("'%.*s' is already declared\n", name.len, name.ptr);
+            }
+            break;
+        }
+        case DECL_ENUMERATOR:
+        {
+            for(const Enumerator::Value* value : *decl->data.enumerator.body)
+            {
+                if(!m_globals.insert(SymbolTable::Entry { SYM_ENUMERATOR, value->name, decl, m_primitives[TYPE_I32] }))
+                {
+                    const strptr& enumerator = m_ast->symbols->get(value->name);
+                    error("'%.*s' is already declared\n", enumerator.len, enumerator.ptr);
+                }
+            }
+            break;
+        }
+        default: { break; }
+    }
+}
+
+bool Analyzer::Analyze(const AST* ast, ThreadPool* pool, Stats* stats)
+{
+    Analyzer analyzer(ast);
+
+    for(const Statement* stmt : ast->statements)
+    {
+        analyzer.collect(stmt);
+    }
+
+    // initializers may refer to any global, so they wait until all are in
+    for(const Declaration* decl : analyzer.m_variables)
+    {
+        Body body(analyzer, "the initializer of", decl->name);
+        body.check_variable(decl);
+        analyzer.m_errors += body.errors();
+    }
+
+    // from here on the global table is only read
+    unsigned int count = (unsigned int) analyzer.m_functions.size();
+    if((pool != nullptr) && (pool->size() > 1) && (count > 1))
+    {
+        // a job per slice of consecutive bodies keeps the queue short on
+        // files with thousands of functions, and a slice's diagnostics are
+        // already in source order
+        unsigned int slices = (count < pool->size() * 8) ? count : pool->size() * 8;
+        std::vector<std::string> diagnostics(slices);
+        std::vector<unsigned int> errors(slices, 0);
+
+        pool->run(slices, [&](unsigned int slice) {
+            Diagnostics::Capture(&diagnostics[slice]);
+            for(unsigned int i = slice * count / slices; i < (slice + 1) * count / slices; i++)
+            {
+                Body body(analyzer, "function", analyzer.m_functions[i]->name);
+                body.check_function(analyzer.m_functions[i]);
+                errors[slice] += body.errors();
+            }
+            Diagnostics::Release();
+        });
+
+        for(unsigned int slice = 0; slice < slices; slice++)
+        {
+            if(!diagnostics[slice].empty())
+            {
+                Diagnostics::Print("%s", diagnostics[slice].c_str());
+            }
+            analyzer.m_errors += errors[slice];
+        }
+    }
+    else
+    {
+        for(const Declaration* decl : analyzer.m_functions)
+        {
+            Body body(analyzer, "function", decl->name);
+            body.check_function(decl);
+            analyzer.m_errors += body.errors();
+        }
+    }
+
+    if(stats != nullptr)
+    {
+        stats->globals = analyzer.m_globals.size();
+        stats->functions = count;
+        stats->errors = analyzer.m_errors;
+    }
+
+    return analyzer.m_errors == 0;
+}
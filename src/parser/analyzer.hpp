@@ -0,0 +1,65 @@
+#ifndef ANALYZER_HPP
+#define ANALYZER_HPP
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <ast.hpp>
+#include <symbol_table.hpp>
+#include <thread_pool.hpp>
+
+// Semantic analysis of one AST, in two parts. A sequential pass enters every
+// global variable, function, composite, typedef and enumerator into the
+// global symbol table and checks the global initializers against it. The
+// table is frozen after that and the function bodies are type-checked
+// independently of each other, on a thread pool when one is given: a body
+// has a scoped table of its own that falls back to the global one, so the
+// workers only ever read shared state. Each body's diagnostics are captured
+// while it is checked and printed in source order once all are done, so the
+// output is the same for any number of threads.
+//
+// The tree carries no source positions, so diagnostics name the function or
+// global they were found in.
+class Analyzer
+{
+public:
+    struct Stats
+    {
+        unsigned int globals;   // names in the global table
+        unsigned int functions; // bodies checked
+        unsigned int errors;
+    };
+
+private:
+    class Body;
+
+    const AST*  m_ast;
+    SymbolTable m_globals;
+    std::unordered_map<const Composite*, const Declaration*> m_composites;
+
+    std::vector<const Declaration*> m_variables; // globals with an initializer
+    std::vector<const Declaration*> m_functions; // with a body, in source order
+    std::unordered_set<uint32_t>    m_defined;   // names of those functions
+
+    const Type* m_primitives[TYPE_F64 + 1]; // without flags
+    unsigned int m_errors;
+
+private:
+    Analyzer(const AST* ast);
+
+    void error(const char* format, ...);
+
+    void collect(const Statement* stmt);
+    void collect(const Declaration* decl);
+
+    // the declaration of the composite, or nullptr
+    const Declaration* find_composite(const Composite* composite) const;
+
+public:
+    // false if anything is wrong; pool may be nullptr to check the bodies on
+    // the calling thread
+    static bool Analyze(const AST* ast, ThreadPool* pool, Stats* stats = nullptr);
+};
+
+#endif // ANALYZER_HPP
@@ -1,6 +1,42 @@
 #include <ast.hpp>
 
+#include <type_context.hpp>
+
 void delete_ast(AST* ast)
 {
-    // TODO
+    // the nodes all live in the arena, which goes with the AST
+    delete ast->types;
+    delete ast;
+}
+
+const char* op_name(uint8_t op)
+{
+    const char* name = "?";
+    switch(op)
+    {
+        case EXPR_OP_ADD:                    { name = "ADD";       break; }
+        case EXPR_OP_SUB:                    { name = "SUB";       break; }
+        case EXPR_OP_MUL:                    { name = "MUL";       break; }
+        case EXPR_OP_DIV:                    { name = "DIV";       break; }
+        case EXPR_OP_MOD:                    { name = "MOD";       break; }
+        case EXPR_OP_LOGICAL_AND:            { name = "AND";       break; }
+        case EXPR_OP_LOGICAL_OR:             { name = "OR";        break; }
+        case EXPR_OP_BITWISE_XOR:            { name = "BIT-XOR";   break; }
+        case EXPR_OP_BITWISE_AND:            { name = "BIT-AND";   break; }
+        case EXPR_OP_BITWISE_OR:             { name = "BIT-OR";    break; }
+        case EXPR_OP_BITWISE_L_SHIFT:        { name = "L-SHIFT";   break; }
+        case EXPR_OP_BITWISE_R_SHIFT:        { name = "R-SHIFT";   break; }
+        case EXPR_OP_CMP_EQUAL:              { name = "EQ";        break; }
+        case EXPR_OP_CMP_NOT_EQUAL:          { name = "NEQ";       break; }
+        case EXPR_OP_CMP_LESS_THAN:          { name = "LT";        break; }
+        case EXPR_OP_CMP_MORE_THAN:          { name = "GT";        break; }
+        case EXPR_OP_CMP_LESS_THAN_OR_EQUAL: { name = "LTEQ";      break; }
+        case EXPR_OP_CMP_MORE_THAN_OR_EQUAL: { name = "GTEQ";      break; }
+        case EXPR_OP_ASSIGN:                 { name = "ASSIGN";    break; }
+        case EXPR_OP_ACCESS_FIELD:           { name = "FIELD";     break; }
+        case EXPR_OP_ACCESS_FIELD_PTR:       { name = "PTR-FIELD"; break; }
+        case EXPR_OP_INDEX:                  { name = "INDEX";     break; }
+        default: { break; }
+    }
+    return name;
 }
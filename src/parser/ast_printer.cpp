@@ -1,6 +1,7 @@
 #include <ast_printer.hpp>
 
 #include <stdarg.h>
+#include <stdio.h>
 
 #include <ascii.hpp>
 
@@ -11,8 +12,9 @@ const char* TAB_STR[] =
     " +-- "
 };
 
-AST_Printer::AST_Printer()
+AST_Printer::AST_Printer(const Interner* symbols)
 {
+    m_symbols = symbols;
 }
 
 void AST_Printer::print(const char* format, ...)
@@ -143,9 +145,10 @@ void AST_Printer::print_body(unsigned int indent, const List<Statement>* body)
 {
     m_tab_stack.push_back(indent);
 
-    for(List<Statement>::Element* it = body->head; it != nullptr; it = it->next)
+    unsigned int count = body->size();
+    for(unsigned int i = 0; i < count; i++)
     {
-        print_statement((it->next == nullptr) ? TAB::SPACE : TAB::LINE, it->ptr);
+        print_statement((i + 1 == count) ? TAB::SPACE : TAB::LINE, (*body)[i]);
     }
 
     m_tab_stack.pop_back();
@@ -159,7 +162,7 @@ void AST_Printer::print_expr(unsigned int indent, const Expression* expr)
     }
     else if(expr->type == EXPR_IDENTIFIER)
     {
-        print_identifier(TAB::SPACE, &expr->data.identifier);
+        print_identifier(TAB::SPACE, expr->data.identifier);
     }
     else
     {
@@ -175,51 +178,50 @@ void AST_Printer::print_expr(unsigned int indent, const Expression* expr)
             print("SUB-EXPR:\n");
             print_expr(TAB::SPACE, expr->data.sub_expr);
         }
+        else if(expr->type == EXPR_STATIC_CAST)
+        {
+            print("CAST:\n");
+            m_tab_stack.push_back(TAB::SPACE);
+
+            print("TYPE:\n");
+            print_type(TAB::LINE, expr->data.cast.type);
+            print("EXPR:\n");
+            print_expr(TAB::SPACE, expr->data.cast.expr);
+
+            m_tab_stack.pop_back();
+        }
         else if(expr->type == EXPR_OPERATION)
         {
             const Expression::Operation* op = &expr->data.operation;
-            if(op->op == EXPR_OP_INCREMENT)
+            if((op->op == EXPR_OP_INCREMENT) || (op->op == EXPR_OP_DECREMENT))
             {
-                const Expression* lhs = expr->data.operation.lhs;
-                const Expression* rhs = expr->data.operation.rhs;
-                if(lhs != nullptr)
+                const char* name = (op->op == EXPR_OP_INCREMENT) ? "INCREMENT" : "DECREMENT";
+                if(op->lhs != nullptr)
                 {
-                    print("POST-INCREMENT:\n");
-                    print_expr(TAB::SPACE, lhs);
+                    print("POST-%s:\n", name);
+                    print_expr(TAB::SPACE, op->lhs);
                 }
                 else
                 {
-                    print("PRE-INCREMENT:\n");
-                    print_expr(TAB::SPACE, rhs);
+                    print("PRE-%s:\n", name);
+                    print_expr(TAB::SPACE, op->rhs);
                 }
             }
-            else if(op->op == EXPR_OP_DEREFERENCE)
-            {
-                print("DEREFERENCE:\n");
-                print_expr_operation(TAB::SPACE, expr->data.operation.rhs);
-            }
-            else if(op->op == EXPR_OP_REFERENCE)
-            {
-                print("REFERENCE:\n");
-                print_expr_operation(TAB::SPACE, expr->data.operation.rhs);
-            }
-            else
+            else if(op->lhs == nullptr)
             {
                 switch(op->op)
                 {
-                    case EXPR_OP_ADD: { print("ADD:\n"); break; }
-                    case EXPR_OP_SUB: { print("SUB:\n"); break; }
-                    case EXPR_OP_MUL: { print("MUL:\n"); break; }
-                    case EXPR_OP_DIV: { print("DIV:\n"); break; }
-                    case EXPR_OP_ASSIGN: { print("ASSIGN:\n"); break; }
-                    case EXPR_OP_CMP_EQUAL: { print("EQ:\n"); break; }
-                    case EXPR_OP_CMP_NOT_EQUAL: { print("NEQ:\n"); break; }
-                    case EXPR_OP_CMP_LESS_THAN: { print("LT:\n"); break; }
-                    case EXPR_OP_CMP_MORE_THAN: { print("GT:\n"); break; }
-                    case EXPR_OP_CMP_LESS_THAN_OR_EQUAL: { print("LTEQ:\n"); break; }
-                    case EXPR_OP_CMP_MORE_THAN_OR_EQUAL: { print("GTEQ:\n"); break; }
+                    case EXPR_OP_DEREFERENCE:        { print("DEREFERENCE:\n"); break; }
+                    case EXPR_OP_REFERENCE:          { print("REFERENCE:\n"); break; }
+                    case EXPR_OP_LOGICAL_NOT:        { print("NOT:\n"); break; }
+                    case EXPR_OP_BITWISE_COMPLEMENT: { print("COMPLEMENT:\n"); break; }
                 }
-                print_expr_operation(TAB::SPACE, expr->data.operation.lhs, expr->data.operation.rhs);
+                print_expr_operation(TAB::SPACE, op->rhs);
+            }
+            else
+            {
+                print("%s:\n", op_name(op->op));
+                print_expr_operation(TAB::SPACE, op->lhs, op->rhs);
             }
         }
         
@@ -249,6 +251,15 @@ void AST_Printer::print_expr_operation(unsigned int indent, const Expression* lh
     m_tab_stack.pop_back();
 }
 
+void AST_Printer::print_suffix(uint8_t suffix)
+{
+    if(suffix != TK_TYPE_INVALID)
+    {
+        printf(" %s", type_name(suffix));
+    }
+    printf("\n");
+}
+
 void AST_Printer::print_literal(unsigned int indent, const Literal* literal)
 {
     m_tab_stack.push_back(indent);
@@ -257,12 +268,22 @@ void AST_Printer::print_literal(unsigned int indent, const Literal* literal)
     {
         case LITERAL_INTEGER:
         {
-            print("INTEGER: %llu\n", literal->data.integer_value);
+            // folded constants of the signed types can be negative
+            if((literal->suffix >= TK_TYPE_I8) && (literal->suffix <= TK_TYPE_I64))
+            {
+                print("INTEGER: %lld", (long long) literal->data.integer_value);
+            }
+            else
+            {
+                print("INTEGER: %llu", (unsigned long long) literal->data.integer_value);
+            }
+            print_suffix(literal->suffix);
             break;
         }
         case LITERAL_FLOAT:
         {
-            print("FLOAT: %f\n", literal->data.float_value);
+            print("FLOAT: %f", literal->data.float_value);
+            print_suffix(literal->suffix);
             break;
         }
         case LITERAL_CHAR:
@@ -299,47 +320,51 @@ void AST_Printer::print_func_call(unsigned int indent, const Expression::Func_Ca
 
     print("ARGUMENTS:\n");
     m_tab_stack.push_back(TAB::SPACE);
-    for(List<Expression>::Element* it = f_call->arguments.head; it != nullptr; it = it->next)
+    unsigned int count = f_call->arguments.size();
+    for(unsigned int i = 0; i < count; i++)
     {
         print("ARG\n");
-        print_expr((it->next == nullptr) ? TAB::SPACE : TAB::LINE, it->ptr);
+        print_expr((i + 1 == count) ? TAB::SPACE : TAB::LINE, f_call->arguments[i]);
     }
 
     m_tab_stack.pop_back();
     m_tab_stack.pop_back();
 }
 
-void AST_Printer::print_parameter(unsigned int indent, const Function::Parameter* param)
+void AST_Printer::print_parameter(unsigned int indent, uint32_t name, const Type* type)
 {
     m_tab_stack.push_back(indent);
 
-    print("NAME: %s\n", (param->name.len > 0) ? param->name.ptr : "NULL");
+    print_name(name);
     print("DATATYPE:\n");
-    print_type(TAB::SPACE, param->type);
+    print_type(TAB::SPACE, type);
 
     m_tab_stack.pop_back();
 }
 
-void AST_Printer::print_parameter_list(unsigned int indent, const List<Function::Parameter>* list)
+void AST_Printer::print_parameter_list(unsigned int indent, const List<Type>* list, const List<Function::Parameter>* names)
 {
     m_tab_stack.push_back(indent);
 
-    for (List<Function::Parameter>::Element* it = list->head; it != nullptr; it = it->next)
+    unsigned int count = list->size();
+    for (unsigned int i = 0; i < count; i++)
     {
         print("PARAM:\n");
-        print_parameter((it->next == nullptr) ? TAB::SPACE : TAB::LINE, it->ptr);
+        uint32_t name = (names != nullptr) ? (*names)[i]->name : SYMBOL_NULL;
+        print_parameter((i + 1 == count) ? TAB::SPACE : TAB::LINE, name, (*list)[i]);
     }
 
     m_tab_stack.pop_back();
 }
 
-void AST_Printer::print_identifier(unsigned int indent, const strptr* id)
+void AST_Printer::print_identifier(unsigned int indent, uint32_t id)
 {
     m_tab_stack.push_back(indent);
 
-    if(id->len > 0)
+    if(id != SYMBOL_NULL)
     {
-        print("IDENTIFIER: %.*s\n", id->len, id->ptr);
+        const strptr& name = m_symbols->get(id);
+        print("IDENTIFIER: %.*s\n", name.len, name.ptr);
     }
     else
     {
@@ -349,14 +374,34 @@ void AST_Printer::print_identifier(unsigned int indent, const strptr* id)
     m_tab_stack.pop_back();
 }
 
+void AST_Printer::print_name(uint32_t id)
+{
+    if(id != SYMBOL_NULL)
+    {
+        const strptr& name = m_symbols->get(id);
+        print("NAME: %.*s\n", name.len, name.ptr);
+    }
+    else
+    {
+        print("NAME: NULL\n");
+    }
+}
+
 void AST_Printer::print_array(unsigned int indent, const Type::Array* array)
 {
     m_tab_stack.push_back(indent);
 
     print("DATATYPE:\n");
     print_type(TAB::LINE, array->elements);
-    print("SIZE:\n");
-    print_expr(TAB::SPACE, array->size);
+    if(array->size != nullptr)
+    {
+        print("SIZE:\n");
+        print_expr(TAB::SPACE, array->size);
+    }
+    else
+    {
+        print("SIZE: NONE\n");
+    }
 
     m_tab_stack.pop_back();
 }
@@ -377,7 +422,7 @@ void AST_Printer::print_type_flags(unsigned int indent, const Type::Flags* flags
     m_tab_stack.pop_back();
 }
 
-void AST_Printer::print_type(unsigned int indent, const Type* type)
+void AST_Printer::print_type(unsigned int indent, const Type* type, const List<Function::Parameter>* names)
 {
     m_tab_stack.push_back(indent);
 
@@ -424,14 +469,14 @@ void AST_Printer::print_type(unsigned int indent, const Type* type)
             print("RETURN:\n");
             print_type(TAB::LINE, type->data.function.return_type);
 
-            if(type->data.function.parameters.count == 0)
+            if(type->data.function.parameters.empty())
             {
                 print("PARAMS: NONE\n");
             }
             else
             {
                 print("PARAMS:\n");
-                print_parameter_list(TAB::SPACE, &type->data.function.parameters);
+                print_parameter_list(TAB::SPACE, &type->data.function.parameters, names);
             }
 
             m_tab_stack.pop_back();
@@ -449,10 +494,8 @@ void AST_Printer::print_type(unsigned int indent, const Type* type)
 
 void AST_Printer::print_decl_list(unsigned int indent, const List<Declaration>* decl_list)
 {
-    for (List<Declaration>::Element* it = decl_list->head; it != nullptr; it = it->next)
+    for (Declaration* decl : *decl_list)
     {
-        Declaration* decl = it->ptr;
-
         switch(decl->type)
         {
             case DECL_VARIABLE:
@@ -487,7 +530,7 @@ void AST_Printer::print_decl_variable(unsigned int indent, const Declaration* de
 {
     m_tab_stack.push_back(indent);
 
-    print("NAME: %.*s\n", decl->name.len, decl->name.ptr);
+    print_name(decl->name);
 
     bool init_value = (decl->data.variable.value != nullptr);
 
@@ -511,10 +554,10 @@ void AST_Printer::print_decl_function(unsigned int indent, const Declaration* de
 {
     m_tab_stack.push_back(indent);
     
-    print("NAME: %.*s\n", decl->name.len, decl->name.ptr);
+    print_name(decl->name);
 
     print("TYPE:\n");
-    print_type(TAB::LINE, decl->data.function.type);
+    print_type(TAB::LINE, decl->data.function.type, decl->data.function.parameters);
 
     if(decl->data.function.body == nullptr)
     {
@@ -533,7 +576,7 @@ void AST_Printer::print_decl_composite(unsigned int indent, const Declaration* d
 {
     m_tab_stack.push_back(indent);
 
-    print("NAME: %.*s\n", decl->name.len, decl->name.ptr);
+    print_name(decl->name);
 
     m_tab_stack.pop_back();
 }
@@ -542,18 +585,19 @@ void AST_Printer::print_decl_enumerator(unsigned int indent, const Declaration*
 {
     m_tab_stack.push_back(indent);
 
-    print("NAME: %.*s\n", decl->name.len, decl->name.ptr);
+    print_name(decl->name);
 
     m_tab_stack.pop_back();
 }
 
 void AST_Printer::Print(const AST* ast)
 {
-    AST_Printer printer;
+    AST_Printer printer(ast->symbols);
 
     printf("AST:\n");
-    for (List<Statement>::Element* it = ast->statements.head; it != nullptr; it = it->next)
+    unsigned int count = ast->statements.size();
+    for (unsigned int i = 0; i < count; i++)
     {
-        printer.print_statement((it->next == nullptr) ? TAB::SPACE : TAB::LINE, it->ptr);
+        printer.print_statement((i + 1 == count) ? TAB::SPACE : TAB::LINE, ast->statements[i]);
     }
 }
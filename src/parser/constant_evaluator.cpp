@@ -0,0 +1,1288 @@
+#include <constant_evaluator.hpp>
+
+#include <math.h>
+
+#include <diagnostics.hpp>
+#include <type_context.hpp>
+
+namespace
+{
+    enum CONST_STATUS
+    {
+        CONST_OK             = 0x0,
+        CONST_NOT_CONSTANT   = 0x1,
+        CONST_DIVIDE_BY_ZERO = 0x2,
+        CONST_OVERFLOW       = 0x3, // of a signed type
+        CONST_SHIFT_RANGE    = 0x4,
+        CONST_RANGE          = 0x5, // a value that does not fit its type
+        CONST_CYCLE          = 0x6,
+        CONST_PENDING        = 0x7  // being evaluated, only ever seen by a cycle
+    };
+
+    const char* MESSAGES[] =
+    {
+        "no error",
+        "not a constant expression",
+        "division by zero",
+        "signed overflow",
+        "shift count out of range",
+        "value out of range of its type",
+        "refers to a constant defined in terms of itself",
+        "still being evaluated"
+    };
+
+    // bytes of each primitive TYPE_*
+    const unsigned int WIDTH[] = { 0, 0, 1, 2, 4, 8, 1, 2, 4, 8, 4, 8 };
+
+    bool is_signed(uint8_t type)
+    {
+        return (type >= TYPE_I8) && (type <= TYPE_I64);
+    }
+
+    bool is_float(uint8_t type)
+    {
+        return (type == TYPE_F32) || (type == TYPE_F64);
+    }
+
+    bool is_integer(uint8_t type)
+    {
+        return (type >= TYPE_U8) && (type <= TYPE_I64);
+    }
+
+    bool is_arithmetic(uint8_t type)
+    {
+        return (type >= TYPE_U8) && (type <= TYPE_F64);
+    }
+
+    // truncates to the width of the type and sign-extends the signed ones
+    uint64_t normalize(uint8_t type, uint64_t value)
+    {
+        unsigned int bits = WIDTH[type] * 8;
+        if(bits < 64)
+        {
+            uint64_t mask = (1ull << bits) - 1;
+            value &= mask;
+            if(is_signed(type) && ((value >> (bits - 1)) & 1))
+            {
+                value |= ~mask;
+            }
+        }
+        return value;
+    }
+
+    bool fits(uint8_t type, int64_t value)
+    {
+        unsigned int bits = WIDTH[type] * 8;
+        return (bits == 64) || ((value >= -(1ll << (bits - 1))) && (value < (1ll << (bits - 1))));
+    }
+
+    // a + b, a - b and a * b wrapped to 64 bits, returning whether the exact
+    // result does not fit
+    bool add_overflow(int64_t a, int64_t b, int64_t* result)
+    {
+#if defined(__GNUC__)
+        return __builtin_add_overflow(a, b, result);
+#else
+        *result = (int64_t) ((uint64_t) a + (uint64_t) b);
+        return (b > 0) ? (a > INT64_MAX - b) : (a < INT64_MIN - b);
+#endif
+    }
+
+    bool sub_overflow(int64_t a, int64_t b, int64_t* result)
+    {
+#if defined(__GNUC__)
+        return __builtin_sub_overflow(a, b, result);
+#else
+        *result = (int64_t) ((uint64_t) a - (uint64_t) b);
+        return (b < 0) ? (a > INT64_MAX + b) : (a < INT64_MIN + b);
+#endif
+    }
+
+    bool mul_overflow(int64_t a, int64_t b, int64_t* result)
+    {
+#if defined(__GNUC__)
+        return __builtin_mul_overflow(a, b, result);
+#else
+        *result = (int64_t) ((uint64_t) a * (uint64_t) b);
+
+        bool overflow = false;
+        if(a > 0)
+        {
+            overflow = (b > 0) ? (a > INT64_MAX / b) : (b < INT64_MIN / a);
+        }
+        else if(a < 0)
+        {
+            overflow = (b > 0) ? (a < INT64_MIN / b) : ((b < 0) && (b < INT64_MAX / a));
+        }
+        return overflow;
+#endif
+    }
+
+    Constant integer(uint8_t type, uint64_t value)
+    {
+        Constant c = {};
+        c.type = type;
+        c.data.integer = normalize(type, value);
+        return c;
+    }
+
+    Constant real(uint8_t type, double value)
+    {
+        Constant c = {};
+        c.type = type;
+        c.data.real = (type == TYPE_F32) ? (double) (float) value : value;
+        return c;
+    }
+
+    double to_real(const Constant& c)
+    {
+        double value = c.data.real;
+        if(!is_float(c.type))
+        {
+            value = is_signed(c.type) ? (double) (int64_t) c.data.integer : (double) c.data.integer;
+        }
+        return value;
+    }
+
+    bool truth(const Constant& c)
+    {
+        return is_float(c.type) ? (c.data.real != 0.0) : (c.data.integer != 0);
+    }
+
+    // integers wrap to the narrower type, floats are truncated towards zero
+    // and must fit
+    uint8_t convert(const Constant& from, uint8_t type, Constant* to)
+    {
+        uint8_t status = CONST_OK;
+
+        if(is_float(type))
+        {
+            *to = real(type, to_real(from));
+        }
+        else if(!is_float(from.type))
+        {
+            *to = integer(type, from.data.integer);
+        }
+        else
+        {
+            double value = trunc(from.data.real);
+            unsigned int bits = WIDTH[type] * 8;
+            if(is_signed(type) && (value >= -ldexp(1.0, bits - 1)) && (value < ldexp(1.0, bits - 1)))
+            {
+                *to = integer(type, (uint64_t) (int64_t) value);
+            }
+            else if(!is_signed(type) && (value >= 0.0) && (value < ldexp(1.0, bits)))
+            {
+                *to = integer(type, (uint64_t) value);
+            }
+            else
+            {
+                // NaN falls through to here too
+                status = CONST_RANGE;
+            }
+        }
+
+        return status;
+    }
+
+    uint8_t literal(const Literal& literal, Constant* value)
+    {
+        uint8_t status = CONST_OK;
+
+        switch(literal.type)
+        {
+            case LITERAL_INTEGER:
+            {
+                uint8_t type = (literal.suffix != TK_TYPE_INVALID) ? literal.suffix : (uint8_t) TYPE_I32;
+                if(is_float(type))
+                {
+                    *value = real(type, (double) literal.data.integer_value);
+                }
+                else if((literal.suffix == TK_TYPE_INVALID) && (literal.data.integer_value > 0x7FFFFFFF))
+                {
+                    // an unsuffixed literal is I32, which this one does not fit
+                    status = CONST_RANGE;
+                }
+                else
+                {
+                    *value = integer(type, literal.data.integer_value);
+                }
+                break;
+            }
+            case LITERAL_FLOAT:
+            {
+                uint8_t type = (literal.suffix != TK_TYPE_INVALID) ? literal.suffix : (uint8_t) TYPE_F32;
+                status = convert(real(TYPE_F64, literal.data.float_value), type, value);
+                break;
+            }
+            case LITERAL_CHAR:
+            {
+                *value = integer(TYPE_U8, (uint8_t) literal.data.character);
+                break;
+            }
+            default:
+            {
+                status = CONST_NOT_CONSTANT;
+                break;
+            }
+        }
+
+        return status;
+    }
+
+    // +, -, *, /, %, ^, & and | on two integers of the same type
+    uint8_t integer_operation(uint8_t op, uint8_t type, uint64_t lhs, uint64_t rhs, Constant* value)
+    {
+        uint8_t status = CONST_OK;
+
+        if(((op == EXPR_OP_DIV) || (op == EXPR_OP_MOD)) && (rhs == 0))
+        {
+            status = CONST_DIVIDE_BY_ZERO;
+        }
+        else if(is_signed(type))
+        {
+            int64_t a = (int64_t) lhs;
+            int64_t b = (int64_t) rhs;
+            int64_t result = 0;
+            bool overflow = false;
+
+            switch(op)
+            {
+                case EXPR_OP_ADD: { overflow = add_overflow(a, b, &result); break; }
+                case EXPR_OP_SUB: { overflow = sub_overflow(a, b, &result); break; }
+                case EXPR_OP_MUL: { overflow = mul_overflow(a, b, &result); break; }
+                case EXPR_OP_DIV:
+                case EXPR_OP_MOD:
+                {
+                    // the quotient of INT64_MIN / -1 does not fit, and % is undefined with it
+                    overflow = (a == INT64_MIN) && (b == -1);
+                    result = overflow ? 0 : ((op == EXPR_OP_DIV) ? (a / b) : (a % b));
+                    break;
+                }
+                case EXPR_OP_BITWISE_XOR: { result = a ^ b; break; }
+                case EXPR_OP_BITWISE_AND: { result = a & b; break; }
+                default:                  { result = a | b; break; }
+            }
+
+            status = (overflow || !fits(type, result)) ? (uint8_t) CONST_OVERFLOW : (uint8_t) CONST_OK;
+            *value = integer(type, (uint64_t) result);
+        }
+        else
+        {
+            uint64_t result = 0;
+            switch(op)
+            {
+                case EXPR_OP_ADD:         { result = lhs + rhs; break; }
+                case EXPR_OP_SUB:         { result = lhs - rhs; break; }
+                case EXPR_OP_MUL:         { result = lhs * rhs; break; }
+                case EXPR_OP_DIV:         { result = lhs / rhs; break; }
+                case EXPR_OP_MOD:         { result = lhs % rhs; break; }
+                case EXPR_OP_BITWISE_XOR: { result = lhs ^ rhs; break; }
+                case EXPR_OP_BITWISE_AND: { result = lhs & rhs; break; }
+                default:                  { result = lhs | rhs; break; }
+            }
+            *value = integer(type, result);
+        }
+
+        return status;
+    }
+
+    // << and >>, in the type of the left operand
+    uint8_t shift(uint8_t op, const Constant& lhs, const Constant& rhs, Constant* value)
+    {
+        uint8_t status = CONST_OK;
+        uint8_t type = lhs.type;
+        uint64_t count = rhs.data.integer;
+
+        if((is_signed(rhs.type) && ((int64_t) count < 0)) || (count >= WIDTH[type] * 8))
+        {
+            status = CONST_SHIFT_RANGE;
+        }
+        else if(op == EXPR_OP_BITWISE_R_SHIFT)
+        {
+            // the value is sign-extended, so this is arithmetic for the signed types
+            *value = integer(type, is_signed(type) ? (uint64_t) ((int64_t) lhs.data.integer >> count) : (lhs.data.integer >> count));
+        }
+        else if(is_signed(type))
+        {
+            // a negative value, or bits shifted into or past the sign bit, overflow
+            uint64_t result = lhs.data.integer << count;
+            bool overflow = ((int64_t) lhs.data.integer < 0) || ((result >> count) != lhs.data.integer) ||
+                            ((int64_t) result < 0) || !fits(type, (int64_t) result);
+            status = overflow ? (uint8_t) CONST_OVERFLOW : (uint8_t) CONST_OK;
+            *value = integer(type, result);
+        }
+        else
+        {
+            *value = integer(type, lhs.data.integer << count);
+        }
+
+        return status;
+    }
+
+    bool compare(uint8_t op, const Constant& lhs, const Constant& rhs)
+    {
+        // -1, 0 or 1 as lhs is less than, equal to or more than rhs
+        int order = 0;
+        if(is_float(lhs.type))
+        {
+            order = (lhs.data.real < rhs.data.real) ? -1 : ((lhs.data.real > rhs.data.real) ? 1 : 0);
+        }
+        else if(is_signed(lhs.type))
+        {
+            int64_t a = (int64_t) lhs.data.integer;
+            int64_t b = (int64_t) rhs.data.integer;
+            order = (a < b) ? -1 : ((a > b) ? 1 : 0);
+        }
+        else
+        {
+            order = (lhs.data.integer < rhs.data.integer) ? -1 : ((lhs.data.integer > rhs.data.integer) ? 1 : 0);
+        }
+
+        // NaN compares unequal to everything, itself included
+        bool unordered = is_float(lhs.type) && ((lhs.data.real != lhs.data.real) || (rhs.data.real != rhs.data.real));
+
+        bool result = false;
+        switch(op)
+        {
+            case EXPR_OP_CMP_EQUAL:              { result = !unordered && (order == 0); break; }
+            case EXPR_OP_CMP_NOT_EQUAL:          { result = unordered || (order != 0); break; }
+            case EXPR_OP_CMP_LESS_THAN:          { result = !unordered && (order < 0); break; }
+            case EXPR_OP_CMP_MORE_THAN:          { result = !unordered && (order > 0); break; }
+            case EXPR_OP_CMP_LESS_THAN_OR_EQUAL: { result = !unordered && (order <= 0); break; }
+            default:                             { result = !unordered && (order >= 0); break; }
+        }
+        return result;
+    }
+
+    // Replaces the maximal constant subtrees of a tree with literals, or
+    // evaluates the dimensions of the arrays its types are made of. Names
+    // declared inside function bodies go into a table of locals, so that a
+    // local shadowing a constant global is not taken for it.
+    class Folder
+    {
+    private:
+        ConstantEvaluator& m_evaluator;
+        TypeContext*       m_types;
+        const Type*        m_i32; // the type of an enumerator
+        bool               m_fold; // folding rather than evaluating dimensions
+
+        SymbolTable  m_locals;
+        bool         m_inside; // in a function body
+        unsigned int m_folded;
+        bool         m_failed; // a dimension has no value
+
+        std::unordered_map<Type*, Type*> m_visited; // types already walked, to what they became
+
+    private:
+        void declare(const SymbolTable::Entry& entry)
+        {
+            // the globals were entered up front; a name declared twice is
+            // the analyzer's to report
+            if(m_inside)
+            {
+                m_locals.insert(entry);
+            }
+        }
+
+        void replace(Expression* expr, const Constant& value)
+        {
+            Literal literal = {};
+            literal.suffix = value.type;
+            if(is_float(value.type))
+            {
+                literal.type = LITERAL_FLOAT;
+                literal.data.float_value = value.data.real;
+            }
+            else
+            {
+                literal.type = LITERAL_INTEGER;
+                literal.data.integer_value = value.data.integer;
+            }
+
+            expr->type = EXPR_LITERAL;
+            expr->data.literal = literal;
+            m_folded++;
+        }
+
+        // operands that are assigned to or have their address taken are
+        // not replaced, but what they are made of can be
+        void expression(Expression* expr, bool lvalue)
+        {
+            Constant value = {};
+            if(m_fold && !lvalue && (expr->type != EXPR_LITERAL) && m_evaluator.evaluate(expr, m_inside ? &m_locals : nullptr, &value, nullptr))
+            {
+                replace(expr, value);
+                return;
+            }
+
+            switch(expr->type)
+            {
+                case EXPR_SUB_EXPR: { expression(expr->data.sub_expr, lvalue); break; }
+                case EXPR_OPERATION:
+                {
+                    Expression::Operation& operation = expr->data.operation;
+                    switch(operation.op)
+                    {
+                        case EXPR_OP_ACCESS_FIELD:
+                        case EXPR_OP_ACCESS_FIELD_PTR:
+                        {
+                            // the right operand names a field
+                            expression(operation.lhs, lvalue);
+                            break;
+                        }
+                        case EXPR_OP_ASSIGN:
+                        {
+                            expression(operation.lhs, true);
+                            expression(operation.rhs, false);
+                            break;
+                        }
+                        case EXPR_OP_INCREMENT:
+                        case EXPR_OP_DECREMENT:
+                        case EXPR_OP_REFERENCE:
+                        {
+                            expression((operation.lhs != nullptr) ? operation.lhs : operation.rhs, true);
+                            break;
+                        }
+                        default:
+                        {
+                            if(operation.lhs != nullptr)
+                            {
+                                expression(operation.lhs, false);
+                            }
+                            if(operation.rhs != nullptr)
+                            {
+                                expression(operation.rhs, false);
+                            }
+                            break;
+                        }
+                    }
+                    break;
+                }
+                case EXPR_FUNCTION_CALL:
+                {
+                    expression(expr->data.func_call.function, false);
+                    for(Expression* arg : expr->data.func_call.arguments)
+                    {
+                        expression(arg, false);
+                    }
+                    break;
+                }
+                case EXPR_STATIC_CAST:
+                case EXPR_REINTERPRET_CAST:
+                {
+                    expr->data.cast.type = type(expr->data.cast.type);
+                    expression(expr->data.cast.expr, false);
+                    break;
+                }
+                case EXPR_INITIALIZER:
+                {
+                    for(Expression* item : expr->data.initializer)
+                    {
+                        expression(item, false);
+                    }
+                    break;
+                }
+                case EXPR_COMPOUND_EXPR:
+                {
+                    for(Expression* item : expr->data.compound_expr)
+                    {
+                        expression(item, false);
+                    }
+                    break;
+                }
+                default: { break; }
+            }
+        }
+
+        // the count of an array of size elements, UNEVALUATED when it has none
+        uint64_t dimension(const Expression* size)
+        {
+            uint64_t count = Type::Array::UNEVALUATED;
+
+            Constant value = {};
+            const char* error = nullptr;
+            if(!m_evaluator.evaluate(size, m_inside ? &m_locals : nullptr, &value, &error))
+            {
+                Diagnostics::Print("error: the size of an array is not constant: %s\n", error);
+            }
+            else if(!is_integer(value.type))
+            {
+                Diagnostics::Print("error: the size of an array is not an integer\n");
+            }
+            else if(is_signed(value.type) && ((int64_t) value.data.integer < 0))
+            {
+                Diagnostics::Print("error: the size of an array is negative\n");
+            }
+            else if(value.data.integer >= Type::Array::UNEVALUATED)
+            {
+                Diagnostics::Print("error: the size of an array is too large\n");
+            }
+            else
+            {
+                count = value.data.integer;
+            }
+
+            m_failed = m_failed || (count == Type::Array::UNEVALUATED);
+            return count;
+        }
+
+        // Evaluating dimensions, the type with every array in it keyed on its
+        // count, or itself when none has to change. Folding, the size an
+        // array keeps is replaced by its count rather than evaluated again,
+        // as it may name constants of the scope it was first written in.
+        Type* type(Type* type)
+        {
+            Type* result = type;
+
+            auto visited = m_visited.find(type);
+            if(visited != m_visited.end())
+            {
+                result = visited->second;
+            }
+            else
+            {
+                switch(type->type)
+                {
+                    case TYPE_PTR:
+                    {
+                        Type* pointee = this->type(type->data.pointer);
+                        if(pointee != type->data.pointer)
+                        {
+                            result = m_types->pointer(pointee, type->flags);
+                        }
+                        break;
+                    }
+                    case TYPE_ARRAY:
+                    {
+                        Type::Array& array = type->data.array;
+                        Type* elements = this->type(array.elements);
+
+                        if(m_fold)
+                        {
+                            if((array.size != nullptr) && (array.size->type != EXPR_LITERAL) && (array.count != Type::Array::UNEVALUATED))
+                            {
+                                replace(array.size, integer(TYPE_U64, array.count));
+                            }
+                        }
+                        else if(array.count == Type::Array::UNEVALUATED)
+                        {
+                            // one without a value stays as written, and has been reported
+                            uint64_t count = dimension(array.size);
+                            if(count != Type::Array::UNEVALUATED)
+                            {
+                                result = m_types->array(elements, count, type->flags, array.size);
+                            }
+                        }
+                        else if(elements != array.elements)
+                        {
+                            result = m_types->array(elements, array.count, type->flags, array.size);
+                        }
+                        break;
+                    }
+                    case TYPE_FUNCTION:
+                    {
+                        Function& function = type->data.function;
+                        Type* return_type = this->type(function.return_type);
+                        bool changed = (return_type != function.return_type);
+
+                        std::vector<Type*> params;
+                        params.reserve(function.parameters.size());
+                        for(Type* param : function.parameters)
+                        {
+                            params.push_back(this->type(param));
+                            changed = changed || (params.back() != param);
+                        }
+
+                        if(changed)
+                        {
+                            result = m_types->function(return_type, params.data(), (unsigned int) params.size(), type->flags);
+                        }
+                        break;
+                    }
+                    default: { break; }
+                }
+
+                if(type->type >= TYPE_PTR)
+                {
+                    m_visited[type] = result;
+                }
+            }
+
+            return result;
+        }
+
+        void fields(Declaration* decl)
+        {
+            if(decl->data.composite.body != nullptr)
+            {
+                for(Statement* stmt : *decl->data.composite.body)
+                {
+                    if(stmt->type != STMT_DECLARATION)
+                    {
+                        continue;
+                    }
+
+                    for(Declaration* field : stmt->data.declarations)
+                    {
+                        if(field->type == DECL_COMPOSITE)
+                        {
+                            fields(field);
+                        }
+                        else if(field->type == DECL_VARIABLE)
+                        {
+                            field->data.variable.type = type(field->data.variable.type);
+                        }
+                    }
+                }
+            }
+        }
+
+        void declaration(Declaration* decl)
+        {
+            switch(decl->type)
+            {
+                case DECL_VARIABLE:
+                {
+                    decl->data.variable.type = type(decl->data.variable.type);
+
+                    // the name is not in scope in its own initializer
+                    if(decl->data.variable.value != nullptr)
+                    {
+                        expression(decl->data.variable.value, false);
+                    }
+                    declare(SymbolTable::Entry { SYM_VARIABLE, decl->name, decl, decl->data.variable.type });
+                    break;
+                }
+                case DECL_FUNCTION:
+                {
+                    decl->data.function.type = type(decl->data.function.type);
+                    for(Function::Parameter* param : *decl->data.function.parameters)
+                    {
+                        param->type = type(param->type);
+                    }
+                    declare(SymbolTable::Entry { SYM_FUNCTION, decl->name, decl, decl->data.function.type });
+
+                    if(decl->data.function.body != nullptr)
+                    {
+                        bool inside = m_inside;
+                        m_inside = true;
+                        m_locals.push();
+
+                        for(const Function::Parameter* param : *decl->data.function.parameters)
+                        {
+                            declare(SymbolTable::Entry { SYM_VARIABLE, param->name, nullptr, param->type });
+                        }
+                        statements(*decl->data.function.body);
+
+                        m_locals.pop();
+                        m_inside = inside;
+                    }
+                    break;
+                }
+                case DECL_COMPOSITE:
+                {
+                    fields(decl);
+                    if(decl->name != SYMBOL_NULL)
+                    {
+                        declare(SymbolTable::Entry { SYM_COMPOSITE, decl->name, decl, nullptr });
+                    }
+                    break;
+                }
+                case DECL_ENUMERATOR:
+                {
+                    for(Enumerator::Value* value : *decl->data.enumerator.body)
+                    {
+                        if(value->value != nullptr)
+                        {
+                            expression(value->value, false);
+                        }
+                        declare(SymbolTable::Entry { SYM_ENUMERATOR, value->name, decl, m_i32 });
+                    }
+                    break;
+                }
+                default: { break; }
+            }
+        }
+
+        void statement(Statement* stmt)
+        {
+            switch(stmt->type)
+            {
+                case STMT_EXPR: { expression(stmt->data.expr, false); break; }
+                case STMT_IF:
+                {
+                    expression(stmt->data.cond_exec.condition, false);
+                    statement(stmt->data.cond_exec.on_true);
+                    if(stmt->data.cond_exec.on_false != nullptr)
+                    {
+                        statement(stmt->data.cond_exec.on_false);
+                    }
+                    break;
+                }
+                case STMT_WHILE:
+                {
+                    expression(stmt->data.while_loop.cond, false);
+                    statement(stmt->data.while_loop.body);
+                    break;
+                }
+                case STMT_FOR:
+                {
+                    m_locals.push();
+                    if(stmt->data.for_loop.init != nullptr)
+                    {
+                        statement(stmt->data.for_loop.init);
+                    }
+                    if(stmt->data.for_loop.cond != nullptr)
+                    {
+                        expression(stmt->data.for_loop.cond, false);
+                    }
+                    if(stmt->data.for_loop.step != nullptr)
+                    {
+                        expression(stmt->data.for_loop.step, false);
+                    }
+                    statement(stmt->data.for_loop.body);
+                    m_locals.pop();
+                    break;
+                }
+                case STMT_BLOCK:
+                {
+                    m_locals.push();
+                    statements(stmt->data.block.statements);
+                    m_locals.pop();
+                    break;
+                }
+                case STMT_RETURN:
+                {
+                    if(stmt->data.ret_stmt.expression != nullptr)
+                    {
+                        expression(stmt->data.ret_stmt.expression, false);
+                    }
+                    break;
+                }
+                case STMT_DECLARATION:
+                {
+                    for(Declaration* decl : stmt->data.declarations)
+                    {
+                        declaration(decl);
+                    }
+                    break;
+                }
+                case STMT_TYPEDEF:
+                {
+                    stmt->data.type_def.type = type(stmt->data.type_def.type);
+                    declare(SymbolTable::Entry { SYM_TYPEDEF, stmt->data.type_def.name, nullptr, stmt->data.type_def.type });
+                    break;
+                }
+                case STMT_SWITCH:
+                {
+                    expression(stmt->data.switch_stmt.expr, false);
+                    statement(stmt->data.switch_stmt.body);
+                    break;
+                }
+                case STMT_CASE: { expression(stmt->data.case_stmt.value, false); break; }
+                default: { break; }
+            }
+        }
+
+    public:
+        Folder(ConstantEvaluator& evaluator, TypeContext* types, bool fold) : m_evaluator(evaluator)
+        {
+            m_types = types;
+            m_i32 = types->primitive(TYPE_I32, Type::Flags {});
+            m_fold = fold;
+            m_inside = false;
+            m_folded = 0;
+            m_failed = false;
+        }
+
+        void statements(List<Statement>& list)
+        {
+            for(Statement* stmt : list)
+            {
+                statement(stmt);
+            }
+        }
+
+        unsigned int folded() const
+        {
+            return m_folded;
+        }
+
+        bool failed() const
+        {
+            return m_failed;
+        }
+    };
+}
+
+uint8_t arithmetic_type(uint8_t lhs, uint8_t rhs)
+{
+    uint8_t type = lhs;
+
+    if(is_float(lhs) != is_float(rhs))
+    {
+        type = is_float(lhs) ? lhs : rhs;
+    }
+    else if(WIDTH[lhs] != WIDTH[rhs])
+    {
+        type = (WIDTH[lhs] > WIDTH[rhs]) ? lhs : rhs;
+    }
+    else if(!is_float(lhs))
+    {
+        type = is_signed(lhs) ? rhs : lhs;
+    }
+
+    return type;
+}
+
+ConstantEvaluator::ConstantEvaluator(const SymbolTable* globals)
+{
+    m_globals = globals;
+    m_scope = nullptr;
+
+    m_slots.resize(INITIAL_SLOTS, Slot { nullptr, Result { CONST_OK, Constant {} } });
+    m_mask = INITIAL_SLOTS - 1;
+    m_used = 0;
+}
+
+ConstantEvaluator::Slot* ConstantEvaluator::find(const Expression* node)
+{
+    uint32_t i = (uint32_t) (((uintptr_t) node * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+    while((m_slots[i].node != nullptr) && (m_slots[i].node != node))
+    {
+        i = (i + 1) & m_mask;
+    }
+    return &m_slots[i];
+}
+
+void ConstantEvaluator::grow()
+{
+    std::vector<Slot> slots;
+    slots.swap(m_slots);
+
+    m_mask = (m_mask << 1) | 1;
+    m_slots.resize((size_t) m_mask + 1, Slot { nullptr, Result { CONST_OK, Constant {} } });
+
+    for(const Slot& slot : slots)
+    {
+        if(slot.node != nullptr)
+        {
+            *find(slot.node) = slot;
+        }
+    }
+}
+
+uint8_t ConstantEvaluator::evaluate(const Expression* expr, Constant* value)
+{
+    uint8_t status = CONST_OK;
+
+    // most nodes are leaves, which are cheaper to work out again than to look up
+    switch(expr->type)
+    {
+        case EXPR_LITERAL:    { status = literal(expr->data.literal, value); break; }
+        case EXPR_IDENTIFIER: { status = identifier(expr->data.identifier, value); break; }
+        default:              { status = remember(expr, value); break; }
+    }
+
+    return status;
+}
+
+uint8_t ConstantEvaluator::remember(const Expression* expr, Constant* value)
+{
+    uint8_t status = CONST_OK;
+
+    Slot* slot = find(expr);
+    if(slot->node == nullptr)
+    {
+        // marked pending first, so that a constant defined in terms of itself finds it
+        *slot = Slot { expr, Result { CONST_PENDING, Constant {} } };
+        m_used++;
+        if(m_used * 2 > m_mask)
+        {
+            grow();
+        }
+
+        Result result = { CONST_OK, Constant {} };
+        result.status = compute(expr, &result.value);
+
+        // the table may have grown in the meantime
+        find(expr)->result = result;
+        status = result.status;
+        *value = result.value;
+    }
+    else
+    {
+        status = (slot->result.status == CONST_PENDING) ? (uint8_t) CONST_CYCLE : slot->result.status;
+        *value = slot->result.value;
+    }
+
+    return status;
+}
+
+uint8_t ConstantEvaluator::compute(const Expression* expr, Constant* value)
+{
+    uint8_t status = CONST_OK;
+
+    switch(expr->type)
+    {
+        case EXPR_SUB_EXPR:   { status = evaluate(expr->data.sub_expr, value); break; }
+        case EXPR_LITERAL:    { status = literal(expr->data.literal, value); break; }
+        case EXPR_IDENTIFIER: { status = identifier(expr->data.identifier, value); break; }
+        case EXPR_OPERATION:  { status = operation(expr->data.operation, value); break; }
+        case EXPR_STATIC_CAST:
+        case EXPR_REINTERPRET_CAST:
+        {
+            Constant operand = {};
+            uint8_t type = expr->data.cast.type->type;
+            status = is_arithmetic(type) ? evaluate(expr->data.cast.expr, &operand) : (uint8_t) CONST_NOT_CONSTANT;
+            if(status == CONST_OK)
+            {
+                status = convert(operand, type, value);
+            }
+            break;
+        }
+        case EXPR_COMPOUND_EXPR:
+        {
+            // the value of the last one, when they all have one
+            for(const Expression* item : expr->data.compound_expr)
+            {
+                status = (status == CONST_OK) ? evaluate(item, value) : status;
+            }
+            break;
+        }
+        default:
+        {
+            // function calls and initializer lists
+            status = CONST_NOT_CONSTANT;
+            break;
+        }
+    }
+
+    return status;
+}
+
+uint8_t ConstantEvaluator::operation(const Expression::Operation& operation, Constant* value)
+{
+    uint8_t op = operation.op;
+    uint8_t status = CONST_OK;
+
+    Constant lhs = {};
+    Constant rhs = {};
+
+    switch(op)
+    {
+        case EXPR_OP_ADD:
+        case EXPR_OP_SUB:
+        case EXPR_OP_MUL:
+        case EXPR_OP_DIV:
+        case EXPR_OP_MOD:
+        case EXPR_OP_BITWISE_XOR:
+        case EXPR_OP_BITWISE_AND:
+        case EXPR_OP_BITWISE_OR:
+        {
+            status = evaluate(operation.lhs, &lhs);
+            status = (status == CONST_OK) ? evaluate(operation.rhs, &rhs) : status;
+            if(status == CONST_OK)
+            {
+                uint8_t type = arithmetic_type(lhs.type, rhs.type);
+                convert(lhs, type, &lhs);
+                convert(rhs, type, &rhs);
+
+                if(is_integer(type))
+                {
+                    status = integer_operation(op, type, lhs.data.integer, rhs.data.integer, value);
+                }
+                else
+                {
+                    // IEEE semantics, a division by zero is an infinity
+                    switch(op)
+                    {
+                        case EXPR_OP_ADD: { *value = real(type, lhs.data.real + rhs.data.real); break; }
+                        case EXPR_OP_SUB: { *value = real(type, lhs.data.real - rhs.data.real); break; }
+                        case EXPR_OP_MUL: { *value = real(type, lhs.data.real * rhs.data.real); break; }
+                        case EXPR_OP_DIV: { *value = real(type, lhs.data.real / rhs.data.real); break; }
+                        default:          { status = CONST_NOT_CONSTANT; break; }
+                    }
+                }
+            }
+            break;
+        }
+        case EXPR_OP_BITWISE_L_SHIFT:
+        case EXPR_OP_BITWISE_R_SHIFT:
+        {
+            status = evaluate(operation.lhs, &lhs);
+            status = (status == CONST_OK) ? evaluate(operation.rhs, &rhs) : status;
+            if(status == CONST_OK)
+            {
+                status = (is_integer(lhs.type) && is_integer(rhs.type)) ? shift(op, lhs, rhs, value) : (uint8_t) CONST_NOT_CONSTANT;
+            }
+            break;
+        }
+        case EXPR_OP_LOGICAL_AND:
+        case EXPR_OP_LOGICAL_OR:
+        {
+            // the right operand only counts when the left does not decide
+            status = evaluate(operation.lhs, &lhs);
+            if(status == CONST_OK)
+            {
+                bool result = truth(lhs);
+                if(result == (op == EXPR_OP_LOGICAL_AND))
+                {
+                    status = evaluate(operation.rhs, &rhs);
+                    result = truth(rhs);
+                }
+                *value = integer(TYPE_I32, result ? 1 : 0);
+            }
+            break;
+        }
+        case EXPR_OP_CMP_EQUAL:
+        case EXPR_OP_CMP_NOT_EQUAL:
+        case EXPR_OP_CMP_LESS_THAN:
+        case EXPR_OP_CMP_MORE_THAN:
+        case EXPR_OP_CMP_LESS_THAN_OR_EQUAL:
+        case EXPR_OP_CMP_MORE_THAN_OR_EQUAL:
+        {
+            status = evaluate(operation.lhs, &lhs);
+            status = (status == CONST_OK) ? evaluate(operation.rhs, &rhs) : status;
+            if(status == CONST_OK)
+            {
+                uint8_t type = arithmetic_type(lhs.type, rhs.type);
+                convert(lhs, type, &lhs);
+                convert(rhs, type, &rhs);
+                *value = integer(TYPE_I32, compare(op, lhs, rhs) ? 1 : 0);
+            }
+            break;
+        }
+        case EXPR_OP_LOGICAL_NOT:
+        {
+            status = evaluate(operation.rhs, &rhs);
+            *value = integer(TYPE_I32, truth(rhs) ? 0 : 1);
+            break;
+        }
+        case EXPR_OP_BITWISE_COMPLEMENT:
+        {
+            status = evaluate(operation.rhs, &rhs);
+            if(status == CONST_OK)
+            {
+                status = is_integer(rhs.type) ? (uint8_t) CONST_OK : (uint8_t) CONST_NOT_CONSTANT;
+                *value = integer(rhs.type, ~rhs.data.integer);
+            }
+            break;
+        }
+        default:
+        {
+            // assignments, increments and decrements change an object, and
+            // addresses, dereferences, fields and elements are not known
+            // until the program runs
+            status = CONST_NOT_CONSTANT;
+            break;
+        }
+    }
+
+    return status;
+}
+
+uint8_t ConstantEvaluator::identifier(uint32_t id, Constant* value)
+{
+    uint8_t status = CONST_NOT_CONSTANT;
+
+    const SymbolTable::Entry* entry = (m_scope != nullptr) ? m_scope->search(id) : nullptr;
+    bool local = (entry != nullptr);
+    entry = local ? entry : m_globals->search(id);
+
+    if((entry != nullptr) && (entry->decl != nullptr))
+    {
+        // what a constant refers to is looked up where it is declared
+        const SymbolTable* scope = m_scope;
+        m_scope = local ? m_scope : nullptr;
+
+        if(entry->type == SYM_ENUMERATOR)
+        {
+            status = enumerator(entry->decl, id, value);
+        }
+        else if((entry->type == SYM_VARIABLE) && !local)
+        {
+            status = global(entry->decl, value);
+        }
+
+        m_scope = scope;
+    }
+
+    return status;
+}
+
+uint8_t ConstantEvaluator::enumerator(const Declaration* decl, uint32_t id, Constant* value)
+{
+    uint8_t status = CONST_NOT_CONSTANT;
+    bool found = false;
+
+    // each value is one past the previous one unless it is given, so the
+    // values up to this one are worked out in order
+    Result previous = { CONST_OK, integer(TYPE_I32, (uint64_t) -1) };
+    for(unsigned int i = 0; !found && (i < decl->data.enumerator.body->size()); i++)
+    {
+        const Enumerator::Value* v = (*decl->data.enumerator.body)[i];
+
+        std::unordered_map<const Enumerator::Value*, Result>::const_iterator it = m_enumerators.find(v);
+        Result result = { CONST_OK, Constant {} };
+        if(it != m_enumerators.end())
+        {
+            result = it->second;
+        }
+        else if(v->value != nullptr)
+        {
+            Constant given = {};
+            result.status = remember(v->value, &given);
+            if((result.status == CONST_OK) && !is_integer(given.type))
+            {
+                result.status = CONST_NOT_CONSTANT;
+            }
+            else if(result.status == CONST_OK)
+            {
+                // an enumerator is an I32, and must have the value it was given
+                bool fits_i32 = is_signed(given.type) ? fits(TYPE_I32, (int64_t) given.data.integer) : (given.data.integer <= 0x7FFFFFFF);
+                result.status = fits_i32 ? (uint8_t) CONST_OK : (uint8_t) CONST_RANGE;
+                result.value = integer(TYPE_I32, given.data.integer);
+            }
+            m_enumerators[v] = result;
+        }
+        else
+        {
+            result.status = previous.status;
+            if(previous.status == CONST_OK)
+            {
+                result.status = ((int64_t) previous.value.data.integer == 0x7FFFFFFF) ? (uint8_t) CONST_OVERFLOW : (uint8_t) CONST_OK;
+                result.value = integer(TYPE_I32, previous.value.data.integer + 1);
+            }
+            m_enumerators[v] = result;
+        }
+
+        found = (v->name == id);
+        status = result.status;
+        *value = result.value;
+        previous = result;
+    }
+
+    return found ? status : (uint8_t) CONST_NOT_CONSTANT;
+}
+
+uint8_t ConstantEvaluator::global(const Declaration* decl, Constant* value)
+{
+    uint8_t status = CONST_NOT_CONSTANT;
+
+    const Type* type = decl->data.variable.type;
+    if((decl->type == DECL_VARIABLE) && type->flags.bits.is_constant && is_arithmetic(type->type) && (decl->data.variable.value != nullptr))
+    {
+        Constant initial = {};
+        status = remember(decl->data.variable.value, &initial);
+        if(status == CONST_OK)
+        {
+            status = convert(initial, type->type, value);
+        }
+    }
+
+    return status;
+}
+
+bool ConstantEvaluator::evaluate(const Expression* expr, const SymbolTable* scope, Constant* value, const char** error)
+{
+    m_scope = scope;
+
+    Constant result = {};
+    uint8_t status = evaluate(expr, &result);
+    if(status == CONST_OK)
+    {
+        *value = result;
+    }
+    else if(error != nullptr)
+    {
+        *error = MESSAGES[status];
+    }
+
+    m_scope = nullptr;
+    return status == CONST_OK;
+}
+
+size_t ConstantEvaluator::size() const
+{
+    return m_used;
+}
+
+void ConstantEvaluator::Globals(AST* ast, SymbolTable* globals)
+{
+    const Type* i32 = ast->types->primitive(TYPE_I32, Type::Flags {});
+    for(const Statement* stmt : ast->statements)
+    {
+        if(stmt->type == STMT_TYPEDEF)
+        {
+            globals->insert(SymbolTable::Entry { SYM_TYPEDEF, stmt->data.type_def.name, nullptr, stmt->data.type_def.type });
+        }
+        else if(stmt->type == STMT_DECLARATION)
+        {
+            for(const Declaration* decl : stmt->data.declarations)
+            {
+                switch(decl->type)
+                {
+                    case DECL_VARIABLE: { globals->insert(SymbolTable::Entry { SYM_VARIABLE, decl->name, decl, decl->data.variable.type }); break; }
+                    case DECL_FUNCTION: { globals->insert(SymbolTable::Entry { SYM_FUNCTION, decl->name, decl, decl->data.function.type }); break; }
+                    case DECL_COMPOSITE:
+                    {
+                        if(decl->name != SYMBOL_NULL)
+                        {
+                            globals->insert(SymbolTable::Entry { SYM_COMPOSITE, decl->name, decl, nullptr });
+                        }
+                        break;
+                    }
+                    case DECL_ENUMERATOR:
+                    {
+                        for(const Enumerator::Value* value : *decl->data.enumerator.body)
+                        {
+                            globals->insert(SymbolTable::Entry { SYM_ENUMERATOR, value->name, decl, i32 });
+                        }
+                        break;
+                    }
+                    default: { break; }
+                }
+            }
+        }
+    }
+}
+
+unsigned int ConstantEvaluator::Fold(AST* ast)
+{
+    // every global is visible from every initializer and body
+    SymbolTable globals;
+    Globals(ast, &globals);
+
+    ConstantEvaluator evaluator(&globals);
+    Folder folder(evaluator, ast->types, true);
+    folder.statements(ast->statements);
+
+    return folder.folded();
+}
+
+bool ConstantEvaluator::Dimensions(AST* ast)
+{
+    bool status = true;
+
+    // nothing to do for a tree without arrays of a given size
+    if(ast->types->unevaluated() > 0)
+    {
+        SymbolTable globals;
+        Globals(ast, &globals);
+
+        ConstantEvaluator evaluator(&globals);
+        Folder folder(evaluator, ast->types, false);
+        folder.statements(ast->statements);
+
+        // sizes without a value are left to be reported again
+        status = !folder.failed();
+        if(status)
+        {
+            ast->types->evaluated();
+        }
+    }
+
+    return status;
+}
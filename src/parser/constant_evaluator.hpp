@@ -0,0 +1,120 @@
+#ifndef CONSTANT_EVALUATOR_HPP
+#define CONSTANT_EVALUATOR_HPP
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <ast.hpp>
+#include <symbol_table.hpp>
+
+// A value known at compile time, of one of the types TYPE_U8 to TYPE_F64.
+struct Constant
+{
+    uint8_t type;
+
+    union
+    {
+        uint64_t integer; // truncated to the width of the type, sign-extended for the signed ones
+        double   real;    // rounded to float for TYPE_F32
+    } data;
+};
+
+// The type the usual arithmetic conversions give two operands of primitive
+// types: floats win over integers, the wider type over the narrower one and
+// unsigned over signed of the same width. There is no promotion to I32, so
+// U8 + U8 is U8.
+uint8_t arithmetic_type(uint8_t lhs, uint8_t rhs);
+
+// Evaluates constant expressions with the semantics the analyzer types them
+// with: every operation is carried out in the type of its result, unsigned
+// arithmetic wraps at the width of its type, and signed overflow, division by
+// zero, shifts by the width or more and conversions of floats that do not fit
+// their integer type leave an expression without a value, as they have none
+// in C. An identifier is constant when it names an enumerator or a const
+// global of a primitive type whose initializer is constant.
+//
+// Results are kept per node, so an expression is evaluated at most once for
+// each evaluator however often it is asked for or referred to. Literals and
+// names are the exception, as they are cheaper to work out again than to look
+// up, unless a constant is defined as one. The nodes must outlive the
+// evaluator, and a node is taken to always be asked for in the scope it
+// appears in.
+class ConstantEvaluator
+{
+private:
+    enum
+    {
+        INITIAL_SLOTS = 16 // the analyzer has an evaluator per function body
+    };
+
+    struct Result
+    {
+        uint8_t  status; // see constant_evaluator.cpp
+        Constant value;
+    };
+
+    struct Slot
+    {
+        const Expression* node; // nullptr when empty
+        Result result;
+    };
+
+    const SymbolTable* m_globals;
+    const SymbolTable* m_scope; // names inside functions, nullptr at the top level
+
+    // the results per node, open-addressed on the node's address
+    std::vector<Slot> m_slots;
+    uint32_t          m_mask;
+    uint32_t          m_used;
+
+    std::unordered_map<const Enumerator::Value*, Result> m_enumerators;
+
+private:
+    // the slot holding node, or the empty one it goes into
+    Slot* find(const Expression* node);
+    void  grow();
+
+    uint8_t evaluate(const Expression* expr, Constant* value);
+    // evaluates through the results kept per node
+    uint8_t remember(const Expression* expr, Constant* value);
+    uint8_t compute(const Expression* expr, Constant* value);
+    uint8_t operation(const Expression::Operation& operation, Constant* value);
+    uint8_t identifier(uint32_t id, Constant* value);
+    uint8_t enumerator(const Declaration* decl, uint32_t id, Constant* value);
+    uint8_t global(const Declaration* decl, Constant* value);
+
+public:
+    // globals must outlive the evaluator; enumerators in it carry the
+    // declaration of their enum
+    ConstantEvaluator(const SymbolTable* globals);
+
+    // false if expr has no value at compile time, with the reason in error
+    // unless it is nullptr. Names are looked up in scope first, which may be
+    // nullptr at the top level.
+    bool evaluate(const Expression* expr, const SymbolTable* scope, Constant* value, const char** error);
+
+    // nodes whose results are kept
+    size_t size() const;
+
+    // enters the names declared at the top level of ast into globals, with
+    // the enumerators carrying their enum, as an evaluator expects them
+    static void Globals(AST* ast, SymbolTable* globals);
+
+    // Replaces every maximal constant subtree of the tree with an EXPR_LITERAL
+    // of its value and type, in function bodies, initializers, enumerator
+    // values, case labels and array sizes. Operands that are assigned to or
+    // have their address taken are left as they are. Returns the number of
+    // subtrees replaced.
+    static unsigned int Fold(AST* ast);
+
+    // Evaluates the size of every array the parser made as written, in the
+    // scope it is written in, and replaces each type that contains one with
+    // the type keyed on the counts. False, with the sizes that have no value
+    // reported, if any is not a constant integer from 0 up. The parser runs
+    // it once the whole tree is there.
+    static bool Dimensions(AST* ast);
+};
+
+#endif // CONSTANT_EVALUATOR_HPP
@@ -0,0 +1,296 @@
+#include <driver.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <analyzer.hpp>
+#include <diagnostics.hpp>
+#include <parser.hpp>
+#include <shared_interner.hpp>
+#include <thread_pool.hpp>
+#include <tokenizer.hpp>
+
+namespace
+{
+    // guards against a response file that names itself
+    const unsigned int MAX_RESPONSE_DEPTH = 16;
+
+    bool collect(const std::string& arg, std::vector<std::string>* paths, unsigned int depth);
+
+    bool is_source(const std::string& path)
+    {
+        return (path.size() > 2) && (path.compare(path.size() - 2, 2, ".c") == 0);
+    }
+
+    bool collect_response(const std::string& path, std::vector<std::string>* paths, unsigned int depth)
+    {
+        bool status = true;
+
+        SourceBuffer* buffer = nullptr;
+        if(depth >= MAX_RESPONSE_DEPTH)
+        {
+            status = false;
+            Diagnostics::Print("error: response files nested too deeply at \"%s\"\n", path.c_str());
+        }
+        else
+        {
+            buffer = SourceBuffer::Load(path.c_str());
+            status = (buffer != nullptr);
+        }
+
+        if(status)
+        {
+            const char* ptr = buffer->data();
+            const char* end = ptr + buffer->size();
+
+            while(status && (ptr < end))
+            {
+                while((ptr < end) && ((*ptr == ' ') || (*ptr == '\t') || (*ptr == '\r') || (*ptr == '\n')))
+                {
+                    ptr++;
+                }
+
+                const char* start = ptr;
+                while((ptr < end) && (*ptr != ' ') && (*ptr != '\t') && (*ptr != '\r') && (*ptr != '\n'))
+                {
+                    ptr++;
+                }
+
+                if(ptr > start)
+                {
+                    status = collect(std::string(start, ptr), paths, depth + 1);
+                }
+            }
+        }
+
+        delete buffer;
+        return status;
+    }
+
+#ifndef _WIN32
+    bool collect_directory(const std::string& path, std::vector<std::string>* paths, unsigned int depth)
+    {
+        bool status = true;
+
+        DIR* dir = opendir(path.c_str());
+        if(dir == nullptr)
+        {
+            status = false;
+            Diagnostics::Print("error: could not open directory \"%s\"\n", path.c_str());
+        }
+        else
+        {
+            // readdir's order depends on the file system, sorting keeps runs comparable
+            std::vector<std::string> entries;
+            for(struct dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+            {
+                if(entry->d_name[0] != '.')
+                {
+                    entries.push_back(path + "/" + entry->d_name);
+                }
+            }
+            closedir(dir);
+
+            std::sort(entries.begin(), entries.end());
+
+            for(unsigned int i = 0; status && (i < entries.size()); i++)
+            {
+                struct stat info;
+                if(stat(entries[i].c_str(), &info) != 0)
+                {
+                    // removed since it was listed
+                }
+                else if(S_ISDIR(info.st_mode))
+                {
+                    status = collect_directory(entries[i], paths, depth);
+                }
+                else if(S_ISREG(info.st_mode) && is_source(entries[i]))
+                {
+                    paths->push_back(entries[i]);
+                }
+            }
+        }
+
+        return status;
+    }
+#endif
+
+    bool collect(const std::string& arg, std::vector<std::string>* paths, unsigned int depth)
+    {
+        bool status = true;
+
+#ifndef _WIN32
+        struct stat info;
+#endif
+
+        if(arg[0] == '@')
+        {
+            status = collect_response(arg.substr(1), paths, depth);
+        }
+#ifndef _WIN32
+        else if((stat(arg.c_str(), &info) == 0) && S_ISDIR(info.st_mode))
+        {
+            std::string dir = arg;
+            while((dir.size() > 1) && (dir.back() == '/'))
+            {
+                dir.pop_back();
+            }
+            status = collect_directory(dir, paths, depth);
+        }
+#endif
+        else
+        {
+            // a missing file is reported when it is compiled, in its place in the output
+            paths->push_back(arg);
+        }
+
+        return status;
+    }
+
+    void compile(const std::string& path, SharedInterner* symbols, bool check, Driver::Unit* unit)
+    {
+        unit->path = path;
+
+        Diagnostics::Capture(&unit->diagnostics);
+
+        TokenStack stack;
+        stack.share_symbols(symbols);
+        bool status = Tokenizer::Tokenize(path.c_str(), &stack);
+
+        AST* ast = nullptr;
+        if(status)
+        {
+            ast = Parser::Parse(stack);
+            status = (ast != nullptr);
+        }
+
+        // the files are already spread over the workers, so the bodies of
+        // one file are checked on the worker compiling it
+        if(status && check)
+        {
+            status = Analyzer::Analyze(ast, nullptr);
+        }
+
+        Diagnostics::Release();
+
+        unit->status = status;
+        unit->bytes = (stack.get_source() != nullptr) ? stack.get_source()->size() : 0;
+        unit->tokens = stack.get_stats().tokens;
+        unit->nodes = 0;
+
+        if(ast != nullptr)
+        {
+            unit->nodes = ast->arena.get_stats().allocations;
+            delete_ast(ast);
+        }
+    }
+
+    double cpu_seconds()
+    {
+#ifdef _WIN32
+        // clock() is wall time on Windows, the process times count every thread
+        FILETIME created, exited, kernel, user;
+        double seconds = 0.0;
+        if(GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+        {
+            uint64_t ticks = ((uint64_t) kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+            ticks += ((uint64_t) user.dwHighDateTime << 32) | user.dwLowDateTime;
+            seconds = (double) ticks * 100e-9;
+        }
+        return seconds;
+#else
+        struct timespec now = {};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+        return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+#endif
+    }
+}
+
+bool Driver::Collect(const char* arg, std::vector<std::string>* paths)
+{
+    bool status = true;
+    if(arg[0] == '\0')
+    {
+        status = false;
+        Diagnostics::Print("error: empty path\n");
+    }
+    else
+    {
+        status = collect(arg, paths, 0);
+    }
+    return status;
+}
+
+bool Driver::Compile(const std::vector<std::string>& paths, unsigned int jobs, bool check, std::vector<Unit>* units, Summary* summary)
+{
+    units->clear();
+    units->resize(paths.size());
+
+    *summary = Summary();
+    summary->files = (unsigned int) paths.size();
+    summary->jobs = (jobs > 0) ? jobs : 1;
+
+    double cpu_start = cpu_seconds();
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+    SharedInterner symbols;
+    {
+        ThreadPool pool(summary->jobs);
+        pool.run(summary->files, [&paths, &symbols, check, units](unsigned int i) { compile(paths[i], &symbols, check, &(*units)[i]); });
+    }
+    summary->symbols = symbols.size() - 1;
+
+    summary->wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    summary->cpu_seconds = cpu_seconds() - cpu_start;
+
+    for(const Unit& unit : *units)
+    {
+        summary->failed += unit.status ? 0 : 1;
+        summary->bytes += unit.bytes;
+        summary->tokens += unit.tokens;
+        summary->nodes += unit.nodes;
+    }
+
+    return summary->failed == 0;
+}
+
+void Driver::Report(const std::vector<Unit>& units, const Summary& summary, bool stats)
+{
+    for(const Unit& unit : units)
+    {
+        if(!unit.diagnostics.empty())
+        {
+            printf("%s:\n%s", unit.path.c_str(), unit.diagnostics.c_str());
+        }
+
+        if(!unit.status)
+        {
+            printf("%s: failed\n", unit.path.c_str());
+        }
+        else if(stats)
+        {
+            printf("%s: %zu bytes, %zu tokens, %zu ast nodes\n", unit.path.c_str(), unit.bytes, unit.tokens, unit.nodes);
+        }
+    }
+
+    double wall = (summary.wall_seconds > 0.0) ? summary.wall_seconds : 1e-9;
+
+    printf("files: %u compiled, %u failed\n", summary.files, summary.failed);
+    printf("input: %zu bytes, %zu tokens, %zu ast nodes, %zu distinct names\n", summary.bytes, summary.tokens, summary.nodes, summary.symbols);
+    printf("time:  %.3f ms wall, %.3f ms cpu (%.2fx) on %u jobs, %.1f files/s, %.2f MB/s\n",
+           summary.wall_seconds * 1e3, summary.cpu_seconds * 1e3, summary.cpu_seconds / wall, summary.jobs,
+           (double) summary.files / wall, ((double) summary.bytes / (1024.0 * 1024.0)) / wall);
+}
@@ -0,0 +1,60 @@
+#ifndef DRIVER_HPP
+#define DRIVER_HPP
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+// Tokenizes and parses many translation units on a pool of workers. Each file
+// is compiled start to finish by one worker with a token stack and AST arena
+// of its own; the workers share only the job queue and a SharedInterner, so a
+// name has the same symbol id in every file. A file's
+// diagnostics are captured while it is compiled and kept with its result, and
+// results are stored by input position, so the report is the same for any
+// number of jobs.
+class Driver
+{
+public:
+    struct Unit
+    {
+        std::string path;
+        std::string diagnostics;
+        bool status;
+
+        size_t bytes;
+        size_t tokens;
+        size_t nodes; // AST allocations
+    };
+
+    struct Summary
+    {
+        unsigned int files;
+        unsigned int failed;
+        unsigned int jobs;
+
+        size_t bytes;
+        size_t tokens;
+        size_t nodes;
+        size_t symbols; // distinct names over all files
+
+        double wall_seconds;
+        double cpu_seconds; // summed over every thread of the process
+    };
+
+public:
+    // Appends the sources named by arg: a file, every .c file under a
+    // directory in sorted order, or each entry of a response file given as
+    // @path. Entries of a response file are separated by whitespace and may
+    // themselves be directories or response files.
+    static bool Collect(const char* arg, std::vector<std::string>* paths);
+
+    // compiles every path, with semantic analysis if check is set, and
+    // returns false if any of them failed
+    static bool Compile(const std::vector<std::string>& paths, unsigned int jobs, bool check, std::vector<Unit>* units, Summary* summary);
+
+    // prints the diagnostics of each unit in input order, then the summary
+    static void Report(const std::vector<Unit>& units, const Summary& summary, bool stats);
+};
+
+#endif // DRIVER_HPP
@@ -0,0 +1,362 @@
+#include <flat_ast.hpp>
+
+namespace
+{
+    typedef FlatAST::Ref Ref;
+    typedef FlatAST::Range Range;
+
+    class Flattener
+    {
+    private:
+        FlatAST* m_flat;
+        bool m_status;
+
+    private:
+        template<typename T>
+        Ref add(uint8_t kind, std::vector<T>& pool, const T& node)
+        {
+            Ref ref = FlatAST::NONE;
+            if(pool.size() <= FlatAST::INDEX_MASK)
+            {
+                ref = FlatAST::make_ref(kind, (uint32_t) pool.size());
+                pool.push_back(node);
+            }
+            else
+            {
+                m_status = false;
+            }
+            return ref;
+        }
+
+        // the slots are taken before the elements are converted, so that the
+        // ranges of their own children land after them
+        Range reserve(unsigned int count)
+        {
+            Range range = { (uint32_t) m_flat->refs.size(), count };
+            m_flat->refs.resize(m_flat->refs.size() + count, FlatAST::NONE);
+            return range;
+        }
+
+        Range convert_list(const List<Statement>* list)
+        {
+            Range range = reserve(list->size());
+            for(unsigned int i = 0; i < range.count; i++)
+            {
+                Ref ref = convert((*list)[i]);
+                m_flat->refs[range.first + i] = ref;
+            }
+            return range;
+        }
+
+        Range convert_list(const List<Expression>* list)
+        {
+            Range range = reserve(list->size());
+            for(unsigned int i = 0; i < range.count; i++)
+            {
+                Ref ref = convert((*list)[i]);
+                m_flat->refs[range.first + i] = ref;
+            }
+            return range;
+        }
+
+        Range convert_list(const List<Declaration>* list)
+        {
+            Range range = reserve(list->size());
+            for(unsigned int i = 0; i < range.count; i++)
+            {
+                Ref ref = convert((*list)[i]);
+                m_flat->refs[range.first + i] = ref;
+            }
+            return range;
+        }
+
+        Range convert_body(const List<Statement>* body)
+        {
+            Range range = { FlatAST::NONE, 0 };
+            if(body != nullptr)
+            {
+                range = convert_list(body);
+            }
+            return range;
+        }
+
+        // names, if given, are the parameters as a declaration names them
+        Range convert_parameters(const List<Type>* list, const List<Function::Parameter>* names)
+        {
+            Range range = { (uint32_t) m_flat->parameters.size(), list->size() };
+            m_flat->parameters.resize(m_flat->parameters.size() + range.count);
+
+            for(unsigned int i = 0; i < range.count; i++)
+            {
+                Ref type = convert((*list)[i]);
+
+                FlatAST::Parameter& out = m_flat->parameters[range.first + i];
+                out.name = (names != nullptr) ? (*names)[i]->name : SYMBOL_NULL;
+                out.type = type;
+            }
+            return range;
+        }
+
+        Ref convert(const Type* type, const List<Function::Parameter>* names = nullptr)
+        {
+            Ref ref = FlatAST::NONE;
+
+            switch((type != nullptr) ? type->type : (uint8_t) TYPE_INVALID)
+            {
+                case TYPE_PTR:
+                {
+                    FlatAST::Pointer node = { type->flags.all, convert(type->data.pointer) };
+                    ref = add(FLAT_TYPE_POINTER, m_flat->pointers, node);
+                    break;
+                }
+                case TYPE_ARRAY:
+                {
+                    FlatAST::Array node = { type->flags.all, convert(type->data.array.size), convert(type->data.array.elements), type->data.array.count };
+                    ref = add(FLAT_TYPE_ARRAY, m_flat->arrays, node);
+                    break;
+                }
+                case TYPE_FUNCTION:
+                {
+                    Ref return_type = convert(type->data.function.return_type);
+                    FlatAST::Signature node = { type->flags.all, return_type, convert_parameters(&type->data.function.parameters, names) };
+                    ref = add(FLAT_TYPE_FUNCTION, m_flat->signatures, node);
+                    break;
+                }
+                case TYPE_INVALID: { break; }
+                default:
+                {
+                    FlatAST::Immediate immediate = {};
+                    immediate.fields.type = type->type;
+                    immediate.fields.flags = type->flags.all;
+                    if((type->type == TYPE_COMPOSITE) && (type->data.composite != nullptr))
+                    {
+                        immediate.fields.composite = type->data.composite->type;
+                    }
+                    ref = FlatAST::make_ref(FLAT_TYPE_IMMEDIATE, immediate.all);
+                    break;
+                }
+            }
+
+            return ref;
+        }
+
+        Ref convert(const Expression* expr)
+        {
+            Ref ref = FlatAST::NONE;
+
+            switch((expr != nullptr) ? expr->type : (uint8_t) EXPR_INVALID)
+            {
+                case EXPR_IDENTIFIER:
+                {
+                    ref = add(FLAT_EXPR_IDENTIFIER, m_flat->identifiers, expr->data.identifier);
+                    break;
+                }
+                case EXPR_LITERAL:
+                {
+                    const Literal& literal = expr->data.literal;
+
+                    FlatAST::Literal node = {};
+                    node.type = literal.type;
+                    node.suffix = literal.suffix;
+                    switch(literal.type)
+                    {
+                        case LITERAL_STRING: { node.data.string = literal.data.string.id; break; }
+                        case LITERAL_CHAR:   { node.data.character = literal.data.character; break; }
+                        case LITERAL_FLOAT:  { node.data.float_value = literal.data.float_value; break; }
+                        default:             { node.data.integer_value = literal.data.integer_value; break; }
+                    }
+
+                    ref = add(FLAT_EXPR_LITERAL, m_flat->literals, node);
+                    break;
+                }
+                case EXPR_OPERATION:
+                {
+                    const Expression::Operation& op = expr->data.operation;
+                    FlatAST::Operation node = { op.op, convert(op.lhs), convert(op.rhs) };
+                    ref = add(FLAT_EXPR_OPERATION, m_flat->operations, node);
+                    break;
+                }
+                case EXPR_SUB_EXPR:
+                {
+                    ref = add(FLAT_EXPR_SUB_EXPR, m_flat->sub_exprs, convert(expr->data.sub_expr));
+                    break;
+                }
+                case EXPR_STATIC_CAST:
+                {
+                    FlatAST::Cast node = { convert(expr->data.cast.type), convert(expr->data.cast.expr) };
+                    ref = add(FLAT_EXPR_CAST, m_flat->casts, node);
+                    break;
+                }
+                case EXPR_FUNCTION_CALL:
+                {
+                    Ref function = convert(expr->data.func_call.function);
+                    FlatAST::Call node = { function, convert_list(&expr->data.func_call.arguments) };
+                    ref = add(FLAT_EXPR_CALL, m_flat->calls, node);
+                    break;
+                }
+                case EXPR_INITIALIZER:
+                {
+                    ref = add(FLAT_EXPR_INITIALIZER, m_flat->expr_lists, convert_list(&expr->data.initializer));
+                    break;
+                }
+                case EXPR_COMPOUND_EXPR:
+                {
+                    ref = add(FLAT_EXPR_COMPOUND, m_flat->expr_lists, convert_list(&expr->data.compound_expr));
+                    break;
+                }
+                default: { break; }
+            }
+
+            return ref;
+        }
+
+        Ref convert(const Statement* stmt)
+        {
+            Ref ref = FlatAST::NONE;
+
+            // only the statements the parser produces have a flat form
+            switch((stmt != nullptr) ? stmt->type : (uint8_t) STMT_INVALID)
+            {
+                case STMT_EXPR:
+                {
+                    ref = add(FLAT_STMT_EXPR, m_flat->expr_stmts, convert(stmt->data.expr));
+                    break;
+                }
+                case STMT_RETURN:
+                {
+                    ref = add(FLAT_STMT_RETURN, m_flat->return_stmts, convert(stmt->data.ret_stmt.expression));
+                    break;
+                }
+                case STMT_IF:
+                {
+                    const Statement::CondExec& cond = stmt->data.cond_exec;
+                    Ref condition = convert(cond.condition);
+                    Ref on_true = convert(cond.on_true);
+                    FlatAST::If node = { condition, on_true, convert(cond.on_false) };
+                    ref = add(FLAT_STMT_IF, m_flat->if_stmts, node);
+                    break;
+                }
+                case STMT_FOR:
+                {
+                    const Statement::ForLoop& loop = stmt->data.for_loop;
+                    Ref init = convert(loop.init);
+                    Ref cond = convert(loop.cond);
+                    Ref step = convert(loop.step);
+                    FlatAST::For node = { init, cond, step, convert(loop.body) };
+                    ref = add(FLAT_STMT_FOR, m_flat->for_stmts, node);
+                    break;
+                }
+                case STMT_WHILE:
+                {
+                    Ref cond = convert(stmt->data.while_loop.cond);
+                    FlatAST::While node = { cond, convert(stmt->data.while_loop.body) };
+                    ref = add(FLAT_STMT_WHILE, m_flat->while_stmts, node);
+                    break;
+                }
+                case STMT_BLOCK:
+                {
+                    ref = add(FLAT_STMT_BLOCK, m_flat->blocks, convert_list(&stmt->data.block.statements));
+                    break;
+                }
+                case STMT_DECLARATION:
+                {
+                    ref = add(FLAT_STMT_DECLARATION, m_flat->declarations, convert_list(&stmt->data.declarations));
+                    break;
+                }
+                default: { break; }
+            }
+
+            return ref;
+        }
+
+        Ref convert(const Declaration* decl)
+        {
+            Ref ref = FlatAST::NONE;
+
+            switch(decl->type)
+            {
+                case DECL_VARIABLE:
+                {
+                    Ref type = convert(decl->data.variable.type);
+                    FlatAST::Variable node = { decl->name, type, convert(decl->data.variable.value) };
+                    ref = add(FLAT_DECL_VARIABLE, m_flat->variables, node);
+                    break;
+                }
+                case DECL_FUNCTION:
+                {
+                    Ref type = convert(decl->data.function.type, decl->data.function.parameters);
+                    FlatAST::Function node = { decl->name, type, convert_body(decl->data.function.body) };
+                    ref = add(FLAT_DECL_FUNCTION, m_flat->functions, node);
+                    break;
+                }
+                case DECL_COMPOSITE:
+                {
+                    const Composite* data = decl->data.composite.data;
+                    uint8_t type = (data != nullptr) ? data->type : (uint8_t) COMP_TYPE_INVALID;
+                    FlatAST::Composite node = { decl->name, type, convert_body(decl->data.composite.body) };
+                    ref = add(FLAT_DECL_COMPOSITE, m_flat->composites, node);
+                    break;
+                }
+                case DECL_ENUMERATOR:
+                {
+                    ref = add(FLAT_DECL_ENUMERATOR, m_flat->enumerators, decl->name);
+                    break;
+                }
+                default: { break; }
+            }
+
+            return ref;
+        }
+
+    public:
+        Flattener(FlatAST* flat)
+        {
+            m_flat = flat;
+            m_status = true;
+        }
+
+        bool run(const AST* ast)
+        {
+            m_flat->symbols = ast->symbols;
+            m_flat->strings = ast->strings;
+            m_flat->statements = convert_list(&ast->statements);
+
+            return m_status;
+        }
+    };
+
+    template<typename T>
+    size_t pool_bytes(const std::vector<T>& pool)
+    {
+        return pool.size() * sizeof(T);
+    }
+}
+
+const FlatAST::Ref FlatAST::NONE;
+
+size_t FlatAST::bytes() const
+{
+    return pool_bytes(identifiers) + pool_bytes(literals) + pool_bytes(operations) + pool_bytes(sub_exprs) +
+           pool_bytes(casts) + pool_bytes(calls) + pool_bytes(expr_lists) +
+           pool_bytes(expr_stmts) + pool_bytes(if_stmts) + pool_bytes(return_stmts) + pool_bytes(for_stmts) +
+           pool_bytes(while_stmts) + pool_bytes(blocks) + pool_bytes(declarations) +
+           pool_bytes(variables) + pool_bytes(functions) + pool_bytes(composites) + pool_bytes(enumerators) +
+           pool_bytes(pointers) + pool_bytes(arrays) + pool_bytes(signatures) + pool_bytes(parameters) +
+           pool_bytes(refs);
+}
+
+size_t FlatAST::nodes() const
+{
+    return identifiers.size() + literals.size() + operations.size() + sub_exprs.size() +
+           casts.size() + calls.size() + expr_lists.size() +
+           expr_stmts.size() + if_stmts.size() + return_stmts.size() + for_stmts.size() +
+           while_stmts.size() + blocks.size() + declarations.size() +
+           variables.size() + functions.size() + composites.size() + enumerators.size() +
+           pointers.size() + arrays.size() + signatures.size() + parameters.size();
+}
+
+bool flatten_ast(const AST* ast, FlatAST* flat)
+{
+    Flattener flattener(flat);
+    return flattener.run(ast);
+}
@@ -0,0 +1,615 @@
+#include <flat_ast_printer.hpp>
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <ascii.hpp>
+
+extern const char* TAB_STR[]; // ast_printer.cpp
+
+FlatAST_Printer::FlatAST_Printer(const FlatAST* ast)
+{
+    m_ast = ast;
+}
+
+void FlatAST_Printer::print(const char* format, ...)
+{
+    for(unsigned int i = 0; i < m_tab_stack.size(); i++)
+    {
+        printf("%s", TAB_STR[m_tab_stack[i]]);
+    }
+
+    printf("%s", TAB_STR[TAB::JOINT]);
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(stdout, format, args);
+    va_end(args);
+}
+
+void FlatAST_Printer::print_statement(unsigned int indent, Ref stmt)
+{
+    uint32_t index = FlatAST::index_of(stmt);
+
+    switch(FlatAST::kind_of(stmt))
+    {
+        case FLAT_STMT_DECLARATION:
+        {
+            print_decl_list(indent, m_ast->declarations[index]);
+            break;
+        }
+        case FLAT_STMT_EXPR:
+        {
+            print("EXPR:\n");
+            print_expr(indent, m_ast->expr_stmts[index]);
+            break;
+        }
+        case FLAT_STMT_FOR:
+        {
+            print("FOR:\n");
+            print_for_stmt(indent, &m_ast->for_stmts[index]);
+            break;
+        }
+        case FLAT_STMT_WHILE:
+        {
+            print("WHILE:\n");
+            print_while_stmt(indent, &m_ast->while_stmts[index]);
+            break;
+        }
+        case FLAT_STMT_IF:
+        {
+            print("IF:\n");
+            print_if_stmt(indent, &m_ast->if_stmts[index]);
+            break;
+        }
+        case FLAT_STMT_BLOCK:
+        {
+            print("BLOCK:\n");
+            print_body(TAB::SPACE, m_ast->blocks[index]);
+            break;
+        }
+        case FLAT_STMT_RETURN:
+        {
+            print("RETURN:\n");
+            print_expr(indent, m_ast->return_stmts[index]);
+            break;
+        }
+    }
+}
+
+void FlatAST_Printer::print_for_stmt(unsigned int indent, const FlatAST::For* loop)
+{
+    m_tab_stack.push_back(indent);
+
+    print("INIT:\n");
+    m_tab_stack.push_back(indent);
+    print_statement(TAB::SPACE, loop->init);
+    m_tab_stack.pop_back();
+
+    print("COND:\n");
+    print_expr(TAB::LINE, loop->cond);
+
+    print("STEP:\n");
+    print_expr(TAB::LINE, loop->step);
+
+    print("BODY:\n");
+    m_tab_stack.push_back(TAB::SPACE);
+    print_statement(TAB::SPACE, loop->body);
+    m_tab_stack.pop_back();
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_while_stmt(unsigned int indent, const FlatAST::While* loop)
+{
+    m_tab_stack.push_back(indent);
+
+    print("COND:\n");
+    print_expr(TAB::LINE, loop->cond);
+
+    print("BODY:\n");
+    m_tab_stack.push_back(TAB::SPACE);
+    print_statement(TAB::SPACE, loop->body);
+    m_tab_stack.pop_back();
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_if_stmt(unsigned int indent, const FlatAST::If* stmt)
+{
+    m_tab_stack.push_back(indent);
+
+    print("COND:\n");
+    print_expr(TAB::LINE, stmt->condition);
+
+    print("ON_TRUE:\n");
+    m_tab_stack.push_back(stmt->on_false == FlatAST::NONE ? TAB::SPACE : TAB::LINE);
+    print_statement(TAB::SPACE, stmt->on_true);
+    m_tab_stack.pop_back();
+
+    if(stmt->on_false != FlatAST::NONE)
+    {
+        print("ON_FALSE:\n");
+        m_tab_stack.push_back(TAB::SPACE);
+        print_statement(TAB::SPACE, stmt->on_false);
+        m_tab_stack.pop_back();
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_body(unsigned int indent, Range body)
+{
+    m_tab_stack.push_back(indent);
+
+    for(unsigned int i = 0; i < body.count; i++)
+    {
+        print_statement((i + 1 == body.count) ? TAB::SPACE : TAB::LINE, m_ast->refs[body.first + i]);
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_expr(unsigned int indent, Ref expr)
+{
+    uint8_t kind = FlatAST::kind_of(expr);
+    uint32_t index = FlatAST::index_of(expr);
+
+    if(kind == FLAT_EXPR_LITERAL)
+    {
+        print_literal(TAB::SPACE, &m_ast->literals[index]);
+    }
+    else if(kind == FLAT_EXPR_IDENTIFIER)
+    {
+        print_identifier(TAB::SPACE, m_ast->identifiers[index]);
+    }
+    else
+    {
+        m_tab_stack.push_back(indent);
+
+        if(kind == FLAT_EXPR_CALL)
+        {
+            print("FUNC CALL:\n");
+            print_func_call(TAB::SPACE, &m_ast->calls[index]);
+        }
+        else if(kind == FLAT_EXPR_SUB_EXPR)
+        {
+            print("SUB-EXPR:\n");
+            print_expr(TAB::SPACE, m_ast->sub_exprs[index]);
+        }
+        else if(kind == FLAT_EXPR_CAST)
+        {
+            const FlatAST::Cast* cast = &m_ast->casts[index];
+
+            print("CAST:\n");
+            m_tab_stack.push_back(TAB::SPACE);
+
+            print("TYPE:\n");
+            print_type(TAB::LINE, cast->type);
+            print("EXPR:\n");
+            print_expr(TAB::SPACE, cast->expr);
+
+            m_tab_stack.pop_back();
+        }
+        else if(kind == FLAT_EXPR_OPERATION)
+        {
+            const FlatAST::Operation* op = &m_ast->operations[index];
+            if((op->op == EXPR_OP_INCREMENT) || (op->op == EXPR_OP_DECREMENT))
+            {
+                const char* name = (op->op == EXPR_OP_INCREMENT) ? "INCREMENT" : "DECREMENT";
+                if(op->lhs != FlatAST::NONE)
+                {
+                    print("POST-%s:\n", name);
+                    print_expr(TAB::SPACE, op->lhs);
+                }
+                else
+                {
+                    print("PRE-%s:\n", name);
+                    print_expr(TAB::SPACE, op->rhs);
+                }
+            }
+            else if(op->lhs == FlatAST::NONE)
+            {
+                switch(op->op)
+                {
+                    case EXPR_OP_DEREFERENCE:        { print("DEREFERENCE:\n"); break; }
+                    case EXPR_OP_REFERENCE:          { print("REFERENCE:\n"); break; }
+                    case EXPR_OP_LOGICAL_NOT:        { print("NOT:\n"); break; }
+                    case EXPR_OP_BITWISE_COMPLEMENT: { print("COMPLEMENT:\n"); break; }
+                }
+                print_expr_operation(TAB::SPACE, op->rhs);
+            }
+            else
+            {
+                print("%s:\n", op_name(op->op));
+                print_expr_operation(TAB::SPACE, op->lhs, op->rhs);
+            }
+        }
+
+        m_tab_stack.pop_back();
+    }
+}
+
+void FlatAST_Printer::print_expr_operation(unsigned int indent, Ref expr)
+{
+    m_tab_stack.push_back(indent);
+
+    print_expr(TAB::SPACE, expr);
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_expr_operation(unsigned int indent, Ref lhs, Ref rhs)
+{
+    m_tab_stack.push_back(indent);
+
+    print("LHS:\n");
+    print_expr(TAB::LINE, lhs);
+
+    print("RHS:\n");
+    print_expr(TAB::SPACE, rhs);
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_suffix(uint8_t suffix)
+{
+    if(suffix != TK_TYPE_INVALID)
+    {
+        printf(" %s", type_name(suffix));
+    }
+    printf("\n");
+}
+
+void FlatAST_Printer::print_literal(unsigned int indent, const FlatAST::Literal* literal)
+{
+    m_tab_stack.push_back(indent);
+
+    switch (literal->type)
+    {
+        case LITERAL_INTEGER:
+        {
+            if((literal->suffix >= TK_TYPE_I8) && (literal->suffix <= TK_TYPE_I64))
+            {
+                print("INTEGER: %lld", (long long) literal->data.integer_value);
+            }
+            else
+            {
+                print("INTEGER: %llu", (unsigned long long) literal->data.integer_value);
+            }
+            print_suffix(literal->suffix);
+            break;
+        }
+        case LITERAL_FLOAT:
+        {
+            print("FLOAT: %f", literal->data.float_value);
+            print_suffix(literal->suffix);
+            break;
+        }
+        case LITERAL_CHAR:
+        {
+            print("CHAR: '%c'\n", literal->data.character);
+            break;
+        }
+        case LITERAL_STRING:
+        {
+            const strptr& str = m_ast->strings->get(literal->data.string);
+
+            print("STRING: \"");
+            for (unsigned int i = 0; i < str.len; i++)
+            {
+                char c = str.ptr[i];
+                if (IS_ALPHA_NUM(c) || (c == ' ')) {
+                    putchar(c);
+                } else {
+                    printf("'0x%hhX'", c);
+                }
+            }
+            printf("\"\n");
+            break;
+        }
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_func_call(unsigned int indent, const FlatAST::Call* call)
+{
+    m_tab_stack.push_back(indent);
+
+    print("FUNCTION:\n");
+    print_expr(TAB::LINE, call->function);
+
+    print("ARGUMENTS:\n");
+    m_tab_stack.push_back(TAB::SPACE);
+    Range args = call->arguments;
+    for(unsigned int i = 0; i < args.count; i++)
+    {
+        print("ARG\n");
+        print_expr((i + 1 == args.count) ? TAB::SPACE : TAB::LINE, m_ast->refs[args.first + i]);
+    }
+
+    m_tab_stack.pop_back();
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_parameter(unsigned int indent, const FlatAST::Parameter* param)
+{
+    m_tab_stack.push_back(indent);
+
+    print_name(param->name);
+    print("DATATYPE:\n");
+    print_type(TAB::SPACE, param->type);
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_parameter_list(unsigned int indent, Range list)
+{
+    m_tab_stack.push_back(indent);
+
+    for (unsigned int i = 0; i < list.count; i++)
+    {
+        print("PARAM:\n");
+        print_parameter((i + 1 == list.count) ? TAB::SPACE : TAB::LINE, &m_ast->parameters[list.first + i]);
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_identifier(unsigned int indent, uint32_t id)
+{
+    m_tab_stack.push_back(indent);
+
+    if(id != SYMBOL_NULL)
+    {
+        const strptr& name = m_ast->symbols->get(id);
+        print("IDENTIFIER: %.*s\n", name.len, name.ptr);
+    }
+    else
+    {
+        print("IDENTIFIER: NULL\n");
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_name(uint32_t id)
+{
+    if(id != SYMBOL_NULL)
+    {
+        const strptr& name = m_ast->symbols->get(id);
+        print("NAME: %.*s\n", name.len, name.ptr);
+    }
+    else
+    {
+        print("NAME: NULL\n");
+    }
+}
+
+void FlatAST_Printer::print_array(unsigned int indent, const FlatAST::Array* array)
+{
+    m_tab_stack.push_back(indent);
+
+    print("DATATYPE:\n");
+    print_type(TAB::LINE, array->elements);
+    if(array->size != FlatAST::NONE)
+    {
+        print("SIZE:\n");
+        print_expr(TAB::SPACE, array->size);
+    }
+    else
+    {
+        print("SIZE: NONE\n");
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_type_flags(unsigned int indent, uint8_t flags)
+{
+    m_tab_stack.push_back(indent);
+
+    Type::Flags bits = {};
+    bits.all = flags;
+
+    if (bits.bits.is_external_symbol)
+    {
+        print("EXTERN\n");
+    }
+    if (bits.bits.is_constant)
+    {
+        print("CONST\n");
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_type(unsigned int indent, Ref type)
+{
+    m_tab_stack.push_back(indent);
+
+    uint32_t index = FlatAST::index_of(type);
+
+    uint8_t kind = TYPE_INVALID;
+    uint8_t flags = 0;
+    switch(FlatAST::kind_of(type))
+    {
+        case FLAT_TYPE_IMMEDIATE:
+        {
+            FlatAST::Immediate immediate = {};
+            immediate.all = index;
+            kind = immediate.fields.type;
+            flags = immediate.fields.flags;
+            break;
+        }
+        case FLAT_TYPE_POINTER:  { kind = TYPE_PTR;      flags = m_ast->pointers[index].flags;   break; }
+        case FLAT_TYPE_ARRAY:    { kind = TYPE_ARRAY;    flags = m_ast->arrays[index].flags;     break; }
+        case FLAT_TYPE_FUNCTION: { kind = TYPE_FUNCTION; flags = m_ast->signatures[index].flags; break; }
+    }
+
+    if(flags == 0x0)
+    {
+        print("FLAGS: NONE\n");
+    }
+    else
+    {
+        print("FLAGS:\n");
+        print_type_flags(TAB::LINE, flags);
+    }
+
+    switch (kind)
+    {
+        case TYPE_VOID: { print("TYPE: VOID\n"); break; }
+        case TYPE_U8:   { print("TYPE: U8\n");   break; }
+        case TYPE_U16:  { print("TYPE: U16\n");  break; }
+        case TYPE_U32:  { print("TYPE: U32\n");  break; }
+        case TYPE_U64:  { print("TYPE: U64\n");  break; }
+        case TYPE_I8:   { print("TYPE: I8\n");   break; }
+        case TYPE_I16:  { print("TYPE: I16\n");  break; }
+        case TYPE_I32:  { print("TYPE: I32\n");  break; }
+        case TYPE_I64:  { print("TYPE: I64\n");  break; }
+        case TYPE_F32:  { print("TYPE: F32\n");  break; }
+        case TYPE_F64:  { print("TYPE: F64\n");  break; }
+        case TYPE_PTR:
+        {
+            print("TYPE: PTR\n");
+            print_type(TAB::SPACE, m_ast->pointers[index].target);
+            break;
+        }
+        case TYPE_ARRAY:
+        {
+            print("TYPE: ARRAY\n");
+            print_array(TAB::LINE, &m_ast->arrays[index]);
+            break;
+        }
+        case TYPE_FUNCTION:
+        {
+            const FlatAST::Signature* function = &m_ast->signatures[index];
+
+            print("TYPE: FUNCTION\n");
+            m_tab_stack.push_back(TAB::SPACE);
+
+            print("RETURN:\n");
+            print_type(TAB::LINE, function->return_type);
+
+            if(function->parameters.count == 0)
+            {
+                print("PARAMS: NONE\n");
+            }
+            else
+            {
+                print("PARAMS:\n");
+                print_parameter_list(TAB::SPACE, function->parameters);
+            }
+
+            m_tab_stack.pop_back();
+            break;
+        }
+        case TYPE_COMPOSITE:
+        {
+            print("TYPE: COMPOSITE\n");
+            break;
+        }
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_decl_list(unsigned int indent, Range decl_list)
+{
+    for (unsigned int i = 0; i < decl_list.count; i++)
+    {
+        Ref decl = m_ast->refs[decl_list.first + i];
+        uint32_t index = FlatAST::index_of(decl);
+
+        switch(FlatAST::kind_of(decl))
+        {
+            case FLAT_DECL_VARIABLE:
+            {
+                print("DECL:\n");
+                print_decl_variable(indent, &m_ast->variables[index]);
+                break;
+            }
+            case FLAT_DECL_FUNCTION:
+            {
+                print("DECL:\n");
+                print_decl_function(indent, &m_ast->functions[index]);
+                break;
+            }
+            case FLAT_DECL_COMPOSITE:
+            {
+                print("DECL: COMPOSITE\n");
+                m_tab_stack.push_back(indent);
+                print_name(m_ast->composites[index].name);
+                m_tab_stack.pop_back();
+                break;
+            }
+            case FLAT_DECL_ENUMERATOR:
+            {
+                print("DECL: ENUMERATOR\n");
+                m_tab_stack.push_back(indent);
+                print_name(m_ast->enumerators[index]);
+                m_tab_stack.pop_back();
+                break;
+            }
+        }
+    }
+}
+
+void FlatAST_Printer::print_decl_variable(unsigned int indent, const FlatAST::Variable* decl)
+{
+    m_tab_stack.push_back(indent);
+
+    print_name(decl->name);
+
+    bool init_value = (decl->value != FlatAST::NONE);
+
+    print("TYPE:\n");
+    print_type(init_value ? TAB::LINE : TAB::SPACE, decl->type);
+
+    if (init_value)
+    {
+        print("VALUE:\n");
+        print_expr(TAB::SPACE, decl->value);
+    }
+    else
+    {
+        print("VALUE: NULL\n");
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::print_decl_function(unsigned int indent, const FlatAST::Function* decl)
+{
+    m_tab_stack.push_back(indent);
+
+    print_name(decl->name);
+
+    print("TYPE:\n");
+    print_type(TAB::LINE, decl->type);
+
+    if(decl->body.first == FlatAST::NONE)
+    {
+        print("BODY: NULL\n");
+    }
+    else
+    {
+        print("BODY:\n");
+        print_body(TAB::SPACE, decl->body);
+    }
+
+    m_tab_stack.pop_back();
+}
+
+void FlatAST_Printer::Print(const FlatAST* ast)
+{
+    FlatAST_Printer printer(ast);
+
+    printf("AST:\n");
+    for (unsigned int i = 0; i < ast->statements.count; i++)
+    {
+        printer.print_statement((i + 1 == ast->statements.count) ? TAB::SPACE : TAB::LINE, ast->refs[ast->statements.first + i]);
+    }
+}
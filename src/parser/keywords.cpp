@@ -0,0 +1,139 @@
+#include <keywords.hpp>
+
+#include <string.h>
+
+#include <token.hpp>
+
+// To add a keyword, add its spelling here. The hash seed and slot layout are
+// recomputed by the compiler and the build fails if no perfect seed exists.
+static constexpr struct
+{
+    const char* spelling;
+    uint8_t     token;
+    uint8_t     subtype;
+} KEYWORDS[] =
+{
+    { "void",      TK_TYPE,             TK_TYPE_VOID },
+    { "U8",        TK_TYPE,             TK_TYPE_U8   },
+    { "U16",       TK_TYPE,             TK_TYPE_U16  },
+    { "U32",       TK_TYPE,             TK_TYPE_U32  },
+    { "U64",       TK_TYPE,             TK_TYPE_U64  },
+    { "I8",        TK_TYPE,             TK_TYPE_I8   },
+    { "I16",       TK_TYPE,             TK_TYPE_I16  },
+    { "I32",       TK_TYPE,             TK_TYPE_I32  },
+    { "I64",       TK_TYPE,             TK_TYPE_I64  },
+    { "F32",       TK_TYPE,             TK_TYPE_F32  },
+    { "F64",       TK_TYPE,             TK_TYPE_F64  },
+    { "if",        TK_IF,               0 },
+    { "else",      TK_ELSE,             0 },
+    { "for",       TK_FOR,              0 },
+    { "while",     TK_WHILE,            0 },
+    { "switch",    TK_SWITCH,           0 },
+    { "case",      TK_CASE,             0 },
+    { "default",   TK_DEFAULT,          0 },
+    { "break",     TK_BREAK,            0 },
+    { "continue",  TK_CONTINUE,         0 },
+    { "goto",      TK_GOTO,             0 },
+    { "return",    TK_RETURN,           0 },
+    { "or",        TK_OR,               0 },
+    { "and",       TK_AND,              0 },
+    { "const",     TK_CONST,            0 },
+    { "extern",    TK_EXTERN,           0 },
+    { "static",    TK_STATIC,           0 },
+    { "struct",    TK_STRUCT,           0 },
+    { "union",     TK_UNION,            0 },
+    { "enum",      TK_ENUM,             0 },
+    { "typedef",   TK_TYPEDEF,          0 },
+    { "namespace", TK_NAMESPACE,        0 },
+    { "cast",      TK_STATIC_CAST,      0 },
+    { "r_cast",    TK_REINTERPRET_CAST, 0 }
+};
+
+static constexpr unsigned int KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+static constexpr unsigned int MAX_LENGTH    = 16;
+static constexpr unsigned int TABLE_BITS    = 7;
+static constexpr unsigned int TABLE_SIZE    = 1u << TABLE_BITS;
+
+static constexpr unsigned int length(const char* str)
+{
+    unsigned int len = 0;
+    while(str[len] != 0) { len++; }
+    return len;
+}
+
+// packs the length, the first two and the last character into one word; a
+// one character identifier reuses its first character instead of reading past it
+static constexpr uint32_t key(const char* str, unsigned int len)
+{
+    return ((uint32_t) (uint8_t) str[0]) |
+           ((uint32_t) (uint8_t) str[len > 1 ? 1 : 0] << 8) |
+           ((uint32_t) (uint8_t) str[len - 1] << 16) |
+           ((uint32_t) len << 24);
+}
+
+static constexpr uint32_t slot(uint32_t key, uint32_t seed)
+{
+    return (key * seed) >> (32 - TABLE_BITS);
+}
+
+static constexpr bool is_perfect(uint32_t seed)
+{
+    bool used[TABLE_SIZE] = {};
+    for(unsigned int i = 0; i < KEYWORD_COUNT; i++)
+    {
+        uint32_t s = slot(key(KEYWORDS[i].spelling, length(KEYWORDS[i].spelling)), seed);
+        if(used[s]) { return false; }
+        used[s] = true;
+    }
+    return true;
+}
+
+static constexpr uint32_t find_seed()
+{
+    for(uint32_t seed = 0x9E3779B1u; seed < 0x9E3779B1u + 0x20000u; seed += 2)
+    {
+        if(is_perfect(seed)) { return seed; }
+    }
+    return 0;
+}
+
+static constexpr uint32_t SEED = find_seed();
+static_assert(SEED != 0, "no perfect hash seed for the keyword table, increase TABLE_BITS");
+
+struct KeywordTable
+{
+    Keyword slots[TABLE_SIZE];
+};
+
+static constexpr KeywordTable build_table()
+{
+    KeywordTable table = {};
+    for(unsigned int i = 0; i < KEYWORD_COUNT; i++)
+    {
+        unsigned int len = length(KEYWORDS[i].spelling);
+        Keyword& kw = table.slots[slot(key(KEYWORDS[i].spelling, len), SEED)];
+        kw.spelling = KEYWORDS[i].spelling;
+        kw.len      = (uint8_t) len;
+        kw.token    = KEYWORDS[i].token;
+        kw.subtype  = KEYWORDS[i].subtype;
+    }
+    return table;
+}
+
+static constexpr KeywordTable TABLE = build_table();
+
+const Keyword* Keywords::Find(const char* str, unsigned int len)
+{
+    const Keyword* kw = nullptr;
+
+    if((len > 0) && (len <= MAX_LENGTH))
+    {
+        const Keyword& entry = TABLE.slots[slot(key(str, len), SEED)];
+        if((entry.len == len) && (memcmp(entry.spelling, str, len) == 0))
+        {
+            kw = &entry;
+        }
+    }
+
+    return kw;
+}
@@ -0,0 +1,23 @@
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+#include <stdint.h>
+
+struct Keyword
+{
+    const char* spelling;
+    uint8_t     len;
+    uint8_t     token;   // TOKEN
+    uint8_t     subtype; // TK_TYPE_* when token is TK_TYPE
+};
+
+// Keyword recognizer backed by a perfect hash that is generated at compile
+// time from the table in keywords.cpp: one probe and one compare per lookup.
+class Keywords
+{
+public:
+    // returns the keyword spelled by [str, str + len), or nullptr for identifiers
+    static const Keyword* Find(const char* str, unsigned int len);
+};
+
+#endif // KEYWORDS_HPP
@@ -0,0 +1,411 @@
+#include <layout_engine.hpp>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+#include <diagnostics.hpp>
+
+namespace
+{
+    // bytes of TYPE_VOID to TYPE_F64, indexed by type
+    const uint8_t WIDTH[TYPE_F64 + 1] = { 0, 0, 1, 2, 4, 8, 1, 2, 4, 8, 4, 8 };
+
+    const uint32_t POINTER_SIZE = 8;
+
+    uint64_t round_up(uint64_t value, uint32_t align)
+    {
+        return (value + align - 1) & ~((uint64_t) align - 1);
+    }
+
+    // Gives every field its offset in the order of the vector and returns
+    // the size, rounded up to align.
+    uint64_t place(std::vector<Layout::Field>& fields, bool is_union, uint32_t align)
+    {
+        uint64_t end = 0;
+        for(Layout::Field& field : fields)
+        {
+            if(is_union)
+            {
+                field.offset = 0;
+                end = std::max(end, field.size);
+            }
+            else
+            {
+                field.offset = round_up(end, field.align);
+                end = field.offset + field.size;
+            }
+        }
+        return round_up(end, align);
+    }
+
+    // lines spanned by size bytes starting at offset start of a line
+    uint64_t span(uint64_t start, uint64_t size)
+    {
+        return (size == 0) ? 0 : (start + size + Layout::CACHE_LINE - 1) / Layout::CACHE_LINE;
+    }
+}
+
+uint64_t Layout::lines() const
+{
+    return span(0, size);
+}
+
+uint64_t Layout::worst_lines() const
+{
+    return span((align < CACHE_LINE) ? (CACHE_LINE - align) : 0, size);
+}
+
+LayoutEngine::LayoutEngine(AST* ast, bool reorder)
+{
+    m_ast = ast;
+    m_reorder = reorder;
+    m_errors = 0;
+}
+
+void LayoutEngine::diagnose(const Declaration* decl, const char* format, ...)
+{
+    m_errors++;
+
+    Diagnostics::Print("error: in %s: ", describe(decl).c_str());
+
+    va_list args;
+    va_start(args, format);
+    Diagnostics::VPrint(format, args);
+    va_end(args);
+}
+
+std::string LayoutEngine::describe(const Declaration* decl) const
+{
+    std::string out = (decl->data.composite.data->type == COMP_TYPE_UNION) ? "union " : "struct ";
+    if(decl->name == SYMBOL_NULL)
+    {
+        out += "<anonymous>";
+    }
+    else
+    {
+        const strptr& n = m_ast->symbols->get(decl->name);
+        out += "'" + std::string(n.ptr, n.len) + "'";
+    }
+    return out;
+}
+
+void LayoutEngine::collect(const Statement* stmt)
+{
+    if(stmt != nullptr)
+    {
+        switch(stmt->type)
+        {
+            case STMT_DECLARATION:
+            {
+                for(const Declaration* decl : stmt->data.declarations)
+                {
+                    collect(decl);
+                }
+                break;
+            }
+            case STMT_BLOCK:
+            {
+                for(const Statement* s : stmt->data.block.statements)
+                {
+                    collect(s);
+                }
+                break;
+            }
+            case STMT_IF:
+            {
+                collect(stmt->data.cond_exec.on_true);
+                collect(stmt->data.cond_exec.on_false);
+                break;
+            }
+            case STMT_WHILE:  { collect(stmt->data.while_loop.body); break; }
+            case STMT_SWITCH: { collect(stmt->data.switch_stmt.body); break; }
+            case STMT_FOR:
+            {
+                collect(stmt->data.for_loop.init);
+                collect(stmt->data.for_loop.body);
+                break;
+            }
+            default: { break; }
+        }
+    }
+}
+
+void LayoutEngine::collect(const Declaration* decl)
+{
+    const List<Statement>* body = nullptr;
+    if(decl->type == DECL_COMPOSITE)
+    {
+        // a declaration without a body only refers to the composite
+        if(decl->data.composite.body != nullptr)
+        {
+            m_composites[decl->data.composite.data] = decl;
+            m_order.push_back(decl);
+        }
+        body = decl->data.composite.body;
+    }
+    else if(decl->type == DECL_FUNCTION)
+    {
+        body = decl->data.function.body;
+    }
+
+    if(body != nullptr)
+    {
+        for(const Statement* stmt : *body)
+        {
+            collect(stmt);
+        }
+    }
+}
+
+bool LayoutEngine::measure(const Declaration* owner, uint32_t field, const Type* type, uint64_t* size, uint32_t* align)
+{
+    bool status = true;
+    const strptr& n = m_ast->symbols->get(field);
+
+    switch(type->type)
+    {
+        case TYPE_U8:  case TYPE_U16: case TYPE_U32: case TYPE_U64:
+        case TYPE_I8:  case TYPE_I16: case TYPE_I32: case TYPE_I64:
+        case TYPE_F32: case TYPE_F64:
+        {
+            *size = WIDTH[type->type];
+            *align = WIDTH[type->type];
+            break;
+        }
+        case TYPE_PTR:
+        {
+            *size = POINTER_SIZE;
+            *align = POINTER_SIZE;
+            break;
+        }
+        case TYPE_ARRAY:
+        {
+            // T[] is a flexible array member, which takes no space; the
+            // parser has evaluated every other size
+            uint64_t count = type->data.array.count;
+            assert(count != Type::Array::UNEVALUATED);
+            count = (count == Type::Array::UNSIZED) ? 0 : count;
+
+            status = measure(owner, field, type->data.array.elements, size, align);
+            if(status && (count > 0) && (*size > UINT64_MAX / count))
+            {
+                diagnose(owner, "field '%.*s' is too large\n", n.len, n.ptr);
+                status = false;
+            }
+            *size *= count;
+            break;
+        }
+        case TYPE_COMPOSITE:
+        {
+            const Layout* inner = layout(type->data.composite);
+            if(inner != nullptr)
+            {
+                *size = inner->size;
+                *align = inner->align;
+            }
+            else
+            {
+                // one that has a body but failed to lay out has been reported
+                if(m_composites.find(type->data.composite) == m_composites.end())
+                {
+                    diagnose(owner, "field '%.*s' has an incomplete type\n", n.len, n.ptr);
+                }
+                status = false;
+            }
+            break;
+        }
+        default:
+        {
+            diagnose(owner, "field '%.*s' has a type without a size\n", n.len, n.ptr);
+            status = false;
+            break;
+        }
+    }
+
+    return status;
+}
+
+const Layout* LayoutEngine::layout(const Composite* composite)
+{
+    const Layout* result = composite->layout;
+    if(result == nullptr)
+    {
+        // composites without a body are not in the map, and those that failed
+        // to lay out map to nullptr, having been reported already
+        auto it = m_composites.find(composite);
+        const Declaration* decl = (it != m_composites.end()) ? it->second : nullptr;
+        if((decl != nullptr) && (m_pending.count(composite) != 0))
+        {
+            diagnose(decl, "contains itself\n");
+        }
+        else if(decl != nullptr)
+        {
+            m_pending.insert(composite);
+            result = compute(decl);
+            m_pending.erase(composite);
+
+            if(result != nullptr)
+            {
+                decl->data.composite.data->layout = result;
+            }
+            else
+            {
+                m_composites[composite] = nullptr;
+            }
+        }
+    }
+    return result;
+}
+
+const Layout* LayoutEngine::compute(const Declaration* decl)
+{
+    bool status = true;
+    bool is_union = decl->data.composite.data->type == COMP_TYPE_UNION;
+
+    std::vector<Layout::Field> fields;
+    uint32_t align = 1;
+    uint64_t total = 0;
+    uint64_t largest = 0;
+
+    for(const Statement* stmt : *decl->data.composite.body)
+    {
+        const List<Declaration>* decls = (stmt->type == STMT_DECLARATION) ? &stmt->data.declarations : nullptr;
+        for(unsigned int i = 0; (decls != nullptr) && (i < decls->size()); i++)
+        {
+            const Declaration* d = (*decls)[i];
+            Layout::Field field = { d->name, (uint32_t) fields.size(), 0, 0, 1 };
+            bool is_field = false;
+
+            if(d->type == DECL_VARIABLE)
+            {
+                is_field = measure(decl, d->name, d->data.variable.type, &field.size, &field.align);
+                status = status && is_field;
+            }
+            else if((d->type == DECL_COMPOSITE) && (d->name == SYMBOL_NULL) && (decls->size() == 1))
+            {
+                // an anonymous struct or union without a declarator is a member
+                const Layout* inner = layout(d->data.composite.data);
+                is_field = inner != nullptr;
+                status = status && is_field;
+                if(is_field)
+                {
+                    field.size = inner->size;
+                    field.align = inner->align;
+                }
+            }
+
+            if(is_field)
+            {
+                fields.push_back(field);
+                align = std::max(align, field.align);
+                total += field.size;
+                largest = std::max(largest, field.size);
+            }
+        }
+    }
+
+    Layout* result = nullptr;
+    if(status)
+    {
+        result = m_ast->arena.make<Layout>();
+        result->align = align;
+        result->declared_size = place(fields, is_union, align);
+        result->optimal_size = result->declared_size;
+
+        if(!is_union)
+        {
+            std::vector<Layout::Field> sorted = fields;
+            std::stable_sort(sorted.begin(), sorted.end(), [](const Layout::Field& a, const Layout::Field& b) { return a.align > b.align; });
+            result->optimal_size = place(sorted, false, align);
+
+            result->reordered = m_reorder && (result->optimal_size < result->declared_size);
+            if(result->reordered)
+            {
+                fields.swap(sorted);
+            }
+        }
+
+        result->size = result->reordered ? result->optimal_size : result->declared_size;
+        result->padding = result->size - (is_union ? largest : total);
+
+        Layout::Field* copy = static_cast<Layout::Field*>(m_ast->arena.allocate(fields.size() * sizeof(Layout::Field), alignof(Layout::Field)));
+        std::copy(fields.begin(), fields.end(), copy);
+        result->fields = copy;
+        result->count = (unsigned int) fields.size();
+    }
+
+    return result;
+}
+
+bool LayoutEngine::Compute(AST* ast, bool reorder, Report* report)
+{
+    LayoutEngine engine(ast, reorder);
+    for(const Statement* stmt : ast->statements)
+    {
+        engine.collect(stmt);
+    }
+
+    Report out = { {}, 0, 0 };
+    for(const Declaration* decl : engine.m_order)
+    {
+        const Layout* layout = engine.layout(decl->data.composite.data);
+        if(layout != nullptr)
+        {
+            out.composites.push_back(decl);
+            out.padding += layout->padding;
+            out.savings += layout->declared_size - layout->optimal_size;
+        }
+    }
+
+    if(report != nullptr)
+    {
+        *report = std::move(out);
+    }
+
+    return engine.m_errors == 0;
+}
+
+void LayoutEngine::Print(const Report& report, const Interner* symbols)
+{
+    printf("%-32s %8s %6s %8s %6s %6s %6s %8s %6s\n", "composite", "size", "align", "padding", "lines", "worst", "split", "optimal", "saves");
+
+    for(const Declaration* decl : report.composites)
+    {
+        const Composite* composite = decl->data.composite.data;
+        const Layout* layout = composite->layout;
+
+        std::string name = (composite->type == COMP_TYPE_UNION) ? "union " : "struct ";
+        if(decl->name == SYMBOL_NULL)
+        {
+            name += "<anonymous>";
+        }
+        else
+        {
+            const strptr& n = symbols->get(decl->name);
+            name.append(n.ptr, n.len);
+        }
+
+        // fields that straddle two cache lines when the instance starts on one
+        unsigned int split = 0;
+        for(unsigned int i = 0; i < layout->count; i++)
+        {
+            const Layout::Field& field = layout->fields[i];
+            if((field.size > 0) && (span(field.offset % Layout::CACHE_LINE, field.size) > span(0, field.size)))
+            {
+                split++;
+            }
+        }
+
+        printf("%-32s %8llu %6u %8llu %6llu %6llu %6u %8llu %6llu%s\n", name.c_str(),
+               (unsigned long long) layout->size, layout->align, (unsigned long long) layout->padding,
+               (unsigned long long) layout->lines(), (unsigned long long) layout->worst_lines(), split,
+               (unsigned long long) layout->optimal_size, (unsigned long long) (layout->declared_size - layout->optimal_size),
+               layout->reordered ? " (reordered)" : "");
+    }
+
+    printf("%zu composites, %llu bytes of padding, %llu bytes saved by the optimal order\n", report.composites.size(),
+           (unsigned long long) report.padding, (unsigned long long) report.savings);
+}
@@ -0,0 +1,103 @@
+#ifndef LAYOUT_ENGINE_HPP
+#define LAYOUT_ENGINE_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <ast.hpp>
+#include <interner.hpp>
+
+// The memory layout of a struct or union, for x64: every primitive is
+// aligned to its size, pointers take 8 bytes, and an array is aligned as its
+// elements are.
+struct Layout
+{
+    enum
+    {
+        CACHE_LINE = 64
+    };
+
+    struct Field
+    {
+        uint32_t name;   // symbol id, SYMBOL_NULL for an anonymous struct or union
+        uint32_t index;  // in declaration order
+        uint64_t offset;
+        uint64_t size;
+        uint32_t align;
+    };
+
+    uint64_t size;
+    uint32_t align;
+    uint64_t padding;       // bytes between the fields and after the last one
+    uint64_t declared_size; // in declaration order
+    uint64_t optimal_size;  // in the order with the least padding
+    bool     reordered;     // whether the fields are in that order
+
+    const Field* fields; // by offset
+    unsigned int count;
+
+    // cache lines an instance spans when it starts on a line, and when it
+    // starts as close to the end of one as its alignment allows
+    uint64_t lines() const;
+    uint64_t worst_lines() const;
+};
+
+// Lays out every composite of a tree that has a body. A field of a composite
+// type uses the layout of that composite, which is worked out first and kept
+// on its Composite node, so each is only laid out once however many fields
+// and declarations use it. Array types carry their element count.
+//
+// Structs keep their declaration order unless reordering is asked for, in
+// which case the fields are sorted by decreasing alignment. All sizes are a
+// multiple of their alignment, which is a power of two, so that order leaves
+// no padding between fields, and as the size is rounded up to the largest
+// alignment either way there is no order with less padding. A tree is laid
+// out in one mode or the other, not both.
+class LayoutEngine
+{
+public:
+    struct Report
+    {
+        std::vector<const Declaration*> composites; // laid out, in source order
+        uint64_t padding; // over all of them
+        uint64_t savings; // bytes the optimal order saves over all of them
+    };
+
+private:
+    AST* m_ast;
+    bool m_reorder;
+
+    std::unordered_map<const Composite*, const Declaration*> m_composites;
+    std::unordered_set<const Composite*> m_pending; // being laid out
+    std::vector<const Declaration*>      m_order;   // every composite, in source order
+
+    unsigned int m_errors;
+
+private:
+    LayoutEngine(AST* ast, bool reorder);
+
+    void diagnose(const Declaration* decl, const char* format, ...);
+    std::string describe(const Declaration* decl) const;
+
+    void collect(const Statement* stmt);
+    void collect(const Declaration* decl);
+
+    // false if the type of the field has no size
+    bool measure(const Declaration* owner, uint32_t field, const Type* type, uint64_t* size, uint32_t* align);
+    // nullptr if the composite has no body or cannot be laid out
+    const Layout* layout(const Composite* composite);
+    const Layout* compute(const Declaration* decl);
+
+public:
+    // false if any composite cannot be laid out, with the reasons printed
+    static bool Compute(AST* ast, bool reorder, Report* report = nullptr);
+
+    // a line for each composite of the report
+    static void Print(const Report& report, const Interner* symbols);
+};
+
+#endif // LAYOUT_ENGINE_HPP
@@ -0,0 +1,43 @@
+#include <line_table.hpp>
+
+#include <algorithm>
+
+#include <scan.hpp>
+
+LineTable::LineTable()
+{
+    m_built = false;
+}
+
+bool LineTable::is_built() const
+{
+    return m_built;
+}
+
+void LineTable::build(const char* data, size_t size)
+{
+    const char* end = data + size;
+
+    m_starts.clear();
+    m_starts.reserve(size / 32 + 1);
+    m_starts.push_back(0);
+
+    for(const char* ptr = Scan::FindNewline(data, end); ptr < end; ptr = Scan::FindNewline(ptr + 1, end))
+    {
+        m_starts.push_back((uint32_t) (ptr + 1 - data));
+    }
+
+    m_built = true;
+}
+
+SourceLocation LineTable::locate(uint32_t offset) const
+{
+    // the last line start at or before the offset
+    std::vector<uint32_t>::const_iterator it = std::upper_bound(m_starts.begin(), m_starts.end(), offset) - 1;
+
+    SourceLocation location = {};
+    location.line = (uint32_t) (it - m_starts.begin()) + 1;
+    location.column = offset - *it + 1;
+
+    return location;
+}
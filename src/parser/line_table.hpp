@@ -0,0 +1,33 @@
+#ifndef LINE_TABLE_HPP
+#define LINE_TABLE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+struct SourceLocation
+{
+    uint32_t line;   // 1-based
+    uint32_t column; // 1-based, in bytes
+};
+
+// Maps byte offsets to line/column pairs. Only offsets are recorded while
+// lexing; the table of line starts is built from the source the first time a
+// location is asked for, which normally means when a diagnostic is printed.
+class LineTable
+{
+private:
+    std::vector<uint32_t> m_starts; // offset of the first byte of each line
+    bool m_built;
+
+public:
+    LineTable();
+
+    bool is_built() const;
+    void build(const char* data, size_t size);
+
+    SourceLocation locate(uint32_t offset) const;
+};
+
+#endif // LINE_TABLE_HPP
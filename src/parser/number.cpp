@@ -0,0 +1,790 @@
+#include <number.hpp>
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ascii.hpp>
+#include <scan.hpp>
+#include <token.hpp>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// 128-bit helpers
+// ---------------------------------------------------------------------------
+
+struct U128
+{
+    uint64_t hi;
+    uint64_t lo;
+};
+
+static inline U128 multiply(uint64_t a, uint64_t b)
+{
+    U128 r;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128) a * b;
+    r.hi = (uint64_t) (p >> 64);
+    r.lo = (uint64_t) p;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    r.lo = _umul128(a, b, &r.hi);
+#else
+    uint64_t a_lo = (uint32_t) a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t) b, b_hi = b >> 32;
+
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+
+    uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+    r.lo = (mid << 32) | (uint32_t) ll;
+    r.hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+    return r;
+}
+
+static inline int leading_zeros(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while((x & (1ull << 63)) == 0) { x <<= 1; n++; }
+    return n;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Powers of five
+//
+// Eisel-Lemire needs 5^q for q in [-342, 308] as a normalized 128-bit value,
+// truncated for q >= 0 and rounded up for q < 0. Rather than carrying a 10KB
+// table in the source it is computed with a small stack bignum the first time
+// a float needs it.
+// ---------------------------------------------------------------------------
+
+static const int POWER_MIN = -342;
+static const int POWER_MAX = 308;
+static const int POWER_COUNT = POWER_MAX - POWER_MIN + 1;
+
+struct PowerTable
+{
+    U128 powers[POWER_COUNT];
+};
+
+// little-endian 32-bit limbs, large enough for 2^1792
+struct BigNum
+{
+    enum { LIMBS = 64 };
+
+    uint32_t limbs[LIMBS];
+    int      count;
+};
+
+static void big_multiply(BigNum* n, uint32_t m)
+{
+    uint64_t carry = 0;
+    for(int i = 0; i < n->count; i++)
+    {
+        uint64_t v = (uint64_t) n->limbs[i] * m + carry;
+        n->limbs[i] = (uint32_t) v;
+        carry = v >> 32;
+    }
+    if(carry != 0)
+    {
+        n->limbs[n->count++] = (uint32_t) carry;
+    }
+}
+
+static void big_divide(BigNum* n, uint32_t d)
+{
+    uint64_t rem = 0;
+    for(int i = n->count - 1; i >= 0; i--)
+    {
+        uint64_t v = (rem << 32) | n->limbs[i];
+        n->limbs[i] = (uint32_t) (v / d);
+        rem = v % d;
+    }
+    while((n->count > 0) && (n->limbs[n->count - 1] == 0))
+    {
+        n->count--;
+    }
+}
+
+static void big_add_one(BigNum* n)
+{
+    for(int i = 0; i < n->count; i++)
+    {
+        if(++n->limbs[i] != 0) { return; }
+    }
+    n->limbs[n->count++] = 1;
+}
+
+static int big_bits(const BigNum* n)
+{
+    int bits = 0;
+    if(n->count > 0)
+    {
+        uint32_t top = n->limbs[n->count - 1];
+        bits = (n->count - 1) * 32;
+        while(top != 0) { top >>= 1; bits++; }
+    }
+    return bits;
+}
+
+// the 32 bits starting at bit 'pos', which may be negative
+static uint32_t big_word(const BigNum* n, int pos)
+{
+    int index = (pos >= 0) ? (pos / 32) : -((31 - pos) / 32);
+    int shift = pos - index * 32;
+
+    uint64_t lo = ((index >= 0) && (index < n->count)) ? n->limbs[index] : 0;
+    uint64_t hi = ((index + 1 >= 0) && (index + 1 < n->count)) ? n->limbs[index + 1] : 0;
+
+    return (uint32_t) (((hi << 32) | lo) >> shift);
+}
+
+// bits [pos, pos + 128) of n
+static U128 big_extract(const BigNum* n, int pos)
+{
+    U128 r;
+    r.hi = ((uint64_t) big_word(n, pos + 96) << 32) | big_word(n, pos + 64);
+    r.lo = ((uint64_t) big_word(n, pos + 32) << 32) | big_word(n, pos);
+    return r;
+}
+
+static void big_shift_right(const BigNum* n, int shift, BigNum* out)
+{
+    out->count = 0;
+    for(int pos = shift; pos < n->count * 32; pos += 32)
+    {
+        out->limbs[out->count++] = big_word(n, pos);
+    }
+    while((out->count > 0) && (out->limbs[out->count - 1] == 0))
+    {
+        out->count--;
+    }
+}
+
+static PowerTable* build_power_table()
+{
+    static PowerTable table;
+
+    // 5^q for q >= 0, moved so its top bit is bit 127 and truncated
+    BigNum power = {};
+    power.limbs[0] = 1;
+    power.count = 1;
+
+    for(int q = 0; q <= POWER_MAX; q++)
+    {
+        if(q > 0)
+        {
+            big_multiply(&power, 5);
+        }
+        table.powers[q - POWER_MIN] = big_extract(&power, big_bits(&power) - 128);
+    }
+
+    // for q < 0, floor(2^b / 5^-q) + 1 truncated to 128 bits, where b leaves
+    // enough precision. The floor is taken by dividing 2^B by five repeatedly,
+    // since floor(floor(x / 5) / 5) == floor(x / 25).
+    const int B = 1792;
+
+    BigNum reciprocal = {};
+    reciprocal.limbs[B / 32] = 1;
+    reciprocal.count = B / 32 + 1;
+
+    power.limbs[0] = 1;
+    power.count = 1;
+
+    for(int q = -1; q >= POWER_MIN; q--)
+    {
+        big_multiply(&power, 5);
+        big_divide(&reciprocal, 5);
+
+        int z = big_bits(&power);
+        int b = (q >= -27) ? (z + 127) : (2 * z + 128);
+
+        BigNum c;
+        big_shift_right(&reciprocal, B - b, &c);
+        big_add_one(&c);
+
+        table.powers[q - POWER_MIN] = big_extract(&c, big_bits(&c) - 128);
+    }
+
+    return &table;
+}
+
+static const PowerTable& powers()
+{
+    // initialized once, thread-safe since C++11
+    static const PowerTable* table = build_power_table();
+    return *table;
+}
+
+// ---------------------------------------------------------------------------
+// Float conversion
+// ---------------------------------------------------------------------------
+
+static const int MANTISSA_BITS = 52;
+static const int MIN_EXPONENT = -1023;
+static const int INFINITE_POWER = 0x7FF;
+
+static const double EXACT_POWERS[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline double make_double(uint64_t mantissa, int power2)
+{
+    uint64_t bits = mantissa | ((uint64_t) power2 << MANTISSA_BITS);
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool Number::ToDouble(uint64_t w, int64_t q, double* value)
+{
+    bool status = true;
+
+#if !defined(__FLT_EVAL_METHOD__) || (__FLT_EVAL_METHOD__ == 0)
+    // Clinger's fast path: both operands are exact doubles, so a single
+    // correctly rounded operation gives the correctly rounded result
+    if((q >= -22) && (q <= 22) && (w <= (1ull << 53)))
+    {
+        double d = (double) w;
+        *value = (q < 0) ? (d / EXACT_POWERS[-q]) : (d * EXACT_POWERS[q]);
+        return true;
+    }
+#endif
+
+    if((w == 0) || (q < POWER_MIN))
+    {
+        *value = 0.0;
+    }
+    else if(q > POWER_MAX)
+    {
+        *value = make_double(0, INFINITE_POWER);
+    }
+    else
+    {
+        int lz = leading_zeros(w);
+        w <<= lz;
+
+        // w * 5^q, with the low word only computed when the top bits need it
+        const U128& power = powers().powers[q - POWER_MIN];
+        const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFull >> (MANTISSA_BITS + 3);
+
+        U128 product = multiply(w, power.hi);
+        if((product.hi & precision_mask) == precision_mask)
+        {
+            U128 low = multiply(w, power.lo);
+            product.lo += low.hi;
+            if(low.hi > product.lo)
+            {
+                product.hi++;
+            }
+
+            if((product.lo == 0xFFFFFFFFFFFFFFFFull) && ((q < -27) || (q > 55)))
+            {
+                // the truncated power may have cost us the rounding decision
+                status = false;
+            }
+        }
+
+        if(status)
+        {
+            int upperbit = (int) (product.hi >> 63);
+            int shift = upperbit + 64 - MANTISSA_BITS - 3;
+
+            uint64_t mantissa = product.hi >> shift;
+            // floor(log2(10^q)) + 63, written with the usual fixed point constant
+            int power2 = (int) (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - MIN_EXPONENT;
+
+            if(power2 <= 0)
+            {
+                // subnormal
+                if(-power2 + 1 >= 64)
+                {
+                    mantissa = 0;
+                    power2 = 0;
+                }
+                else
+                {
+                    mantissa >>= -power2 + 1;
+                    mantissa += (mantissa & 1);
+                    mantissa >>= 1;
+                    power2 = (mantissa < (1ull << MANTISSA_BITS)) ? 0 : 1;
+                    mantissa &= ~(1ull << MANTISSA_BITS);
+                }
+            }
+            else
+            {
+                // exactly halfway: round to even instead of up
+                if((product.lo <= 1) && (q >= -4) && (q <= 23) && ((mantissa & 3) == 1) &&
+                   ((mantissa << shift) == product.hi))
+                {
+                    mantissa &= ~1ull;
+                }
+
+                mantissa += (mantissa & 1);
+                mantissa >>= 1;
+
+                if(mantissa >= (2ull << MANTISSA_BITS))
+                {
+                    mantissa = (1ull << MANTISSA_BITS);
+                    power2++;
+                }
+
+                mantissa &= ~(1ull << MANTISSA_BITS);
+                if(power2 >= INFINITE_POWER)
+                {
+                    mantissa = 0;
+                    power2 = INFINITE_POWER;
+                }
+            }
+
+            *value = make_double(mantissa, power2);
+        }
+    }
+
+    return status;
+}
+
+// ---------------------------------------------------------------------------
+// Digit scanning
+// ---------------------------------------------------------------------------
+
+static inline uint64_t load_eight(const char* ptr)
+{
+    uint64_t v;
+    memcpy(&v, ptr, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline bool is_eight_digits(uint64_t v)
+{
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+            0x3333333333333333ull);
+}
+
+// eight ASCII digits, first digit in the lowest byte
+static inline uint32_t parse_eight_digits(uint64_t v)
+{
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ull; // 1 + (10000 << 32)
+
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t) v;
+}
+
+static inline int decimal_length(uint32_t v)
+{
+    int len = 0;
+    while(v != 0) { v /= 10; len++; }
+    return len;
+}
+
+struct Significand
+{
+    uint64_t value;   // the first 19 significant digits
+    int      digits;  // significant digits in value
+    int      dropped; // digits after the first 19
+    bool     inexact; // one of the dropped digits was not zero
+};
+
+static bool check_separator(const char* ptr, const char* end, const char* start, unsigned int base, const char** error)
+{
+    // a separator must sit between two digits
+    bool status = (ptr > start) && (ptr + 1 < end);
+    if(status)
+    {
+        char prev = ptr[-1];
+        char next = ptr[1];
+        status = (base == 16) ? (IS_HEXADECIMAL(prev) && IS_HEXADECIMAL(next)) : (IS_NUM(prev) && IS_NUM(next));
+    }
+
+    if(!status)
+    {
+        *error = "misplaced digit separator";
+    }
+
+    return status;
+}
+
+// folds a run of decimal digits into s; *count receives how many were read
+static const char* read_digits(const char* ptr, const char* end, Significand* s, int* count, const char** error)
+{
+    const char* start = ptr;
+    int separators = 0;
+
+    while(true)
+    {
+        // eight at a time while the significand has room for them
+        uint64_t v = 0;
+        while((s->digits + 8 <= 19) && (end - ptr >= 8) && is_eight_digits(v = load_eight(ptr)))
+        {
+            uint32_t digits = parse_eight_digits(v);
+            if(s->value == 0)
+            {
+                s->value = digits;
+                s->digits = decimal_length(digits);
+            }
+            else
+            {
+                s->value = s->value * 100000000 + digits;
+                s->digits += 8;
+            }
+            ptr += 8;
+        }
+
+        for(; (ptr < end) && IS_NUM(*ptr); ptr++)
+        {
+            if(s->digits < 19)
+            {
+                s->value = s->value * 10 + (uint64_t) (*ptr - '0');
+                s->digits += (s->value != 0) ? 1 : 0;
+            }
+            else
+            {
+                s->dropped++;
+                s->inexact |= (*ptr != '0');
+            }
+        }
+
+        if((ptr < end) && (*ptr == '_'))
+        {
+            if(!check_separator(ptr, end, start, 10, error))
+            {
+                return nullptr;
+            }
+            separators++;
+            ptr++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    *count = (int) (ptr - start) - separators;
+    return ptr;
+}
+
+static inline unsigned int digit_value(char c)
+{
+    unsigned int value = 0xFF;
+    if(IS_NUM(c))                   { value = (unsigned int) (c - '0'); }
+    else if((c >= 'a') && (c <= 'f')) { value = (unsigned int) (c - 'a' + 10); }
+    else if((c >= 'A') && (c <= 'F')) { value = (unsigned int) (c - 'A' + 10); }
+    return value;
+}
+
+// reads an integer in the given base with overflow checks
+static const char* read_integer(const char* ptr, const char* end, unsigned int base, uint64_t* value, const char** error)
+{
+    const char* start = ptr;
+    uint64_t result = 0;
+
+    while(ptr < end)
+    {
+        char c = *ptr;
+        unsigned int d = digit_value(c);
+
+        if(d < base)
+        {
+            if(result > (0xFFFFFFFFFFFFFFFFull - d) / base)
+            {
+                *error = "integer literal is too large";
+                return nullptr;
+            }
+            result = result * base + d;
+            ptr++;
+        }
+        else if(c == '_')
+        {
+            if(!check_separator(ptr, end, start, base, error))
+            {
+                return nullptr;
+            }
+            ptr++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // 0b12 is one bad literal rather than 0b1 followed by 2
+    if((ptr < end) && IS_NUM(*ptr))
+    {
+        *error = "digit out of range for base";
+        return nullptr;
+    }
+
+    if(ptr == start)
+    {
+        *error = "expected digits after the base prefix";
+        return nullptr;
+    }
+
+    *value = result;
+    return ptr;
+}
+
+// the slow path: strtod on a copy without separators, kept on the stack
+static bool slow_to_double(const char* start, const char* end, double* value, const char** error)
+{
+    char buffer[1024];
+    unsigned int len = 0;
+
+    for(const char* it = start; it < end; it++)
+    {
+        if(*it != '_')
+        {
+            if(len + 1 >= sizeof(buffer))
+            {
+                *error = "floating point literal is too long";
+                return false;
+            }
+            buffer[len++] = *it;
+        }
+    }
+    buffer[len] = 0;
+
+    *value = strtod(buffer, nullptr);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Suffixes
+// ---------------------------------------------------------------------------
+
+static const struct
+{
+    char    spelling[4];
+    uint8_t type;
+} SUFFIXES[] =
+{
+    { "u8",  TK_TYPE_U8  }, { "u16", TK_TYPE_U16 }, { "u32", TK_TYPE_U32 }, { "u64", TK_TYPE_U64 },
+    { "i8",  TK_TYPE_I8  }, { "i16", TK_TYPE_I16 }, { "i32", TK_TYPE_I32 }, { "i64", TK_TYPE_I64 },
+    { "f32", TK_TYPE_F32 }, { "f64", TK_TYPE_F64 }
+};
+
+static uint8_t find_suffix(const char* ptr, unsigned int len)
+{
+    uint8_t type = TK_TYPE_INVALID;
+
+    if((len == 2) || (len == 3))
+    {
+        // the leading letter may be upper case, as in the type names
+        char first = ((ptr[0] >= 'A') && (ptr[0] <= 'Z')) ? (char) (ptr[0] - 'A' + 'a') : ptr[0];
+
+        for(unsigned int i = 0; i < sizeof(SUFFIXES) / sizeof(SUFFIXES[0]); i++)
+        {
+            const char* spelling = SUFFIXES[i].spelling;
+            if((spelling[0] == first) && (strlen(spelling) == len) && (memcmp(spelling + 1, ptr + 1, len - 1) == 0))
+            {
+                type = SUFFIXES[i].type;
+                break;
+            }
+        }
+    }
+
+    return type;
+}
+
+static bool fits(uint64_t value, uint8_t type)
+{
+    uint64_t limit = 0xFFFFFFFFFFFFFFFFull;
+    switch(type)
+    {
+        case TK_TYPE_U8:  { limit = 0xFF; break; }
+        case TK_TYPE_U16: { limit = 0xFFFF; break; }
+        case TK_TYPE_U32: { limit = 0xFFFFFFFF; break; }
+        // signed literals may be one past the maximum so that they can be negated
+        case TK_TYPE_I8:  { limit = 0x80; break; }
+        case TK_TYPE_I16: { limit = 0x8000; break; }
+        case TK_TYPE_I32: { limit = 0x80000000; break; }
+        case TK_TYPE_I64: { limit = 0x8000000000000000ull; break; }
+        default: { break; }
+    }
+    return value <= limit;
+}
+
+// ---------------------------------------------------------------------------
+// Literals
+// ---------------------------------------------------------------------------
+
+const char* Number::Read(const char* ptr, const char* end, Literal* literal, const char** error)
+{
+    const char* start = ptr;
+
+    literal->suffix = TK_TYPE_INVALID;
+
+    char prefix = (ptr + 1 < end) ? ptr[1] : 0;
+    if((ptr[0] == '0') && ((prefix == 'x') || (prefix == 'X') || (prefix == 'b') || (prefix == 'B')))
+    {
+        unsigned int base = ((prefix == 'x') || (prefix == 'X')) ? 16 : 2;
+
+        uint64_t value = 0;
+        ptr = read_integer(ptr + 2, end, base, &value, error);
+
+        literal->type = LITERAL_INTEGER;
+        literal->data.integer_value = value;
+    }
+    else
+    {
+        Significand s = {};
+        int64_t exponent = 0;
+        bool is_float = false;
+        int count = 0;
+
+        // integer digits past the first 19 scale the value up
+        ptr = read_digits(ptr, end, &s, &count, error);
+        exponent += s.dropped;
+
+        if((ptr != nullptr) && (ptr < end) && (*ptr == '.'))
+        {
+            is_float = true;
+
+            // fractional digits folded into the significand scale it down
+            int dropped = s.dropped;
+            ptr = read_digits(ptr + 1, end, &s, &count, error);
+            exponent -= count - (s.dropped - dropped);
+
+            if((ptr != nullptr) && (ptr < end) && (*ptr == '.'))
+            {
+                *error = "repeated decimal symbol";
+                ptr = nullptr;
+            }
+        }
+
+        if((ptr != nullptr) && (ptr < end) && ((*ptr == 'e') || (*ptr == 'E')))
+        {
+            is_float = true;
+            ptr++;
+
+            bool negative = false;
+            if((ptr < end) && ((*ptr == '+') || (*ptr == '-')))
+            {
+                negative = (*ptr == '-');
+                ptr++;
+            }
+
+            if((ptr >= end) || !IS_NUM(*ptr))
+            {
+                *error = "expected exponent digits";
+                ptr = nullptr;
+            }
+            else
+            {
+                // anything this large is already zero or infinite
+                int64_t e = 0;
+                for(; (ptr < end) && IS_NUM(*ptr); ptr++)
+                {
+                    e = (e < 100000) ? (e * 10 + (*ptr - '0')) : e;
+                }
+                exponent += negative ? -e : e;
+            }
+        }
+
+        if(ptr == nullptr)
+        {
+            // *error describes the problem
+        }
+        else if(is_float)
+        {
+            double value = 0.0;
+            bool exact = ToDouble(s.value, exponent, &value);
+
+            // with digits dropped the true value lies in (w, w + 1) * 10^q,
+            // which is only decided if both ends round the same way
+            if(exact && s.inexact)
+            {
+                double upper = 0.0;
+                exact = ToDouble(s.value + 1, exponent, &upper) && (upper == value);
+            }
+
+            if(!exact && !slow_to_double(start, ptr, &value, error))
+            {
+                ptr = nullptr;
+            }
+            else if(value > DBL_MAX)
+            {
+                *error = "floating point literal is out of range";
+                ptr = nullptr;
+            }
+
+            literal->type = LITERAL_FLOAT;
+            literal->data.float_value = value;
+        }
+        else
+        {
+            uint64_t value = s.value;
+            if((s.dropped > 0) && (read_integer(start, ptr, 10, &value, error) == nullptr))
+            {
+                ptr = nullptr;
+            }
+
+            literal->type = LITERAL_INTEGER;
+            literal->data.integer_value = value;
+        }
+    }
+
+    if((ptr != nullptr) && (ptr < end) && (IS_ALPHA(*ptr) || (*ptr == '_')))
+    {
+        const char* suffix = ptr;
+        ptr = Scan::SkipIdentifier(ptr, end);
+
+        uint8_t type = find_suffix(suffix, (unsigned int) (ptr - suffix));
+        if(type == TK_TYPE_INVALID)
+        {
+            *error = "invalid suffix on numeric literal";
+            ptr = nullptr;
+        }
+        else if((type == TK_TYPE_F32) || (type == TK_TYPE_F64))
+        {
+            if(literal->type == LITERAL_INTEGER)
+            {
+                literal->type = LITERAL_FLOAT;
+                literal->data.float_value = (double) literal->data.integer_value;
+            }
+            // halfway between FLT_MAX and 2^128 already rounds to infinity
+            if((type == TK_TYPE_F32) && (literal->data.float_value >= ldexp(1.0, 128) - ldexp(1.0, 103)))
+            {
+                *error = "floating point literal is out of range";
+                ptr = nullptr;
+            }
+            else if(type == TK_TYPE_F32)
+            {
+                literal->data.float_value = (double) (float) literal->data.float_value;
+            }
+        }
+        else if(literal->type == LITERAL_FLOAT)
+        {
+            *error = "integer suffix on floating point literal";
+            ptr = nullptr;
+        }
+        else if(!fits(literal->data.integer_value, type))
+        {
+            *error = "integer literal does not fit its suffix";
+            ptr = nullptr;
+        }
+
+        literal->suffix = type;
+    }
+
+    return ptr;
+}
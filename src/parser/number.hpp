@@ -0,0 +1,27 @@
+#ifndef NUMBER_HPP
+#define NUMBER_HPP
+
+#include <stdint.h>
+
+#include <literal.hpp>
+
+// Numeric literal scanner. Handles decimal integers and floats, 0x hex and
+// 0b binary integers, '_' digit separators and type suffixes such as 10u8 or
+// 1.5f32, which are stored as a TK_TYPE_* in Literal::suffix. Decimal digits
+// are consumed eight at a time and floats are converted with the
+// Eisel-Lemire algorithm, so the result is exactly rounded. Nothing is
+// allocated: the rare inputs the fast paths cannot decide go through strtod
+// from a buffer on the stack.
+class Number
+{
+public:
+    // scans the literal at ptr, which must start with a digit; returns the
+    // first byte after it, or nullptr with a description in *error
+    static const char* Read(const char* ptr, const char* end, Literal* literal, const char** error);
+
+    // w * 10^q correctly rounded to a double; false when only a slow
+    // arbitrary precision conversion could decide the rounding
+    static bool ToDouble(uint64_t w, int64_t q, double* value);
+};
+
+#endif // NUMBER_HPP
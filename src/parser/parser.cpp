@@ -1,23 +1,31 @@
 #include <parser.hpp>
 
-static const char* ERROR_BAD_EXPRESSION = "malformed expression";
+#include <constant_evaluator.hpp>
+#include <diagnostics.hpp>
+#include <trace.hpp>
 
-Parser::Parser(TokenStack& stack)
+Parser::Parser(TokenStack& stack, AstArena* arena, TypeContext* types)
 {
     m_status = true;
     m_stack = &stack;
+    m_arena = arena;
+    m_types = types;
 }
 
 AST* Parser::Parse(TokenStack& stack)
 {
     bool status = true;
 
-    Parser parser(stack);
     AST* ast = new AST();
-    
+    ast->types = new TypeContext(&ast->arena);
+    Parser parser(stack, &ast->arena, ast->types);
+    ast->symbols = &stack.symbols();
+    ast->strings = &stack.strings();
+
+    ListBuilder<Statement> statements(&parser.m_list_stack);
     while(status)
     {
-        if(stack.peek().type == TK_EOF)
+        if(stack.peek_type() == TK_EOF)
         {
             break;
         }
@@ -26,7 +34,7 @@ AST* Parser::Parse(TokenStack& stack)
             Statement* stmt = nullptr;
             if(parser.parse_global_statement(&stmt))
             {
-                ast->statements.insert(stmt);
+                statements.insert(stmt);
             }
             else
             {
@@ -34,6 +42,14 @@ AST* Parser::Parse(TokenStack& stack)
             }
         }
     }
+    statements.seal(&ast->statements, &ast->arena);
+
+    // a streamed source that failed to lex ends early but may still parse
+    status = status && !stack.failed();
+
+    // array sizes may name any constant of the tree, so the types are only
+    // keyed on their counts once it is complete
+    status = status && ConstantEvaluator::Dimensions(ast);
 
     if(!status)
     {
@@ -47,7 +63,7 @@ AST* Parser::Parse(TokenStack& stack)
 bool Parser::accept(uint8_t type)
 {
     bool ret = false;
-    if(m_stack->peek().type == type)
+    if(m_stack->peek_type() == type)
     {
         ret = true;
     }
@@ -57,84 +73,40 @@ bool Parser::accept(uint8_t type)
 void Parser::error(const char* msg)
 {
     m_status = false;
-    puts(msg);
+    Diagnostics::Print("%s\n", msg);
 }
 
-void Parser::unexpected_token(uint8_t tk, uint8_t ex)
+void Parser::unexpected_token(uint8_t tk, uint8_t ex, uint32_t offset)
 {
-    const char* TK_TBL[] =
-    {
-        "INVALID", // TK_INVALID
-        "CONST", // TK_CONST
-        "EXTERN", // TK_EXTERN
-        "STRUCT", // TK_STRUCT
-        "RETURN", // TK_RETURN
-        "IF", // TK_IF
-        "=", // TK_EQUAL
-        "<", // TK_LEFT_ARROW_HEAD
-        ">", // TK_RIGHT_ARROW_HEAD
-        "+", // TK_PLUS
-        "-", // TK_MINUS
-        ".", // TK_DOT
-        "*", // TK_ASTERISK
-        "/", // TK_FORWARD_SLASH
-        "{", // TK_OPEN_CURLY_BRACKET
-        "}", // TK_CLOSE_CURLY_BRACKET
-        "(", // TK_OPEN_ROUND_BRACKET
-        ")", // TK_CLOSE_ROUND_BRACKET
-        "[", // TK_OPEN_SQUARE_BRACKET
-        "]", // TK_CLOSE_SQUARE_BRACKET
-        ";", // TK_SEMICOLON
-        "LITERAL", // TK_LITERAL
-        "IDENTIFIER", // TK_IDENTIFIER
-        ",", // TK_COMMA
-        "OR", // TK_OR
-        "AND", // TK_AND
-        "^", // TK_CARET
-        "~", // TK_TILDE
-        "!", // TK_EXPLANATION_MARK
-        "&", // TK_AMPERSAND
-        "|", // TK_VERTICAL_BAR
-        "%", // TK_PERCENT
-        "TYPE", // TK_TYPE
-        "FOR", // TK_FOR
-        "WHILE", // TK_WHILE
-        ":", // TK_COLON
-        "TYPEDEF", // TK_TYPEDEF
-        "BREAK", // TK_BREAK
-        "GOTO", // TK_GOTO
-        "ELSE", // TK_ELSE
-        "CONTINUE", // TK_CONTINUE
-        "SWITCH", // TK_SWITCH
-        "UNION", // TK_UNION
-        "CASE", // TK_CASE
-        "DEFAULT", // TK_DEFAULT
-        "ENUM", // TK_ENUM
-        "STATIC_CAST", // TK_STATIC_CAST
-        "REINTERPRET_CAST", // TK_REINTERPRET_CAST
-        "EOF" // TK_EOF
-    };
+    TRACE(TRACE_PARSER, "unexpected token", tk, offset);
+
+    const char* _tk = token_name(tk);
 
-    const char* _tk = ((tk > 0) && (tk < TK_COUNT)) ? TK_TBL[tk] : TK_TBL[0];
+    SourceLocation location = m_stack->locate(offset);
 
     m_status = false;
-    if(ex == 0)
+    if((tk == TK_EOF) && m_stack->failed())
     {
-        printf("error: unexpected token '%s'\n", _tk);
+        // the source was cut short by a lexing error, which has been reported
+    }
+    else if(ex == 0)
+    {
+        Diagnostics::Print("error: %u:%u: unexpected token '%s'\n", location.line, location.column, _tk);
     }
     else
     {
-        const char* _ex = (ex < TK_COUNT) ? TK_TBL[ex] : TK_TBL[0];
-        printf("error: expected token '%s' but got '%s'\n", _ex, _tk);
+        const char* _ex = token_name(ex);
+        Diagnostics::Print("error: %u:%u: expected token '%s' but got '%s'\n", location.line, location.column, _ex, _tk);
     }
 }
 
 bool Parser::expect(uint8_t type)
 {
-    Token tk = m_stack->pop();
-    if(tk.type != type)
+    uint8_t tk = m_stack->peek_type();
+    m_stack->advance();
+    if(tk != type)
     {
-        unexpected_token(tk.type, type);
+        unexpected_token(tk, type, m_stack->last_offset());
     }
     return m_status;
 }
@@ -152,7 +124,7 @@ bool Parser::parse_declaration(Statement** ptr)
 
     parse_type_flags(&flags);
 
-    List<Declaration> decl_list = {};
+    ListBuilder<Declaration> decl_list(&m_list_stack);
     if (accept(TK_STRUCT) || accept(TK_UNION))
     {
         Declaration* comp_decl = nullptr;
@@ -168,15 +140,11 @@ bool Parser::parse_declaration(Statement** ptr)
             {
                 if (accept(TK_SEMICOLON))
                 {
-                    m_stack->pop();
+                    m_stack->advance();
                 }
                 else
                 {
-                    Type* type = new Type();
-                    type->type = TYPE_COMPOSITE;
-                    type->flags.all = flags.all;
-                    type->data.composite = comp_decl->data.composite.data;
-
+                    Type* type = m_types->composite(comp_decl->data.composite.data, flags);
                     parse_declaration(type, &decl_list);
                 }
             }
@@ -184,18 +152,18 @@ bool Parser::parse_declaration(Statement** ptr)
     }
     else
     {
-        if (parse_base_type(&type))
+        if (parse_base_type(flags, &type))
         {
-            type->flags.all = flags.all;
             parse_declaration(type, &decl_list);
         }
     }
 
     if (m_status)
     {
-        Statement* stmt = new Statement();
+        Statement* stmt = m_arena->make<Statement>();
         stmt->type = STMT_DECLARATION;
-        stmt->data.declarations = decl_list;
+        TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
+        decl_list.seal(&stmt->data.declarations, m_arena);
 
         *ptr = stmt;
     }
@@ -203,16 +171,21 @@ bool Parser::parse_declaration(Statement** ptr)
     return m_status;
 }
 
-bool Parser::parse_declaration(Type* base_type, List<Declaration>* decl_list)
+bool Parser::parse_declaration(Type* base_type, ListBuilder<Declaration>* decl_list)
 {
     Type* type = nullptr;
-    strptr name = {};
-    parse_complete_type(base_type, &type, &name);
+    uint32_t name = SYMBOL_NULL;
+    List<Function::Parameter>* params = nullptr;
 
-    if (type->type == TYPE_FUNCTION)
+    if (!parse_complete_type(base_type, &type, &name, &params) || (type == nullptr))
+    {
+        // the declarator was malformed and has been reported
+        m_status = false;
+    }
+    else if (type->type == TYPE_FUNCTION)
     {
         Declaration* func_decl = nullptr;
-        if (parse_function_definition(type, name, &func_decl))
+        if (parse_function_definition(type, name, params, &func_decl))
         {
             decl_list->insert(func_decl);
         }
@@ -229,12 +202,12 @@ bool Parser::parse_declaration(Type* base_type, List<Declaration>* decl_list)
 
             if (accept(TK_SEMICOLON))
             {
-                m_stack->pop();
+                m_stack->advance();
                 break;
             }
-            else if(expect(TK_COMMA))
+            else if(expect(TK_COMMA) && (!parse_complete_type(base_type, &type, &name, nullptr) || (type == nullptr)))
             {
-                parse_complete_type(base_type, &type, &name);
+                m_status = false;
             }
         }
     }
@@ -246,19 +219,20 @@ bool Parser::parse_composite_declaration(Declaration** ptr)
 {
     uint8_t comp_type = COMP_TYPE_INVALID;
 
-    Token tk = m_stack->pop();
-    switch (tk.type)
+    uint8_t tk = m_stack->peek_type();
+    m_stack->advance();
+    switch (tk)
     {
         case TK_STRUCT: { comp_type = COMP_TYPE_STRUCT; break; }
         case TK_UNION:  { comp_type = COMP_TYPE_UNION;  break; }
         default:
         {
-            unexpected_token(tk.type, 0);
+            unexpected_token(tk, 0, m_stack->last_offset());
             break;
         }
     }
 
-    strptr decl_name = {};
+    uint32_t decl_name = SYMBOL_NULL;
     if (m_status && accept(TK_IDENTIFIER))
     {
         parse_identifier(&decl_name);
@@ -269,14 +243,15 @@ bool Parser::parse_composite_declaration(Declaration** ptr)
     {
         if (accept(TK_OPEN_CURLY_BRACKET))
         {
-            m_stack->pop();
-            decl_body = new List<Statement>();
-            
+            m_stack->advance();
+            decl_body = m_arena->make<List<Statement>>();
+
+            ListBuilder<Statement> statements(&m_list_stack);
             while (m_status)
             {
                 if (accept(TK_CLOSE_CURLY_BRACKET))
                 {
-                    m_stack->pop();
+                    m_stack->advance();
                     break;
                 }
                 else
@@ -284,10 +259,11 @@ bool Parser::parse_composite_declaration(Declaration** ptr)
                     Statement* stmt = nullptr;
                     if (parse_statement(&stmt))
                     {
-                        decl_body->insert(stmt);
+                        statements.insert(stmt);
                     }
                 }
             }
+            statements.seal(decl_body, m_arena);
         }
         else
         {
@@ -297,12 +273,13 @@ bool Parser::parse_composite_declaration(Declaration** ptr)
 
     if (m_status)
     {
-        Composite* comp = new Composite();
+        Composite* comp = m_arena->make<Composite>();
         comp->type = comp_type;
         
-        Declaration* decl = new Declaration();
+        Declaration* decl = m_arena->make<Declaration>();
         decl->data.composite.data = comp;
         decl->type = DECL_COMPOSITE;
+        TRACE(TRACE_AST, "declaration", decl->type, m_stack->last_offset());
         decl->name = decl_name;
         decl->data.composite.body = decl_body;
 
@@ -318,8 +295,8 @@ bool Parser::parse_type_flags(Type::Flags* ptr)
 
     while (m_status)
     {
-        Token tk = m_stack->peek();
-        if (tk.type == TK_CONST)
+        uint8_t type = m_stack->peek_type();
+        if (type == TK_CONST)
         {
             if (flags.bits.is_constant == 0)
             {
@@ -335,7 +312,7 @@ bool Parser::parse_type_flags(Type::Flags* ptr)
             break;
         }
 
-        m_stack->pop(); // consume the token
+        m_stack->advance(); // consume the token
     }
 
     if (m_status)
@@ -346,14 +323,15 @@ bool Parser::parse_type_flags(Type::Flags* ptr)
     return m_status;
 }
 
-bool Parser::parse_base_type(Type** ptr)
+bool Parser::parse_base_type(Type::Flags flags, Type** ptr)
 {
     uint8_t data_type = 0;
 
     if(accept(TK_TYPE))
     {
-        Token tk = m_stack->pop();
-        switch(tk.data.subtype)
+        uint8_t subtype = m_stack->peek_subtype();
+        m_stack->advance();
+        switch(subtype)
         {
             case TK_TYPE_U8:   { data_type = TYPE_U8;   break; }
             case TK_TYPE_I32:  { data_type = TYPE_I32;  break; }
@@ -367,34 +345,26 @@ bool Parser::parse_base_type(Type** ptr)
     }
     else
     {
-        unexpected_token(m_stack->peek().type, 0);
+        unexpected_token(m_stack->peek_type(), 0, m_stack->peek_offset());
     }
 
     if (m_status)
     {
-        Type* type = new Type();
-        type->type = data_type;
-
-        *ptr = type;
+        *ptr = m_types->primitive(data_type, flags);
     }
 
     return m_status;
 }
 
-bool Parser::parse_complete_type(Type* base_type, Type** ptr, strptr* name)
+bool Parser::parse_complete_type(Type* base_type, Type** ptr, uint32_t* name, List<Function::Parameter>** params)
 {
     Type* type = base_type;
 
     // parse the pointer operators for base type
     while (m_status && accept(TK_ASTERISK))
     {
-        m_stack->pop();
-
-        Type* t_ptr = new Type();
-        t_ptr->type = TYPE_PTR;
-        t_ptr->data.pointer = type;
-
-        type = t_ptr;
+        m_stack->advance();
+        type = m_types->pointer(type, Type::Flags {});
     }
 
     if (m_status)
@@ -406,144 +376,78 @@ bool Parser::parse_complete_type(Type* base_type, Type** ptr, strptr* name)
             {
                 if (accept(TK_OPEN_ROUND_BRACKET))
                 {
-                    Type* func = new Type();
-                    func->type = TYPE_FUNCTION;
-                    func->data.function.return_type = type;
-                    parse_function_parameters(&func->data.function.parameters);
-
-                    type = func;
+                    parse_function_parameters(type, &type, params);
                 }
             }
         }
-        else if (accept(TK_OPEN_ROUND_BRACKET)) // read the sub-type
+        else if (accept(TK_OPEN_ROUND_BRACKET))
         {
-            m_stack->pop();
-
-            // read the sub pointers
-            Type *ptr_head = nullptr, *ptr_tail = nullptr;
-            while (m_status && accept(TK_ASTERISK))
+            // a bracket either nests a declarator, as in U32 (*f)(U32), or
+            // opens the parameters of an unnamed function type, as in the
+            // cast (U32 (U32)) f; parameters start with a type or const
+            uint8_t next = m_stack->peek_type(1);
+            if ((next == TK_ASTERISK) || (next == TK_IDENTIFIER) || (next == TK_OPEN_ROUND_BRACKET))
             {
-                m_stack->pop();
+                parse_nested_declarator(type, &type, name, params);
+            }
+            else
+            {
+                parse_function_parameters(type, &type, params);
+            }
+        }
+    }
 
-                Type* t_ptr = new Type();
-                t_ptr->type = TYPE_PTR;
+    if (m_status)
+    {
+        *ptr = type;
+    }
 
-                if (ptr_tail == nullptr) {
-                    ptr_head = t_ptr;
-                }
-                else {
-                    ptr_tail->data.pointer = t_ptr;
-                }
+    return m_status;
+}
 
-                ptr_tail = t_ptr;
-            }
+// A declarator in brackets applies to the type after the brackets: in
+// U32 (*f())(U32), f returns a pointer to a function taking a U32. Types are
+// built from the inside out, so the brackets are skipped, the parameters
+// after them are applied to the base type, and the cursor goes back to read
+// the nested declarator over the result before moving past it all again.
+bool Parser::parse_nested_declarator(Type* base_type, Type** ptr, uint32_t* name, List<Function::Parameter>** params)
+{
+    Type* type = base_type;
+    uint32_t open = m_stack->mark();
 
-            // recursively read the sub type
-            Type* sub_type = nullptr;
-            if (parse_complete_type(nullptr, &sub_type, name))
-            {
-                expect(TK_CLOSE_ROUND_BRACKET);
-            }
+    // the parameters after the brackets are those of the declaration when
+    // the brackets only hold its name, as in U32 (f)(U32 a)
+    List<Function::Parameter>* outer = nullptr;
+    if (skip_brackets() && accept(TK_OPEN_ROUND_BRACKET))
+    {
+        parse_function_parameters(type, &type, (params != nullptr) ? &outer : nullptr);
+    }
 
-            // find the root type
-            Type* root_type = sub_type;
-            if(root_type != nullptr)
-            {
-                while(true)
-                {
-                    if(root_type->type == TYPE_FUNCTION)
-                    {
-                        Type* r = root_type->data.function.return_type;
-                        if(r == nullptr) {
-                            break;
-                        } else {
-                            root_type = r;
-                        }
-                    }
-                    else if(root_type->type == TYPE_PTR)
-                    {
-                        Type* p = root_type->data.pointer;
-                        if(p == nullptr) {
-                            break;
-                        } else {
-                            root_type = p;
-                        }
-                    }
-                    else
-                    {
-                        error("debug: compiler exception\n");
-                    }
-                }
-            }
+    if (m_status)
+    {
+        uint32_t end = m_stack->position();
+        m_stack->rewind(open);
 
-            if(m_status)
-            {
-                if (accept(TK_OPEN_ROUND_BRACKET))
-                {
-                    Type* func = new Type();
-                    func->type = TYPE_FUNCTION;
-                    func->data.function.return_type = type;
-                    parse_function_parameters(&func->data.function.parameters);
-                    
-                    if(sub_type != nullptr)
-                    {
-                        if (root_type->type == TYPE_FUNCTION)
-                        {
-                            if (ptr_head != nullptr)
-                            {
-                                ptr_tail->data.pointer = func;
-                                root_type->data.function.return_type = ptr_head;
-                            }
-                            else
-                            {
-                                root_type->data.function.return_type = func;
-                            }
-
-                            type = sub_type;
-                        }
-                        else if (root_type->type == TYPE_PTR)
-                        {
-                            root_type->data.pointer = func;
-                            type = sub_type;
-                        }
-                    }
-                    else
-                    {
-                        if(ptr_head != nullptr)
-                        {
-                            ptr_tail->data.pointer = func;
-                            type = ptr_head;
-                        }
-                        else
-                        {
-                            type = func;
-                        }
-                    }
-                }
-                else
-                {
-                    // bind the sub type pointers to the main type
-                    if (ptr_head != nullptr)
-                    {
-                        ptr_tail->data.pointer = type;
-                        type = ptr_head;
-                    }
+        Type* applied = type;
+        expect(TK_OPEN_ROUND_BRACKET);
+        if (m_status && parse_complete_type(type, &type, name, params))
+        {
+            expect(TK_CLOSE_ROUND_BRACKET);
+        }
 
-                    // if the sub-type is a function, update the return type
-                    if (root_type->type == TYPE_FUNCTION)
-                    {
-                        root_type->data.function.return_type = type;
-                        type = sub_type;
-                    }
-                    else if (sub_type != nullptr)
-                    {
-                        error("exception: expected null sub_type\n");
-                    }
-                }
-            }
+        if (m_status && (params != nullptr) && (*params == nullptr) && (type == applied))
+        {
+            *params = outer;
+        }
+
+        if (m_status)
+        {
+            m_stack->rewind(end);
         }
     }
 
+    m_stack->release();
+
     if (m_status)
     {
         *ptr = type;
@@ -552,61 +456,131 @@ bool Parser::parse_complete_type(Type* base_type, Type** ptr, strptr* name)
     return m_status;
 }
 
-bool Parser::parse_function_parameters(List<Function::Parameter>* params)
+// moves past the bracket at the cursor and everything up to its partner
+bool Parser::skip_brackets()
+{
+    unsigned int depth = 0;
+
+    do
+    {
+        uint8_t tk = m_stack->peek_type();
+        switch (tk)
+        {
+            case TK_OPEN_ROUND_BRACKET:  { depth++; break; }
+            case TK_CLOSE_ROUND_BRACKET: { depth--; break; }
+            // the cursor never moves past the last token, so stop at anything
+            // that may end the tokens
+            case TK_EOF:
+            case TK_INVALID:
+            {
+                unexpected_token(tk, TK_CLOSE_ROUND_BRACKET, m_stack->peek_offset());
+                break;
+            }
+            default: { break; }
+        }
+
+        if (m_status)
+        {
+            m_stack->advance();
+        }
+    } while (m_status && (depth > 0));
+
+    return m_status;
+}
+
+bool Parser::parse_function_parameters(Type* return_type, Type** ptr, List<Function::Parameter>** params)
 {
     expect(TK_OPEN_ROUND_BRACKET);
 
+    // parameters of nested signatures go on the stack above these and are
+    // gone again by the time the next one of these is read
+    size_t start = m_param_stack.size();
     if (accept(TK_CLOSE_ROUND_BRACKET))
     {
-        m_stack->pop();
+        m_stack->advance();
     }
     else
     {
         while (m_status)
         {
-            Function::Parameter* param = nullptr;
-            if (parse_parameter(&param))
+            Function::Parameter param = {};
+            if (!parse_parameter(&param))
             {
-                params->insert(param);
+                // reported already, the separator after it is not looked for
             }
-
-            if (accept(TK_CLOSE_ROUND_BRACKET))
+            else if (accept(TK_CLOSE_ROUND_BRACKET))
             {
-                m_stack->pop();
+                m_param_stack.push_back(param);
+                m_stack->advance();
                 break;
             }
             else
             {
+                m_param_stack.push_back(param);
                 expect(TK_COMMA);
             }
         }
     }
 
+    unsigned int count = (unsigned int) (m_param_stack.size() - start);
+    if (m_status)
+    {
+        m_param_types.clear();
+        for (unsigned int i = 0; i < count; i++)
+        {
+            m_param_types.push_back(m_param_stack[start + i].type);
+        }
+        *ptr = m_types->function(return_type, m_param_types.data(), count, Type::Flags {});
+    }
+
+    if (m_status && (params != nullptr))
+    {
+        Function::Parameter* copy = nullptr;
+        if (count > 0)
+        {
+            copy = (Function::Parameter*) m_arena->allocate(count * sizeof(Function::Parameter), alignof(Function::Parameter));
+        }
+
+        ListBuilder<Function::Parameter> list(&m_list_stack);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            copy[i] = m_param_stack[start + i];
+            list.insert(&copy[i]);
+        }
+
+        *params = m_arena->make<List<Function::Parameter>>();
+        list.seal(*params, m_arena);
+    }
+    m_param_stack.resize(start);
+
     return m_status;
 }
 
-bool Parser::parse_identifier(strptr* id)
+bool Parser::parse_identifier(uint32_t* id)
 {
-    Token tk = m_stack->pop();
-    if(tk.type == TK_IDENTIFIER)
+    uint8_t tk = m_stack->peek_type();
+    uint32_t identifier = m_stack->peek_identifier();
+    m_stack->advance();
+
+    if(tk == TK_IDENTIFIER)
     {
-        *id = tk.data.identifier;
+        *id = identifier;
     }
     else
     {
-        unexpected_token(tk.type, 0);
+        unexpected_token(tk, 0, m_stack->last_offset());
     }
 
     return m_status;
 }
 
-bool Parser::parse_function_definition(Type* type, strptr name, Declaration** ptr)
+bool Parser::parse_function_definition(Type* type, uint32_t name, List<Function::Parameter>* params, Declaration** ptr)
 {
     List<Statement>* body = nullptr;
 
     if(accept(TK_OPEN_CURLY_BRACKET))
     {
-        body = new List<Statement>();
+        body = m_arena->make<List<Statement>>();
         parse_body(body);
     }
     else
@@ -614,13 +588,34 @@ bool Parser::parse_function_definition(Type* type, strptr name, Declaration** pt
         expect(TK_SEMICOLON);
     }
     
+    // every declaration of a function has its parameters, unnamed if the
+    // declarator did not name them
+    if (m_status && (params == nullptr))
+    {
+        const List<Type>& types = type->data.function.parameters;
+
+        ListBuilder<Function::Parameter> list(&m_list_stack);
+        for (Type* param_type : types)
+        {
+            Function::Parameter* param = m_arena->make<Function::Parameter>();
+            param->name = SYMBOL_NULL;
+            param->type = param_type;
+            list.insert(param);
+        }
+
+        params = m_arena->make<List<Function::Parameter>>();
+        list.seal(params, m_arena);
+    }
+
     if (m_status)
     {
-        Declaration* decl = new Declaration();
+        Declaration* decl = m_arena->make<Declaration>();
         decl->type = DECL_FUNCTION;
+        TRACE(TRACE_AST, "declaration", decl->type, m_stack->last_offset());
         decl->name = name;
         decl->data.function.type = type;
         decl->data.function.body = body;
+        decl->data.function.parameters = params;
 
         *ptr = decl;
     }
@@ -628,19 +623,20 @@ bool Parser::parse_function_definition(Type* type, strptr name, Declaration** pt
     return m_status;
 }
 
-bool Parser::parse_variable_definition(Type* type, strptr name, Declaration** ptr)
+bool Parser::parse_variable_definition(Type* type, uint32_t name, Declaration** ptr)
 {
     Expression* value = nullptr;
     if(accept(TK_EQUAL))
     {
-        m_stack->pop();
+        m_stack->advance();
         parse_expression(&value);
     }
 
     if(m_status)
     {
-        Declaration* decl = new Declaration();
+        Declaration* decl = m_arena->make<Declaration>();
         decl->type = DECL_VARIABLE;
+        TRACE(TRACE_AST, "declaration", decl->type, m_stack->last_offset());
         decl->name = name;
         decl->data.variable.type = type;
         decl->data.variable.value = value;
@@ -651,28 +647,27 @@ bool Parser::parse_variable_definition(Type* type, strptr name, Declaration** pt
     return m_status;
 }
 
-bool Parser::parse_parameter(Function::Parameter** ptr)
+bool Parser::parse_parameter(Function::Parameter* param)
 {
-    strptr name = {};
+    uint32_t name = SYMBOL_NULL;
     Type::Flags flags = {};
     Type* type = nullptr;
 
     if (parse_type_flags(&flags))
     {
-        if (parse_base_type(&type))
+        if (parse_base_type(flags, &type))
         {
-            type->flags.all = flags.all;
-            parse_complete_type(type, &type, &name);
+            if (!parse_complete_type(type, &type, &name, nullptr) || (type == nullptr))
+            {
+                m_status = false;
+            }
         }
     }
 
     if(m_status)
     {
-        Function::Parameter* param = new Function::Parameter();
         param->name = name;
         param->type = type;
-
-        *ptr = param;
     }
 
     return m_status;
@@ -682,11 +677,12 @@ bool Parser::parse_body(List<Statement>* body)
 {
     expect(TK_OPEN_CURLY_BRACKET);
 
+    ListBuilder<Statement> statements(&m_list_stack);
     while(m_status)
     {
         if (accept(TK_CLOSE_CURLY_BRACKET))
         {
-            m_stack->pop();
+            m_stack->advance();
             break;
         }
         else
@@ -694,10 +690,11 @@ bool Parser::parse_body(List<Statement>* body)
             Statement* stmt = nullptr;
             if (parse_statement(&stmt))
             {
-                body->insert(stmt);
+                statements.insert(stmt);
             }
         }
     }
+    statements.seal(body, m_arena);
 
     return m_status;
 }
@@ -706,7 +703,7 @@ bool Parser::parse_block_stmt(Statement** ptr)
 {
     expect(TK_OPEN_CURLY_BRACKET);
 
-    List<Statement> body = {};
+    ListBuilder<Statement> body(&m_list_stack);
     while(m_status)
     {
         Statement* stmt = nullptr;
@@ -727,9 +724,10 @@ bool Parser::parse_block_stmt(Statement** ptr)
 
     if(m_status)
     {
-        Statement* stmt = new Statement();
+        Statement* stmt = m_arena->make<Statement>();
         stmt->type = STMT_BLOCK;
-        stmt->data.block.statements = body;
+        TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
+        body.seal(&stmt->data.block.statements, m_arena);
 
         *ptr = stmt;
     }
@@ -739,8 +737,10 @@ bool Parser::parse_block_stmt(Statement** ptr)
 
 bool Parser::parse_statement(Statement** ptr)
 {
-    Token tk = m_stack->peek();
-    switch(tk.type)
+    uint8_t type = m_stack->peek_type();
+    TRACE(TRACE_PARSER, "statement", type, m_stack->peek_offset());
+
+    switch(type)
     {
         case TK_FOR:    { parse_for_stmt(ptr); break; }
         case TK_WHILE:  { parse_while_stmt(ptr); break; }
@@ -759,14 +759,21 @@ bool Parser::parse_statement(Statement** ptr)
             break;
         }
         case TK_IDENTIFIER:
+        case TK_LITERAL:
         case TK_OPEN_ROUND_BRACKET:
+        case TK_ASTERISK:
+        case TK_AMPERSAND:
+        case TK_PLUS:
+        case TK_MINUS:
+        case TK_EXPLANATION_MARK:
+        case TK_TILDE:
         {
             parse_expression(ptr);
             break;
         }
         default:
         {
-            unexpected_token(tk.type, 0);
+            unexpected_token(type, 0, m_stack->peek_offset());
         }
     }
 
@@ -791,8 +798,9 @@ bool Parser::parse_return_statement(Statement** ptr)
 
     if(m_status)
     {
-        Statement* stmt = new Statement();
+        Statement* stmt = m_arena->make<Statement>();
         stmt->type = STMT_RETURN;
+        TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
         stmt->data.ret_stmt.expression = expr;
 
         *ptr = stmt;
@@ -813,7 +821,7 @@ bool Parser::parse_for_stmt(Statement** ptr)
     {
         if(accept(TK_SEMICOLON))
         {
-            m_stack->pop();
+            m_stack->advance();
         }
         else
         {
@@ -857,8 +865,9 @@ bool Parser::parse_for_stmt(Statement** ptr)
 
     if(m_status)
     {
-        Statement* stmt = new Statement();
+        Statement* stmt = m_arena->make<Statement>();
         stmt->type = STMT_FOR;
+        TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
         stmt->data.for_loop.init = init;
         stmt->data.for_loop.cond = cond;
         stmt->data.for_loop.step = step;
@@ -894,8 +903,9 @@ bool Parser::parse_while_stmt(Statement** ptr)
 
 	if(m_status)
 	{
-		Statement* stmt = new Statement();
+		Statement* stmt = m_arena->make<Statement>();
 		stmt->type = STMT_WHILE;
+		TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
 		stmt->data.while_loop.body = body;
 		stmt->data.while_loop.cond = expr;
 
@@ -930,14 +940,15 @@ bool Parser::parse_if_stmt(Statement** ptr)
     Statement* false_body = nullptr;
     if(m_status && accept(TK_ELSE))
     {
-        m_stack->pop();
+        m_stack->advance();
         parse_statement(&false_body);
     }
 
     if(m_status)
     {
-        Statement* stmt = new Statement();
+        Statement* stmt = m_arena->make<Statement>();
         stmt->type = STMT_IF;
+        TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
         stmt->data.cond_exec.condition = cond;
         stmt->data.cond_exec.on_true = true_body;
         stmt->data.cond_exec.on_false = false_body;
@@ -955,8 +966,9 @@ bool Parser::parse_expression(Statement** ptr)
     {
         if (expect(TK_SEMICOLON))
         {
-            Statement* stmt = new Statement();
+            Statement* stmt = m_arena->make<Statement>();
             stmt->type = STMT_EXPR;
+            TRACE(TRACE_AST, "statement", stmt->type, m_stack->last_offset());
             stmt->data.expr = expr;
 
             *ptr = stmt;
@@ -1008,201 +1020,261 @@ unsigned int Parser::get_op_precedence(uint8_t op)
     return ret;
 }
 
-Expression* Parser::process_expr_operand(ExpressionStack* stack)
+bool Parser::joined(uint8_t type)
 {
-    Expression* operand = stack->pop();
-    if (operand == nullptr)
-    {
-        error(ERROR_BAD_EXPRESSION);
-    }
+    // the lexer has no two-character operators, "++" is two TK_PLUS with
+    // nothing between them
+    return (m_stack->peek_type(1) == type) && (m_stack->peek_offset(1) == m_stack->peek_offset() + 1);
+}
 
-    if (m_status)
-    {
-        if (operand->type == EXPR_OPERATION) // process lhs operands
+uint8_t Parser::peek_binary_op(unsigned int* length)
+{
+    uint8_t op = EXPR_OP_INVALID;
+    unsigned int tokens = 1;
+
+    switch(m_stack->peek_type())
+    {
+        case TK_PLUS:          { op = EXPR_OP_ADD; break; }
+        case TK_MINUS:         { op = EXPR_OP_SUB; break; }
+        case TK_ASTERISK:      { op = EXPR_OP_MUL; break; }
+        case TK_FORWARD_SLASH: { op = EXPR_OP_DIV; break; }
+        case TK_PERCENT:       { op = EXPR_OP_MOD; break; }
+        case TK_CARET:         { op = EXPR_OP_BITWISE_XOR; break; }
+        case TK_AND:           { op = EXPR_OP_LOGICAL_AND; break; }
+        case TK_OR:            { op = EXPR_OP_LOGICAL_OR;  break; }
+        case TK_AMPERSAND:
         {
-            switch(operand->data.operation.op)
-            {
-                case EXPR_OP_REFERENCE:
-                case EXPR_OP_DEREFERENCE:
-                case EXPR_OP_DECREMENT:
-                case EXPR_OP_INCREMENT:
-                {
-                    operand->data.operation.rhs = process_expr_operand(stack);
-                    break;
-                }
-                default:
-                {
-                    error(ERROR_BAD_EXPRESSION);
-                }
-            }
+            if(joined(TK_AMPERSAND)) { op = EXPR_OP_LOGICAL_AND; tokens = 2; }
+            else                     { op = EXPR_OP_BITWISE_AND; }
+            break;
         }
-        else
+        case TK_VERTICAL_BAR:
         {
-            while (m_status)
-            {
-                Expression* look_ahead = stack->peek();
-                if ((look_ahead != nullptr) && (look_ahead->type == EXPR_FUNCTION_CALL))
-                {
-                    Expression* func_call = stack->pop();
-                    func_call->data.func_call.function = operand;
-                    operand = func_call;
-                }
-                else
-                {
-                    break;
-                }
-            }
+            if(joined(TK_VERTICAL_BAR)) { op = EXPR_OP_LOGICAL_OR; tokens = 2; }
+            else                        { op = EXPR_OP_BITWISE_OR; }
+            break;
         }
+        case TK_RIGHT_ARROW_HEAD:
+        {
+            if(joined(TK_RIGHT_ARROW_HEAD)) { op = EXPR_OP_BITWISE_R_SHIFT; tokens = 2; }
+            else if(joined(TK_EQUAL))       { op = EXPR_OP_CMP_MORE_THAN_OR_EQUAL; tokens = 2; }
+            else                            { op = EXPR_OP_CMP_MORE_THAN; }
+            break;
+        }
+        case TK_LEFT_ARROW_HEAD:
+        {
+            if(joined(TK_LEFT_ARROW_HEAD)) { op = EXPR_OP_BITWISE_L_SHIFT; tokens = 2; }
+            else if(joined(TK_EQUAL))      { op = EXPR_OP_CMP_LESS_THAN_OR_EQUAL; tokens = 2; }
+            else                           { op = EXPR_OP_CMP_LESS_THAN; }
+            break;
+        }
+        case TK_EQUAL:
+        {
+            if(joined(TK_EQUAL)) { op = EXPR_OP_CMP_EQUAL; tokens = 2; }
+            else                 { op = EXPR_OP_ASSIGN; }
+            break;
+        }
+        case TK_EXPLANATION_MARK:
+        {
+            if(joined(TK_EQUAL)) { op = EXPR_OP_CMP_NOT_EQUAL; tokens = 2; }
+            break;
+        }
+        default: { break; }
     }
 
-    // process rhs operands
+    *length = tokens;
+    return op;
+}
+
+Expression* Parser::make_operation(uint8_t op, Expression* lhs, Expression* rhs)
+{
+    Expression* expr = m_arena->make<Expression>();
+    expr->type = EXPR_OPERATION;
+    TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
+    expr->data.operation.op = op;
+    expr->data.operation.lhs = lhs;
+    expr->data.operation.rhs = rhs;
+
+    return expr;
+}
+
+bool Parser::parse_expression(Expression** ptr)
+{
+    return parse_expr_binary(ptr, get_op_precedence(EXPR_OP_ASSIGN));
+}
+
+bool Parser::parse_expr_binary(Expression** ptr, unsigned int min)
+{
+    Expression* lhs = nullptr;
+    parse_expr_unary(&lhs);
+
     while(m_status)
     {
-        Expression* look_ahead = stack->peek();
-        if ((look_ahead != nullptr) && (look_ahead->type == EXPR_OPERATION) && (look_ahead->data.operation.op == EXPR_OP_INCREMENT))
+        unsigned int length = 0;
+        uint8_t op = peek_binary_op(&length);
+
+        unsigned int precedence = get_op_precedence(op);
+        if((op == EXPR_OP_INVALID) || (precedence < min))
         {
-            Expression* op = stack->pop();
-            op->data.operation.lhs = operand;
-            operand = op;
+            break;
         }
-        else
+
+        for(unsigned int i = 0; i < length; i++)
         {
-            break;
+            m_stack->advance();
+        }
+        TRACE(TRACE_PARSER, "binary operator", op, m_stack->last_offset());
+
+        // operators of the same precedence group to the left, except for
+        // assignment, so a = b = c assigns c to b first
+        unsigned int next = (op == EXPR_OP_ASSIGN) ? precedence : (precedence + 1);
+
+        Expression* rhs = nullptr;
+        if(parse_expr_binary(&rhs, next))
+        {
+            lhs = make_operation(op, lhs, rhs);
         }
     }
 
-    return operand;
+    if(m_status)
+    {
+        *ptr = lhs;
+    }
+
+    return m_status;
 }
 
-Expression* Parser::process_expression(ExpressionStack* stack, Expression* lhs, uint8_t min)
+bool Parser::parse_expr_unary(Expression** ptr)
 {
-    Expression* expr = (lhs == nullptr) ? process_expr_operand(stack) : lhs;
+    uint8_t op = EXPR_OP_INVALID;
+    unsigned int length = 1;
 
-    while (m_status && !stack->is_empty())
+    uint8_t type = m_stack->peek_type();
+    switch(type)
     {
-        Expression* op1 = stack->peek();
-        if (op1->type != EXPR_OPERATION)
+        case TK_AMPERSAND:        { op = EXPR_OP_REFERENCE;   break; }
+        case TK_ASTERISK:         { op = EXPR_OP_DEREFERENCE; break; }
+        case TK_EXPLANATION_MARK: { op = EXPR_OP_LOGICAL_NOT; break; }
+        case TK_TILDE:            { op = EXPR_OP_BITWISE_COMPLEMENT; break; }
+        case TK_PLUS:
         {
-            error(ERROR_BAD_EXPRESSION);
+            if(joined(TK_PLUS)) { op = EXPR_OP_INCREMENT; length = 2; }
+            break;
         }
-        else
+        case TK_MINUS:
         {
-            unsigned int op1_prec = get_op_precedence(op1->data.operation.op);
-            if (op1_prec < min)
-            {
-                break;
-            }
-            else
-            {
-                stack->pop(); // consume the first operator
-                Expression* rhs = process_expr_operand(stack);
-
-                Expression* op2 = nullptr;
-                if (!stack->is_empty())
-                {
-                    op2 = stack->peek();
-                    if (op2->type != EXPR_OPERATION)
-                    {
-                        error(ERROR_BAD_EXPRESSION);
-                    }
-                }
+            if(joined(TK_MINUS)) { op = EXPR_OP_DECREMENT; length = 2; }
+            break;
+        }
+        default: { break; }
+    }
 
-                unsigned int op2_prec = (op2 == nullptr) ? 0 : get_op_precedence(op2->data.operation.op);
-                if ((op2 != nullptr) && (op2_prec > op1_prec))
-                {
-                    rhs = process_expression(stack, rhs, op2_prec);
-                }
+    if(op != EXPR_OP_INVALID)
+    {
+        for(unsigned int i = 0; i < length; i++)
+        {
+            m_stack->advance();
+        }
 
-                op1->data.operation.lhs = expr;
-                op1->data.operation.rhs = rhs;
-                expr = op1;
-            }
+        // the operand of a prefix operator includes its postfix operators,
+        // so *p++ is *(p++)
+        Expression* operand = nullptr;
+        if(parse_expr_unary(&operand))
+        {
+            *ptr = make_operation(op, nullptr, operand);
         }
     }
+    else if(type == TK_OPEN_ROUND_BRACKET)
+    {
+        // "(U32*) p" is a cast, any other bracket starts a sub-expression
+        uint8_t next = m_stack->peek_type(1);
+        if((next == TK_TYPE) || (next == TK_CONST))
+        {
+            parse_cast(ptr);
+        }
+        else
+        {
+            parse_expr_postfix(ptr);
+        }
+    }
+    else
+    {
+        parse_expr_postfix(ptr);
+    }
 
-    return expr;
+    return m_status;
 }
 
-bool Parser::parse_expression(Expression** ptr)
+bool Parser::parse_expr_postfix(Expression** ptr)
 {
-    ExpressionStack stack(&m_expr_stack);
-    while(m_status)
-    {
-        Expression* expr = nullptr;
+    Expression* expr = nullptr;
 
-        while(m_status)
+    uint8_t type = m_stack->peek_type();
+    switch(type)
+    {
+        case TK_LITERAL:            { parse_expr_literal(&expr);    break; }
+        case TK_IDENTIFIER:         { parse_expr_identifier(&expr); break; }
+        case TK_OPEN_ROUND_BRACKET: { parse_sub_expr(&expr);        break; }
+        default:
         {
-            expr = nullptr;
-            if(parse_expr_lhs_op(&expr))
-            {
-                if(expr == nullptr) { break; }
-                else { stack.insert(expr); }
-            }
+            unexpected_token(type, 0, m_stack->peek_offset());
         }
+    }
 
-        if(m_status)
+    while(m_status)
+    {
+        type = m_stack->peek_type();
+        if(type == TK_OPEN_ROUND_BRACKET)
         {
-            Token tk = m_stack->peek();
-            switch(tk.type)
-            {
-                case TK_LITERAL:            { parse_expr_literal(&expr);    break; }
-                case TK_IDENTIFIER:         { parse_expr_identifier(&expr); break; }
-                case TK_OPEN_ROUND_BRACKET: { parse_sub_expr(&expr);        break; }
-                default:
-                {
-                    unexpected_token(tk.type, 0);
-                }
-            }
+            parse_expr_args(expr, &expr);
+        }
+        else if(type == TK_OPEN_SQUARE_BRACKET)
+        {
+            m_stack->advance();
 
-            if(m_status)
+            Expression* index = nullptr;
+            if(parse_expression(&index) && expect(TK_CLOSE_SQUARE_BRACKET))
             {
-                stack.insert(expr);
+                expr = make_operation(EXPR_OP_INDEX, expr, index);
             }
         }
-
-        while(m_status)
+        else if(type == TK_DOT)
         {
-            expr = nullptr;
-            if(parse_expr_rhs_op(&expr))
+            m_stack->advance();
+
+            Expression* field = nullptr;
+            if(parse_expr_identifier(&field))
             {
-                if(expr == nullptr) { break; }
-                else { stack.insert(expr); }
+                expr = make_operation(EXPR_OP_ACCESS_FIELD, expr, field);
             }
         }
-
-        if(m_status)
+        else if((type == TK_MINUS) && joined(TK_RIGHT_ARROW_HEAD))
         {
-            // parse function call arguments
-            while(m_status && accept(TK_OPEN_ROUND_BRACKET))
+            m_stack->advance();
+            m_stack->advance();
+
+            Expression* field = nullptr;
+            if(parse_expr_identifier(&field))
             {
-                Expression* args = nullptr;
-                if(parse_expr_args(&args))
-                {
-                    stack.insert(args);
-                }
+                expr = make_operation(EXPR_OP_ACCESS_FIELD_PTR, expr, field);
             }
         }
+        else if(((type == TK_PLUS) || (type == TK_MINUS)) && joined(type))
+        {
+            m_stack->advance();
+            m_stack->advance();
 
-        if (m_status)
+            expr = make_operation((type == TK_PLUS) ? EXPR_OP_INCREMENT : EXPR_OP_DECREMENT, expr, nullptr);
+        }
+        else
         {
-            if (accept(TK_SEMICOLON) || accept(TK_CLOSE_ROUND_BRACKET) || accept(TK_COMMA))
-            {
-                break;
-            }
-            else
-            {
-                Expression* op = nullptr;
-                if (parse_expr_operator(&op))
-                {
-                    stack.insert(op);
-                }
-            }
+            break;
         }
     }
 
     if(m_status)
     {
-        *ptr = process_expression(&stack, nullptr, 0);
+        *ptr = expr;
     }
 
     return m_status;
@@ -1220,8 +1292,9 @@ bool Parser::parse_sub_expr(Expression** ptr)
 
     if(m_status)
     {
-        Expression* expr = new Expression();
+        Expression* expr = m_arena->make<Expression>();
         expr->type = EXPR_SUB_EXPR;
+        TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
         expr->data.sub_expr = sub_expr;
 
         *ptr = expr;
@@ -1230,165 +1303,43 @@ bool Parser::parse_sub_expr(Expression** ptr)
     return m_status;
 }
 
-bool Parser::parse_expr_lhs_op(Expression** ptr)
+bool Parser::parse_cast(Expression** ptr)
 {
-    uint8_t op = EXPR_OP_INVALID;
-
-    Token tk = m_stack->peek();
-    switch(tk.type)
-    {
-        case TK_AMPERSAND: { op = EXPR_OP_REFERENCE;   break; }
-        case TK_ASTERISK:  { op = EXPR_OP_DEREFERENCE; break; }
-        case TK_PLUS:
-        {
-            if(m_stack->look_ahead().type == TK_PLUS)
-            {
-                m_stack->pop();
-                op = EXPR_OP_INCREMENT;
-            }
-            break;
-        }
-        default: { break; }
-    }
-
-    if(op != EXPR_OP_INVALID)
-    {
-        m_stack->pop();
-
-        Expression* expr = new Expression();
-        expr->type = EXPR_OPERATION;
-        expr->data.operation.op = op;
-
-        *ptr = expr;
-    }
-
-    return m_status;
-}
+    Type::Flags flags = {};
+    Type* type = nullptr;
+    uint32_t name = SYMBOL_NULL;
 
-bool Parser::parse_expr_rhs_op(Expression** ptr)
-{
-    uint8_t op = EXPR_OP_INVALID;
+    expect(TK_OPEN_ROUND_BRACKET);
 
-    Token tk = m_stack->peek();
-    switch(tk.type)
+    if (m_status && parse_type_flags(&flags) && parse_base_type(flags, &type))
     {
-        case TK_PLUS:
+        if (!parse_complete_type(type, &type, &name, nullptr) || (type == nullptr))
         {
-            if(m_stack->look_ahead().type == TK_PLUS)
-            {
-                m_stack->pop();
-                op = EXPR_OP_INCREMENT;
-            }
-            break;
+            m_status = false;
         }
-        default: { break; }
     }
 
-    if(op != EXPR_OP_INVALID)
+    if (m_status)
     {
-        m_stack->pop();
-
-        Expression* expr = new Expression();
-        expr->type = EXPR_OPERATION;
-        expr->data.operation.op = op;
-
-        *ptr = expr;
-    }
-
-    return m_status;
-}
-
-bool Parser::parse_expr_operator(Expression** ptr)
-{
-    uint8_t op = 0;
-
-    Token tk = m_stack->pop();
-    switch (tk.type)
-    {
-        case TK_PLUS:             { op = EXPR_OP_ADD; break; }
-        case TK_ASTERISK:         { op = EXPR_OP_MUL; break; }
-        case TK_FORWARD_SLASH:    { op = EXPR_OP_DIV; break; }
-        case TK_PERCENT:          { op = EXPR_OP_MOD; break; }
-        case TK_DOT:              { op = EXPR_OP_ACCESS_FIELD; break; }
-        case TK_OR:               { op = EXPR_OP_LOGICAL_OR;   break; }
-        case TK_AND:              { op = EXPR_OP_LOGICAL_AND;  break; }
-        case TK_EXPLANATION_MARK: { op = EXPR_OP_LOGICAL_NOT;  break; }
-        case TK_VERTICAL_BAR:     { op = EXPR_OP_BITWISE_OR;   break; }
-        case TK_AMPERSAND:        { op = EXPR_OP_BITWISE_AND;  break; }
-        case TK_TILDE:            { op = EXPR_OP_BITWISE_COMPLEMENT; break; }
-        case TK_MINUS:
+        if (name != SYMBOL_NULL)
         {
-            if(accept(TK_RIGHT_ARROW_HEAD))
-            {
-                m_stack->pop();
-                op = EXPR_OP_ACCESS_FIELD_PTR;
-            }
-            else
-            {
-                op = EXPR_OP_SUB;
-            }
-            break;
+            unexpected_token(TK_IDENTIFIER, 0, m_stack->last_offset());
         }
-        case TK_RIGHT_ARROW_HEAD:
-        {
-            if(accept(TK_RIGHT_ARROW_HEAD))
-            {
-                m_stack->pop();
-                op = EXPR_OP_BITWISE_R_SHIFT;
-            }
-            else if(accept(TK_EQUAL))
-            {
-                m_stack->pop();
-                op = EXPR_OP_CMP_MORE_THAN_OR_EQUAL;
-            }
-            else
-            {
-                op = EXPR_OP_CMP_MORE_THAN;
-            }
-            break;
-        }
-        case TK_LEFT_ARROW_HEAD:
-        {
-            if(accept(TK_LEFT_ARROW_HEAD))
-            {
-                m_stack->pop();
-                op = EXPR_OP_BITWISE_L_SHIFT;
-            }
-            else if(accept(TK_EQUAL))
-            {
-                m_stack->pop();
-                op = EXPR_OP_CMP_LESS_THAN_OR_EQUAL;
-            }
-            else
-            {
-                op = EXPR_OP_CMP_LESS_THAN;
-            }
-            break;
-        }
-        case TK_EQUAL:
-        {
-            if(accept(TK_EQUAL))
-            {
-                m_stack->pop();
-                op = EXPR_OP_CMP_EQUAL;
-            }
-            else
-            {
-                op = EXPR_OP_ASSIGN;
-            }
-            break;
-        }
-        default:
+        else
         {
-            unexpected_token(tk.type, 0);
+            expect(TK_CLOSE_ROUND_BRACKET);
         }
     }
 
-    if(m_status)
+    // a cast binds like a prefix operator
+    Expression* operand = nullptr;
+    if (m_status && parse_expr_unary(&operand))
     {
-        Expression* expr = new Expression();
-        expr->type = EXPR_OPERATION;
-        expr->data.operation.op = op;
+        Expression* expr = m_arena->make<Expression>();
+        expr->type = EXPR_STATIC_CAST;
+        TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
+        expr->data.cast.type = type;
+        expr->data.cast.expr = operand;
 
         *ptr = expr;
     }
@@ -1396,17 +1347,17 @@ bool Parser::parse_expr_operator(Expression** ptr)
     return m_status;
 }
 
-bool Parser::parse_expr_args(Expression** ptr)
+bool Parser::parse_expr_args(Expression* function, Expression** ptr)
 {
     expect(TK_OPEN_ROUND_BRACKET);
 
-    List<Expression> args = {};
+    ListBuilder<Expression> args(&m_list_stack);
 
     if(m_status)
     {
         if(accept(TK_CLOSE_ROUND_BRACKET))
         {
-            m_stack->pop();
+            m_stack->advance();
         }
         else
         {
@@ -1419,7 +1370,7 @@ bool Parser::parse_expr_args(Expression** ptr)
 
                     if(accept(TK_CLOSE_ROUND_BRACKET))
                     {
-                        m_stack->pop();
+                        m_stack->advance();
                         break;
                     }
                     else
@@ -1433,9 +1384,11 @@ bool Parser::parse_expr_args(Expression** ptr)
 
     if(m_status)
     {
-        Expression* expr = new Expression();
+        Expression* expr = m_arena->make<Expression>();
         expr->type = EXPR_FUNCTION_CALL;
-        expr->data.func_call.arguments = args;
+        TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
+        expr->data.func_call.function = function;
+        args.seal(&expr->data.func_call.arguments, m_arena);
 
         *ptr = expr;
     }
@@ -1445,18 +1398,21 @@ bool Parser::parse_expr_args(Expression** ptr)
 
 bool Parser::parse_expr_literal(Expression** ptr)
 {
-    Token tk = m_stack->pop();
-    if(tk.type == TK_LITERAL)
+    uint8_t tk = m_stack->peek_type();
+    if(tk == TK_LITERAL)
     {
-        Expression* expr = new Expression();
+        Expression* expr = m_arena->make<Expression>();
         expr->type = EXPR_LITERAL;
-        expr->data.literal = tk.data.literal;
+        expr->data.literal = m_stack->peek_literal();
+        m_stack->advance();
+        TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
 
         *ptr = expr;
     }
     else
     {
-        unexpected_token(tk.type, 0);
+        m_stack->advance();
+        unexpected_token(tk, 0, m_stack->last_offset());
     }
 
     return m_status;
@@ -1464,18 +1420,22 @@ bool Parser::parse_expr_literal(Expression** ptr)
 
 bool Parser::parse_expr_identifier(Expression** ptr)
 {
-    Token tk = m_stack->pop();
-    if(tk.type == TK_IDENTIFIER)
+    uint8_t tk = m_stack->peek_type();
+    uint32_t id = m_stack->peek_identifier();
+    m_stack->advance();
+
+    if(tk == TK_IDENTIFIER)
     {
-        Expression* expr = new Expression();
+        Expression* expr = m_arena->make<Expression>();
         expr->type = EXPR_IDENTIFIER;
-        expr->data.identifier = tk.data.identifier;
+        TRACE(TRACE_AST, "expression", expr->type, m_stack->last_offset());
+        expr->data.identifier = id;
 
         *ptr = expr;
     }
     else
     {
-        unexpected_token(tk.type, 0);
+        unexpected_token(tk, 0, m_stack->last_offset());
     }
 
     return m_status;
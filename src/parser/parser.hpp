@@ -5,39 +5,52 @@
 
 #include <ast.hpp>
 #include <token_stack.hpp>
-#include <expression_stack.hpp>
+#include <type_context.hpp>
 
 class Parser
 {
 private:
     bool m_status;
 	TokenStack* m_stack;
+    AstArena* m_arena; // every node comes from the AST's arena
+    TypeContext* m_types; // and every type from its type context
 
-    std::vector<Expression*> m_expr_stack;
+    std::vector<void*> m_list_stack; // shared by every ListBuilder
+    std::vector<Function::Parameter> m_param_stack; // parameters of the signatures being read, innermost last
+    std::vector<Type*> m_param_types; // the types of one signature, as the type context takes them
 
 private:
-    Parser(TokenStack& stack);
+    Parser(TokenStack& stack, AstArena* arena, TypeContext* types);
     
     void error(const char* msg);
-    void unexpected_token(uint8_t tk, uint8_t ex);
+    // offset is where the token starts in the source, for the error location
+    void unexpected_token(uint8_t tk, uint8_t ex, uint32_t offset);
 
     bool accept(uint8_t type);
     bool expect(uint8_t type);
 
     unsigned int get_op_precedence(uint8_t op);
-    Expression* process_expr_operand(ExpressionStack* stack);
-    Expression* process_expression(ExpressionStack* stack, Expression* lhs, uint8_t min);
+    // whether the token after the current one is type and touches it
+    bool joined(uint8_t type);
+    // the binary operator at the cursor and how many tokens it spans
+    uint8_t peek_binary_op(unsigned int* length);
+    Expression* make_operation(uint8_t op, Expression* lhs, Expression* rhs);
 
     bool parse_body(List<Statement>* body);
-    bool parse_base_type(Type** ptr);
-    bool parse_complete_type(Type* base_type, Type** ptr, strptr* name);
+    bool parse_base_type(Type::Flags flags, Type** ptr);
+    // params, unless nullptr, receives the named parameters of the function
+    // the declarator declares, and is left alone if it declares none
+    bool parse_complete_type(Type* base_type, Type** ptr, uint32_t* name, List<Function::Parameter>** params);
+    bool parse_nested_declarator(Type* base_type, Type** ptr, uint32_t* name, List<Function::Parameter>** params);
+    bool skip_brackets();
+    bool parse_cast(Expression** ptr);
     bool parse_type_flags(Type::Flags* flags);
-    bool parse_identifier(strptr* id);
-    bool parse_parameter(Function::Parameter** ptr);
+    bool parse_identifier(uint32_t* id);
+    bool parse_parameter(Function::Parameter* param);
 
     bool parse_global_statement(Statement** ptr);
     bool parse_declaration(Statement** ptr);
-    bool parse_declaration(Type* base_type, List<Declaration>* decl_list);
+    bool parse_declaration(Type* base_type, ListBuilder<Declaration>* decl_list);
     bool parse_statement(Statement** ptr);
     bool parse_for_stmt(Statement** ptr);
     bool parse_while_stmt(Statement** ptr);
@@ -46,19 +59,26 @@ private:
     bool parse_if_stmt(Statement** ptr);
     bool parse_block_stmt(Statement** ptr);
 
+    // Expressions are parsed by precedence climbing straight off the cursor:
+    // a binary expression is a unary one followed by operators that bind at
+    // least as tightly as min, each with its right operand parsed one level
+    // tighter, and a unary expression is any prefix operators or casts over a
+    // primary with its postfix operators, calls and indexing.
     bool parse_expression(Expression** ptr);
+    bool parse_expr_binary(Expression** ptr, unsigned int min);
+    bool parse_expr_unary(Expression** ptr);
+    bool parse_expr_postfix(Expression** ptr);
     bool parse_expr_literal(Expression** ptr);
     bool parse_expr_identifier(Expression** ptr);
-    bool parse_expr_lhs_op(Expression** ptr);
-    bool parse_expr_rhs_op(Expression** ptr);
-    bool parse_expr_operator(Expression** ptr);
-    bool parse_expr_args(Expression** ptr);
+    bool parse_expr_args(Expression* function, Expression** ptr);
     bool parse_sub_expr(Expression** ptr);
 
-    bool parse_function_parameters(List<Function::Parameter>* params);
+    // the function type returning return_type with the parameters at the
+    // cursor, and the parameters with their names in params unless nullptr
+    bool parse_function_parameters(Type* return_type, Type** ptr, List<Function::Parameter>** params);
     bool parse_composite_declaration(Declaration** ptr);
-    bool parse_function_definition(Type* type, strptr name, Declaration** ptr);
-    bool parse_variable_definition(Type* type, strptr name, Declaration** ptr);
+    bool parse_function_definition(Type* type, uint32_t name, List<Function::Parameter>* params, Declaration** ptr);
+    bool parse_variable_definition(Type* type, uint32_t name, Declaration** ptr);
 
 public:
     static AST* Parse(TokenStack& stack);
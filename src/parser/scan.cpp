@@ -0,0 +1,303 @@
+#include <scan.hpp>
+
+#include <ascii.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_SSE2 1
+#define SCAN_AVX2 1
+#define SCAN_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define SCAN_SSE2 1
+#include <intrin.h>
+#include <emmintrin.h>
+#endif
+
+#define IS_IDENTIFIER(x) (IS_ALPHA_NUM(x) || ((x) == '_'))
+
+static const char* skip_space_scalar(const char* ptr, const char* end)
+{
+    while((ptr < end) && IS_SPACE(*ptr)) { ptr++; }
+    return ptr;
+}
+
+static const char* skip_identifier_scalar(const char* ptr, const char* end)
+{
+    while((ptr < end) && IS_IDENTIFIER(*ptr)) { ptr++; }
+    return ptr;
+}
+
+static const char* find_comment_end_scalar(const char* ptr, const char* end)
+{
+    for(; ptr + 1 < end; ptr++)
+    {
+        if((ptr[0] == '*') && (ptr[1] == '/')) { return ptr; }
+    }
+    return end;
+}
+
+static const char* find_newline_scalar(const char* ptr, const char* end)
+{
+    while((ptr < end) && (*ptr != '\n')) { ptr++; }
+    return ptr;
+}
+
+#ifdef SCAN_SSE2
+
+static inline unsigned int first_bit(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return (unsigned int) index;
+#else
+    return (unsigned int) __builtin_ctz(mask);
+#endif
+}
+
+// bytes >= 0x80 compare as negative, so none of the signed range checks
+// below can match them - they never belong to a whitespace or identifier run
+
+static inline __m128i space_mask_sse2(__m128i v)
+{
+    __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i tb = _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'));
+    __m128i nl = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    return _mm_or_si128(sp, _mm_or_si128(tb, nl));
+}
+
+static inline __m128i identifier_mask_sse2(__m128i v)
+{
+    __m128i lower  = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i alpha  = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit  = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    __m128i under  = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_or_si128(alpha, _mm_or_si128(digit, under));
+}
+
+static const char* skip_space_sse2(const char* ptr, const char* end)
+{
+    while(end - ptr >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) ptr);
+        unsigned int mask = ~(unsigned int) _mm_movemask_epi8(space_mask_sse2(v)) & 0xFFFF;
+        if(mask != 0) { return ptr + first_bit(mask); }
+        ptr += 16;
+    }
+    return skip_space_scalar(ptr, end);
+}
+
+static const char* skip_identifier_sse2(const char* ptr, const char* end)
+{
+    while(end - ptr >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) ptr);
+        unsigned int mask = ~(unsigned int) _mm_movemask_epi8(identifier_mask_sse2(v)) & 0xFFFF;
+        if(mask != 0) { return ptr + first_bit(mask); }
+        ptr += 16;
+    }
+    return skip_identifier_scalar(ptr, end);
+}
+
+static const char* find_comment_end_sse2(const char* ptr, const char* end)
+{
+    const __m128i star  = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    while(end - ptr >= 17)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*) ptr);
+        __m128i v1 = _mm_loadu_si128((const __m128i*) (ptr + 1));
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v0, star), _mm_cmpeq_epi8(v1, slash)));
+        if(mask != 0) { return ptr + first_bit(mask); }
+        ptr += 16;
+    }
+    return find_comment_end_scalar(ptr, end);
+}
+
+static const char* find_newline_sse2(const char* ptr, const char* end)
+{
+    const __m128i nl = _mm_set1_epi8('\n');
+
+    while(end - ptr >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) ptr);
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+        if(mask != 0) { return ptr + first_bit(mask); }
+        ptr += 16;
+    }
+    return find_newline_scalar(ptr, end);
+}
+
+#endif // SCAN_SSE2
+
+#ifdef SCAN_AVX2
+
+SCAN_AVX2_TARGET static inline __m256i space_mask_avx2(__m256i v)
+{
+    __m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    __m256i tb = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'));
+    __m256i nl = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    return _mm256_or_si256(sp, _mm256_or_si256(tb, nl));
+}
+
+SCAN_AVX2_TARGET static inline __m256i identifier_mask_avx2(__m256i v)
+{
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(alpha, _mm256_or_si256(digit, under));
+}
+
+SCAN_AVX2_TARGET static const char* skip_space_avx2(const char* ptr, const char* end)
+{
+    while(end - ptr >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) ptr);
+        unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(space_mask_avx2(v));
+        if(mask != 0) { return ptr + __builtin_ctz(mask); }
+        ptr += 32;
+    }
+    return skip_space_sse2(ptr, end);
+}
+
+SCAN_AVX2_TARGET static const char* skip_identifier_avx2(const char* ptr, const char* end)
+{
+    while(end - ptr >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) ptr);
+        unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(identifier_mask_avx2(v));
+        if(mask != 0) { return ptr + __builtin_ctz(mask); }
+        ptr += 32;
+    }
+    return skip_identifier_sse2(ptr, end);
+}
+
+SCAN_AVX2_TARGET static const char* find_comment_end_avx2(const char* ptr, const char* end)
+{
+    const __m256i star  = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+
+    while(end - ptr >= 33)
+    {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*) ptr);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*) (ptr + 1));
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(v0, star), _mm256_cmpeq_epi8(v1, slash)));
+        if(mask != 0) { return ptr + __builtin_ctz(mask); }
+        ptr += 32;
+    }
+    return find_comment_end_sse2(ptr, end);
+}
+
+SCAN_AVX2_TARGET static const char* find_newline_avx2(const char* ptr, const char* end)
+{
+    const __m256i nl = _mm256_set1_epi8('\n');
+
+    while(end - ptr >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) ptr);
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+        if(mask != 0) { return ptr + __builtin_ctz(mask); }
+        ptr += 32;
+    }
+    return find_newline_sse2(ptr, end);
+}
+
+#endif // SCAN_AVX2
+
+// constant-initialized so the scalar kernels are usable even before the
+// static initializer below has picked the best level for this CPU
+Scan::Kernel Scan::SkipSpace      = skip_space_scalar;
+Scan::Kernel Scan::SkipIdentifier = skip_identifier_scalar;
+Scan::Kernel Scan::FindCommentEnd = find_comment_end_scalar;
+Scan::Kernel Scan::FindNewline    = find_newline_scalar;
+
+static Scan::LEVEL s_level = Scan::LEVEL_SCALAR;
+
+Scan::LEVEL Scan::Detect()
+{
+    LEVEL level = LEVEL_SCALAR;
+
+#if defined(SCAN_AVX2)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        level = LEVEL_AVX2;
+    }
+    else if(__builtin_cpu_supports("sse2"))
+    {
+        level = LEVEL_SSE2;
+    }
+#elif defined(SCAN_SSE2)
+    level = LEVEL_SSE2; // baseline for x64
+#endif
+
+    return level;
+}
+
+Scan::LEVEL Scan::Level()
+{
+    return s_level;
+}
+
+bool Scan::Select(LEVEL level)
+{
+    bool status = (level <= Detect());
+
+    if(status)
+    {
+        switch(level)
+        {
+#ifdef SCAN_AVX2
+            case LEVEL_AVX2:
+            {
+                SkipSpace      = skip_space_avx2;
+                SkipIdentifier = skip_identifier_avx2;
+                FindCommentEnd = find_comment_end_avx2;
+                FindNewline    = find_newline_avx2;
+                break;
+            }
+#endif
+#ifdef SCAN_SSE2
+            case LEVEL_SSE2:
+            {
+                SkipSpace      = skip_space_sse2;
+                SkipIdentifier = skip_identifier_sse2;
+                FindCommentEnd = find_comment_end_sse2;
+                FindNewline    = find_newline_sse2;
+                break;
+            }
+#endif
+            default:
+            {
+                SkipSpace      = skip_space_scalar;
+                SkipIdentifier = skip_identifier_scalar;
+                FindCommentEnd = find_comment_end_scalar;
+                FindNewline    = find_newline_scalar;
+                break;
+            }
+        }
+
+        s_level = level;
+    }
+
+    return status;
+}
+
+const char* Scan::LevelName(LEVEL level)
+{
+    const char* name = "scalar";
+    switch(level)
+    {
+        case LEVEL_SSE2: { name = "sse2"; break; }
+        case LEVEL_AVX2: { name = "avx2"; break; }
+        default: { break; }
+    }
+    return name;
+}
+
+static struct ScanInit
+{
+    ScanInit() { Scan::Select(Scan::Detect()); }
+} s_scan_init;
@@ -0,0 +1,37 @@
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+// Bulk character-class scanners used by the tokenizer's hot loops. Every
+// kernel takes a [ptr, end) range and returns a pointer to the first byte
+// that stops the scan, or 'end' if there is none. The SIMD variants are
+// picked once at startup based on the CPU; Select() can force a lower level.
+class Scan
+{
+public:
+    enum LEVEL
+    {
+        LEVEL_SCALAR = 0,
+        LEVEL_SSE2   = 1,
+        LEVEL_AVX2   = 2
+    };
+
+    typedef const char* (*Kernel)(const char* ptr, const char* end);
+
+    // first byte that is not ' ', '\t' or '\n'
+    static Kernel SkipSpace;
+    // first byte that is not [A-Za-z0-9_]
+    static Kernel SkipIdentifier;
+    // the '*' of the first "*/" pair
+    static Kernel FindCommentEnd;
+    // the first '\n'
+    static Kernel FindNewline;
+
+public:
+    static LEVEL Detect();
+    static LEVEL Level();
+    static bool  Select(LEVEL level);
+
+    static const char* LevelName(LEVEL level);
+};
+
+#endif // SCAN_HPP
@@ -1,32 +1,146 @@
 #include <symbol_table.hpp>
 
+#include <interner.hpp>
+
+const uint32_t SymbolTable::NONE;
+
 SymbolTable::SymbolTable()
 {
+    m_slots.resize(INITIAL_SLOTS, Slot { SYMBOL_NULL, NONE });
+    m_mask = INITIAL_SLOTS - 1;
+    m_used = 0;
+
+    m_scopes.push_back(0);
 }
 
 SymbolTable::~SymbolTable()
 {
 }
 
-void SymbolTable::pop()
+uint32_t SymbolTable::find_slot(uint32_t name) const
 {
+    // ids are dense, so spread them before masking
+    uint32_t hash = name * 0x9E3779B9u;
+    uint32_t i = (hash ^ (hash >> 16)) & m_mask;
+
+    while((m_slots[i].name != SYMBOL_NULL) && (m_slots[i].name != name))
+    {
+        i = (i + 1) & m_mask;
+    }
+
+    return i;
+}
+
+void SymbolTable::grow()
+{
+    std::vector<Slot> slots;
+    slots.swap(m_slots);
+
+    m_mask = (m_mask << 1) | 1;
+    m_slots.resize((size_t) m_mask + 1, Slot { SYMBOL_NULL, NONE });
+    m_used = 0;
+
+    // names whose every binding has been popped are dropped here
+    for(const Slot& slot : slots)
+    {
+        if((slot.name != SYMBOL_NULL) && (slot.binding != NONE))
+        {
+            m_slots[find_slot(slot.name)] = slot;
+            m_used++;
+        }
+    }
 }
 
 void SymbolTable::push()
 {
+    m_scopes.push_back((uint32_t) m_bindings.size());
+}
+
+void SymbolTable::pop()
+{
+    if(m_scopes.size() > 1)
+    {
+        uint32_t start = m_scopes.back();
+        m_scopes.pop_back();
+
+        // unwind in reverse, so a name bound twice ends up at its outer binding
+        for(uint32_t i = (uint32_t) m_bindings.size(); i > start; i--)
+        {
+            const Binding& binding = m_bindings[i - 1];
+            m_slots[find_slot(binding.entry.name)].binding = binding.shadowed;
+        }
+        m_bindings.resize(start);
+    }
+}
+
+bool SymbolTable::insert(const Entry& entry)
+{
+    bool status = (entry.name != SYMBOL_NULL);
+
+    if(status)
+    {
+        // keep the load factor at or below one half
+        if((m_used + 1) * 2 > m_mask + 1)
+        {
+            grow();
+        }
+
+        Slot& slot = m_slots[find_slot(entry.name)];
+        if((slot.binding != NONE) && (slot.binding >= m_scopes.back()))
+        {
+            status = false;
+        }
+        else
+        {
+            if(slot.name == SYMBOL_NULL)
+            {
+                slot.name = entry.name;
+                m_used++;
+            }
+
+            Binding binding = { entry, slot.binding };
+            slot.binding = (uint32_t) m_bindings.size();
+            m_bindings.push_back(binding);
+        }
+    }
+
+    return status;
+}
+
+const SymbolTable::Entry* SymbolTable::search(uint32_t name) const
+{
+    const Entry* entry = nullptr;
+    if(name != SYMBOL_NULL)
+    {
+        uint32_t binding = m_slots[find_slot(name)].binding;
+        if(binding != NONE)
+        {
+            entry = &m_bindings[binding].entry;
+        }
+    }
+    return entry;
 }
 
-bool SymbolTable::insert(Entry* entry)
+const SymbolTable::Entry* SymbolTable::search_local(uint32_t name) const
 {
-    return false;
+    const Entry* entry = nullptr;
+    if(name != SYMBOL_NULL)
+    {
+        uint32_t binding = m_slots[find_slot(name)].binding;
+        if((binding != NONE) && (binding >= m_scopes.back()))
+        {
+            entry = &m_bindings[binding].entry;
+        }
+    }
+    return entry;
 }
 
-const SymbolTable::Entry* SymbolTable::search(const strptr& name)
+unsigned int SymbolTable::depth() const
 {
-    return nullptr;
+    return (unsigned int) m_scopes.size();
 }
 
-const SymbolTable::Entry* SymbolTable::search(const strptr& name, const Entry* entry)
+unsigned int SymbolTable::size() const
 {
-    return nullptr;
+    return (unsigned int) m_bindings.size();
 }
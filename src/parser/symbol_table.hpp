@@ -3,7 +3,10 @@
 
 #include <stdint.h>
 
-#include <strptr.hpp>
+#include <vector>
+
+struct Declaration;
+struct Type;
 
 enum SYM_TYPE
 {
@@ -12,40 +15,77 @@ enum SYM_TYPE
     SYM_FUNCTION   = 0x2,
     SYM_COMPOSITE  = 0x3,
     SYM_ENUMERATOR = 0x4,
-    SYM_TYPE_MAX   = 0x5
+    SYM_TYPEDEF    = 0x5,
+    SYM_TYPE_MAX   = 0x6
 };
 
+// Scoped names, keyed by interned symbol id. One open-addressing map takes
+// every name to its innermost binding, and each binding remembers the one it
+// shadows. Bindings are appended to an undo log in declaration order and a
+// scope is just the log position at its push(), so pop() unwinds exactly the
+// names that scope declared and a lookup costs the same at any depth.
 class SymbolTable
 {
 public:
     struct Entry
     {
-        uint8_t type;
-        strptr  name;
+        uint8_t  type; // SYM_*
+        uint32_t name; // symbol id
+        const Declaration* decl; // the enum of an enumerator, nullptr for parameters and typedefs
+        const Type* data_type;   // of a variable, function or enumerator, or the one a typedef names
+    };
 
-        Entry* l_child;
-        Entry* r_child;
+private:
+    enum
+    {
+        INITIAL_SLOTS = 256
     };
 
-    struct Scope
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    struct Slot
     {
-        Entry* root;
-        Scope* next;
-        Scope* prev;
+        uint32_t name;    // SYMBOL_NULL when empty
+        uint32_t binding; // innermost binding, NONE once every scope binding it has closed
     };
 
+    struct Binding
+    {
+        Entry    entry;
+        uint32_t shadowed; // binding of the same name in an enclosing scope, or NONE
+    };
+
+    std::vector<Slot>     m_slots;
+    uint32_t              m_mask;
+    uint32_t              m_used;     // slots holding a name
+    std::vector<Binding>  m_bindings; // the undo log
+    std::vector<uint32_t> m_scopes;   // log position at each open push()
+
 private:
-    const Entry* search(const strptr& name, const Entry* entry);
+    uint32_t find_slot(uint32_t name) const;
+    void     grow();
 
 public:
+    // starts with the global scope open
     SymbolTable();
     ~SymbolTable();
 
-    void pop();
     void push();
+    // closes the innermost scope; the global scope is never closed
+    void pop();
+
+    // false if the name is already declared in the innermost scope, or empty
+    bool insert(const Entry& entry);
+
+    // innermost binding of the name or nullptr; valid until the next insert or pop
+    const Entry* search(uint32_t name) const;
+    // the same, but only if it was declared in the innermost scope
+    const Entry* search_local(uint32_t name) const;
 
-    bool insert(Entry* entry);
-    const Entry* search(const strptr& name);
+    // open scopes, 1 for just the global scope
+    unsigned int depth() const;
+    // names bound in the open scopes, shadowed ones included
+    unsigned int size() const;
 };
 
-#endif
\ No newline at end of file
+#endif
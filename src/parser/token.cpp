@@ -4,35 +4,119 @@
 
 #include <ascii.hpp>
 
-void print_token(const Token& tk)
+const char* type_name(uint8_t subtype)
 {
-    if(tk.type == TK_TYPE)
+    const char* lookup_table[] = {
+        "invalid", "void",
+        "U8", "U16", "U32", "U64",
+        "I8", "I16", "I32", "I64",
+        "F32", "F64"
+    };
+
+    return lookup_table[(subtype < TK_TYPE_COUNT) ? subtype : 0];
+}
+
+const char* token_name(uint8_t type)
+{
+    const char* lookup_table[] =
     {
-        const char* lookup_table[] = {
-            "invalid", "void",
-            "U8", "U16", "U32", "U64",
-            "I8", "I16", "I32", "I64",
-            "F32", "F64"
-        };
+        "INVALID", // TK_INVALID
+        "CONST", // TK_CONST
+        "EXTERN", // TK_EXTERN
+        "STRUCT", // TK_STRUCT
+        "RETURN", // TK_RETURN
+        "IF", // TK_IF
+        "=", // TK_EQUAL
+        "<", // TK_LEFT_ARROW_HEAD
+        ">", // TK_RIGHT_ARROW_HEAD
+        "+", // TK_PLUS
+        "-", // TK_MINUS
+        ".", // TK_DOT
+        "*", // TK_ASTERISK
+        "/", // TK_FORWARD_SLASH
+        "{", // TK_OPEN_CURLY_BRACKET
+        "}", // TK_CLOSE_CURLY_BRACKET
+        "(", // TK_OPEN_ROUND_BRACKET
+        ")", // TK_CLOSE_ROUND_BRACKET
+        "[", // TK_OPEN_SQUARE_BRACKET
+        "]", // TK_CLOSE_SQUARE_BRACKET
+        ";", // TK_SEMICOLON
+        "LITERAL", // TK_LITERAL
+        "IDENTIFIER", // TK_IDENTIFIER
+        ",", // TK_COMMA
+        "OR", // TK_OR
+        "AND", // TK_AND
+        "^", // TK_CARET
+        "~", // TK_TILDE
+        "!", // TK_EXPLANATION_MARK
+        "&", // TK_AMPERSAND
+        "|", // TK_VERTICAL_BAR
+        "%", // TK_PERCENT
+        "TYPE", // TK_TYPE
+        "FOR", // TK_FOR
+        "WHILE", // TK_WHILE
+        ":", // TK_COLON
+        "TYPEDEF", // TK_TYPEDEF
+        "BREAK", // TK_BREAK
+        "GOTO", // TK_GOTO
+        "ELSE", // TK_ELSE
+        "CONTINUE", // TK_CONTINUE
+        "SWITCH", // TK_SWITCH
+        "UNION", // TK_UNION
+        "CASE", // TK_CASE
+        "DEFAULT", // TK_DEFAULT
+        "ENUM", // TK_ENUM
+        "STATIC_CAST", // TK_STATIC_CAST
+        "REINTERPRET_CAST", // TK_REINTERPRET_CAST
+        "STATIC", // TK_STATIC
+        "NAMESPACE", // TK_NAMESPACE
+        "EOF" // TK_EOF
+    };
 
-        unsigned int subtype = (tk.data.subtype < TK_TYPE_COUNT) ? tk.data.subtype : 0;
-        printf("type: %s\n", lookup_table[subtype]);
+    return lookup_table[(type < TK_COUNT) ? type : 0];
+}
+
+void print_token(const Token& tk, const Interner* symbols)
+{
+    if(tk.type == TK_TYPE)
+    {
+        printf("type: %s\n", type_name(tk.data.subtype));
     }
     else if(tk.type == TK_LITERAL)
     {
         switch(tk.data.literal.type)
         {
-            case LITERAL_INTEGER: { printf("literal: integer (%llu)\n", tk.data.literal.data.integer_value); break; }
-            case LITERAL_FLOAT:   { printf("literal: decimal (%f)\n", tk.data.literal.data.float_value); break; }
+            case LITERAL_INTEGER:
+            case LITERAL_FLOAT:
+            {
+                if(tk.data.literal.type == LITERAL_INTEGER)
+                {
+                    printf("literal: integer (%llu", (unsigned long long) tk.data.literal.data.integer_value);
+                }
+                else
+                {
+                    printf("literal: decimal (%f", tk.data.literal.data.float_value);
+                }
+                if(tk.data.literal.suffix != TK_TYPE_INVALID)
+                {
+                    printf(", %s", type_name(tk.data.literal.suffix));
+                }
+                printf(")\n");
+                break;
+            }
             case LITERAL_CHAR:    { printf("literal: character (%c)\n", tk.data.literal.data.character); break; }
             case LITERAL_STRING:
             {
                 printf("literal: string (%u, ", tk.data.literal.data.string.len);
-                for(unsigned int i = 0; i < tk.data.literal.data.string.len; i++) {
+                for(unsigned int i = 0; i < tk.data.literal.data.string.len; i++)
+                {
                     char c = tk.data.literal.data.string.ptr[i];
-                    if(IS_ALPHA_NUM(c) || (c == ' ')) {
+                    if(IS_ALPHA_NUM(c) || (c == ' '))
+                    {
                         printf("%c", c);
-                    } else {
+                    }
+                    else
+                    {
                         printf("\\x%hhX", c);
                     }
                 }
@@ -44,7 +128,15 @@ void print_token(const Token& tk)
     }
     else if(tk.type == TK_IDENTIFIER)
     {
-        printf("identifier: %s\n", tk.data.identifier.ptr);
+        if(symbols != nullptr)
+        {
+            const strptr& name = symbols->get(tk.data.identifier);
+            printf("identifier: %.*s\n", name.len, name.ptr);
+        }
+        else
+        {
+            printf("identifier: #%u\n", tk.data.identifier);
+        }
     }
     else
     {
@@ -94,6 +186,8 @@ void print_token(const Token& tk)
             case TK_ENUM: { str = "enum"; break; }
             case TK_STATIC_CAST: { str = "cast"; break; }
             case TK_REINTERPRET_CAST: { str = "r_cast"; break; }
+            case TK_STATIC: { str = "static"; break; }
+            case TK_NAMESPACE: { str = "namespace"; break; }
             case TK_EOF: { str = "eof"; break; }
         }
         printf("%s\n", str);
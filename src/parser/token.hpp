@@ -3,8 +3,8 @@
 
 #include <stdint.h>
 
-#include <strptr.hpp>
 #include <literal.hpp>
+#include <interner.hpp>
 
 enum TOKEN
 {
@@ -56,6 +56,8 @@ enum TOKEN
     TK_ENUM,
 	TK_STATIC_CAST,
 	TK_REINTERPRET_CAST,
+    TK_STATIC,
+    TK_NAMESPACE,
     TK_EOF,
     TK_COUNT
 };
@@ -85,10 +87,16 @@ struct Token
     {
         uint8_t subtype;
         Literal literal;
-        strptr  identifier;
+        uint32_t identifier; // symbol id
     } data;
 };
 
-void print_token(const Token& tk);
+void print_token(const Token& tk, const Interner* symbols);
+
+// spelling of a TK_* value as used in diagnostics
+const char* token_name(uint8_t type);
+
+// spelling of a TK_TYPE_* value
+const char* type_name(uint8_t subtype);
 
 #endif // TOKEN_HPP
@@ -1,62 +1,440 @@
 #include <token_stack.hpp>
 
+#include <assert.h>
+
+#include <algorithm>
+
+#include <trace.hpp>
+#include <tokenizer.hpp>
+
 TokenStack::TokenStack()
 {
+    m_source = nullptr;
+    m_lexer = nullptr;
+
     m_position = 0;
+    m_last_offset = 0;
+    m_first = 0;
+    m_count = 0;
+    m_mask = 0xFFFFFFFF;
+    m_streaming = false;
+    m_failed = false;
+    m_peak = 0;
+    m_literal_count = 0;
 }
 
-#include <debug.hpp>
-Token TokenStack::pop()
+TokenStack::~TokenStack()
+{
+    delete m_lexer;
+    delete m_source;
+}
+
+void TokenStack::attach_source(SourceBuffer* source)
+{
+    delete m_source;
+    m_source = source;
+}
+
+const SourceBuffer* TokenStack::get_source() const
+{
+    return m_source;
+}
+
+void TokenStack::attach_lexer(Tokenizer* lexer)
+{
+    delete m_lexer;
+    m_lexer = lexer;
+
+    m_streaming = true;
+    m_mask = RING_SIZE - 1;
+
+    m_kinds.resize(RING_SIZE);
+    m_offsets.resize(RING_SIZE);
+    m_payloads.resize(RING_SIZE);
+    m_literals.resize(RING_SIZE);
+}
+
+void TokenStack::reserve(size_t source_size)
+{
+    // a rough guess of one token per five bytes of source saves most regrowth
+    size_t guess = source_size / 5;
+    m_kinds.reserve(guess);
+    m_offsets.reserve(guess);
+    m_payloads.reserve(guess);
+}
+
+void TokenStack::fill(uint32_t index)
+{
+    while((m_count <= index) && (m_lexer != nullptr))
+    {
+        bool status = m_lexer->next();
+        if(!status)
+        {
+            // the tokenizer has reported the error, so the source ends there
+            const Token eof = { TK_EOF, {} };
+            push(eof, m_lexer->offset());
+            m_failed = true;
+        }
+
+        if(!status || m_lexer->finished())
+        {
+            delete m_lexer;
+            m_lexer = nullptr;
+        }
+    }
+}
+
+uint32_t TokenStack::oldest() const
 {
-    Token tk = m_tokens[m_position];
-    if (m_position < m_tokens.size() - 1)
+    uint32_t floor = m_position;
+    for(unsigned int i = 0; i < m_pins.size(); i++)
+    {
+        if(m_pins[i] < floor)
+        {
+            floor = m_pins[i];
+        }
+    }
+    return floor;
+}
+
+void TokenStack::make_room()
+{
+    uint32_t floor = oldest();
+
+    // recycle the slots of tokens nobody can return to
+    if(floor > m_count)
+    {
+        floor = m_count;
+    }
+    if(floor > m_first)
+    {
+        m_first = floor;
+    }
+
+    uint32_t capacity = m_mask + 1;
+    if(m_count - m_first == capacity)
+    {
+        // the pinned window fills the ring, so grow it
+        uint32_t mask = (capacity << 1) - 1;
+
+        std::vector<uint8_t>  kinds(mask + 1);
+        std::vector<uint32_t> offsets(mask + 1);
+        std::vector<uint32_t> payloads(mask + 1);
+        std::vector<Literal>  literals(mask + 1);
+
+        for(uint32_t i = m_first; i != m_count; i++)
+        {
+            uint32_t from = i & m_mask;
+            uint32_t to = i & mask;
+
+            kinds[to] = m_kinds[from];
+            offsets[to] = m_offsets[from];
+            payloads[to] = m_payloads[from];
+
+            if(kinds[to] == TK_LITERAL)
+            {
+                literals[to] = m_literals[from];
+                payloads[to] = to;
+            }
+        }
+
+        m_kinds.swap(kinds);
+        m_offsets.swap(offsets);
+        m_payloads.swap(payloads);
+        m_literals.swap(literals);
+        m_mask = mask;
+    }
+}
+
+uint8_t TokenStack::peek_subtype(unsigned int n)
+{
+    return (uint8_t) m_payloads[index_of(n) & m_mask];
+}
+
+uint32_t TokenStack::peek_identifier(unsigned int n)
+{
+    return m_payloads[index_of(n) & m_mask];
+}
+
+Literal TokenStack::peek_literal(unsigned int n)
+{
+    return m_literals[m_payloads[index_of(n) & m_mask]];
+}
+
+uint32_t TokenStack::peek_offset(unsigned int n)
+{
+    return m_offsets[index_of(n) & m_mask];
+}
+
+void TokenStack::advance()
+{
+    uint32_t slot = index_of(0) & m_mask;
+    m_last_offset = m_offsets[slot];
+    TRACE(TRACE_TOKENS, token_name(m_kinds[slot]), m_position, m_last_offset);
+
+    // the position never moves past the EOF token
+    if ((m_lexer != nullptr) || (m_position + 1 < m_count))
     {
         m_position++;
     }
-    printf("consume: ");
-    print_token(tk);
+}
+
+Token TokenStack::pop()
+{
+    Token tk = peek();
+    advance();
     return tk;
 }
 
 Token TokenStack::peek()
 {
-    return m_tokens[m_position];
+    return get(index_of(0));
+}
+
+uint32_t TokenStack::mark()
+{
+    m_pins.push_back(m_position);
+    return m_position;
+}
+
+void TokenStack::rewind(uint32_t mark)
+{
+    assert((mark >= m_first) && (mark <= m_count));
+    m_position = mark;
+}
+
+void TokenStack::release()
+{
+    assert(!m_pins.empty());
+    m_pins.pop_back();
+}
+
+uint32_t TokenStack::position() const
+{
+    return m_position;
+}
+
+void TokenStack::push(const Token& tk, uint32_t offset)
+{
+    if(m_streaming && (m_count - m_first > m_mask))
+    {
+        make_room();
+    }
+
+    uint32_t slot = m_count & m_mask;
+
+    uint32_t payload = 0;
+    switch(tk.type)
+    {
+        case TK_TYPE:       { payload = tk.data.subtype; break; }
+        case TK_IDENTIFIER: { payload = tk.data.identifier; break; }
+        case TK_LITERAL:
+        {
+            m_literal_count++;
+            if(m_streaming)
+            {
+                payload = slot;
+                m_literals[slot] = tk.data.literal;
+            }
+            else
+            {
+                payload = (uint32_t) m_literals.size();
+                m_literals.push_back(tk.data.literal);
+            }
+            break;
+        }
+        default: { break; }
+    }
+
+    if(m_streaming)
+    {
+        m_kinds[slot] = tk.type;
+        m_offsets[slot] = offset;
+        m_payloads[slot] = payload;
+    }
+    else
+    {
+        m_kinds.push_back(tk.type);
+        m_offsets.push_back(offset);
+        m_payloads.push_back(payload);
+    }
+
+    m_count++;
+
+    // a streamed token is only needed from the oldest one the parser may
+    // return to; the ring keeps older ones until their slots are reused
+    uint32_t held = m_streaming ? (m_count - std::min(oldest(), m_count)) : (m_count - m_first);
+    if(held > m_peak)
+    {
+        m_peak = held;
+    }
 }
 
-Token TokenStack::look_ahead()
+void TokenStack::splice(const TokenStack& other, uint32_t first, uint32_t last, std::vector<uint32_t>& symbols)
 {
+    assert(!m_streaming && !other.m_streaming);
+
+    if(symbols.size() < other.m_symbols.size())
+    {
+        symbols.resize(other.m_symbols.size(), SYMBOL_NULL);
+    }
+
+    const char* source = (m_source != nullptr) ? m_source->data() : nullptr;
+    const char* source_end = (m_source != nullptr) ? (source + m_source->size()) : nullptr;
+
+    m_kinds.insert(m_kinds.end(), other.m_kinds.begin() + first, other.m_kinds.begin() + last);
+    m_offsets.insert(m_offsets.end(), other.m_offsets.begin() + first, other.m_offsets.begin() + last);
+
+    for(uint32_t i = first; i < last; i++)
+    {
+        uint32_t payload = other.m_payloads[i];
+        switch(other.m_kinds[i])
+        {
+            case TK_IDENTIFIER:
+            {
+                uint32_t& id = symbols[payload];
+                if(id == SYMBOL_NULL)
+                {
+                    const strptr& name = other.m_symbols.get(payload);
+                    id = m_symbols.intern(name.ptr, name.len);
+                }
+                payload = id;
+                break;
+            }
+            case TK_LITERAL:
+            {
+                Literal literal = other.m_literals[payload];
+                if(literal.type == LITERAL_STRING)
+                {
+                    // strings that point into the source can stay there, the
+                    // others live in the other stack's pool and are copied
+                    const char* ptr = literal.data.string.ptr;
+                    bool in_source = (ptr >= source) && (ptr < source_end);
+
+                    uint32_t id = add_string(ptr, literal.data.string.len, !in_source);
+                    literal.data.string.ptr = m_strings.get(id).ptr;
+                    literal.data.string.id = id;
+                }
+
+                payload = (uint32_t) m_literals.size();
+                m_literals.push_back(literal);
+                m_literal_count++;
+                break;
+            }
+            default: { break; }
+        }
+
+        m_payloads.push_back(payload);
+    }
+
+    m_count += last - first;
+    m_peak = m_count;
+}
+
+uint32_t TokenStack::find_offset(uint32_t offset) const
+{
+    std::vector<uint32_t>::const_iterator it = std::lower_bound(m_offsets.begin(), m_offsets.end(), offset);
+    return ((it != m_offsets.end()) && (*it == offset)) ? (uint32_t) (it - m_offsets.begin()) : NOT_FOUND;
+}
+
+bool TokenStack::failed() const
+{
+    return m_failed;
+}
+
+unsigned int TokenStack::size() const
+{
+    return m_count;
+}
+
+Token TokenStack::get(unsigned int index) const
+{
+    uint32_t slot = index & m_mask;
+
     Token tk = {};
-    if(m_position + 1 < m_tokens.size() - 1)
+    tk.type = m_kinds[slot];
+
+    uint32_t payload = m_payloads[slot];
+    switch(tk.type)
     {
-        tk = m_tokens[m_position];
+        case TK_TYPE:       { tk.data.subtype = (uint8_t) payload; break; }
+        case TK_IDENTIFIER: { tk.data.identifier = payload; break; }
+        case TK_LITERAL:    { tk.data.literal = m_literals[payload]; break; }
+        default: { break; }
     }
+
     return tk;
 }
 
-void TokenStack::push(const Token& tk)
+uint32_t TokenStack::get_offset(unsigned int index) const
 {
-    m_tokens.push_back(tk);
+    return m_offsets[index & m_mask];
 }
 
-void TokenStack::insert_identifier(const strptr& ptr)
+uint32_t TokenStack::last_offset() const
 {
-    m_identifier_set[ptr] = ptr;
+    return m_last_offset;
 }
 
-const char* TokenStack::find_identifier(const strptr& ptr)
+SourceLocation TokenStack::locate(uint32_t offset)
 {
-    const char* str = nullptr;
+    SourceLocation location = {};
 
-    std::map<strptr, strptr>::const_iterator it = m_identifier_set.find(ptr);
-    if(it != m_identifier_set.end())
+    if(m_source != nullptr)
     {
-        str = it->second.ptr;
+        if(!m_lines.is_built())
+        {
+            m_lines.build(m_source->data(), m_source->size());
+        }
+        location = m_lines.locate(offset);
     }
 
-    return str;
+    return location;
+}
+
+TokenStack::Stats TokenStack::get_stats() const
+{
+    // the whole ring is in use when streaming
+    size_t held = m_streaming ? (m_mask + 1) : (m_count - m_first);
+
+    Stats stats = {};
+    stats.tokens = m_count;
+    stats.literals = m_literal_count;
+    stats.peak = m_peak;
+    stats.ring = m_streaming ? (m_mask + 1) : 0;
+
+    stats.bytes = held * (sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t)) +
+                  m_literals.size() * sizeof(Literal);
+
+    stats.reserved = m_kinds.capacity() * sizeof(uint8_t) +
+                     m_offsets.capacity() * sizeof(uint32_t) +
+                     m_payloads.capacity() * sizeof(uint32_t) +
+                     m_literals.capacity() * sizeof(Literal);
+
+    return stats;
+}
+
+uint32_t TokenStack::intern(const char* ptr, unsigned int len)
+{
+    return m_symbols.intern(ptr, len);
+}
+
+const Interner& TokenStack::symbols() const
+{
+    return m_symbols;
+}
+
+void TokenStack::share_symbols(SharedInterner* shared)
+{
+    m_symbols.share(shared);
+}
+
+uint32_t TokenStack::add_string(const char* ptr, unsigned int len, bool copy)
+{
+    return copy ? m_strings.add_copy(ptr, len) : m_strings.add(ptr, len);
 }
 
-const std::vector<Token>& TokenStack::get_tokens()
+const StringPool& TokenStack::strings() const
 {
-    return m_tokens;
+    return m_strings;
 }
@@ -1,32 +1,176 @@
 #ifndef TOKEN_STACK_HPP
 #define TOKEN_STACK_HPP
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <vector>
 
 #include <token.hpp>
+#include <interner.hpp>
+#include <line_table.hpp>
+#include <string_pool.hpp>
+#include <source_buffer.hpp>
+
+class Tokenizer;
 
+// Tokens are stored as parallel arrays rather than as an array of Token: a
+// byte per kind, the token's offset into the source, and a 32-bit payload.
+// The payload holds the subtype of a TK_TYPE, the symbol id of a
+// TK_IDENTIFIER, or the index of a TK_LITERAL into the literal table, which
+// is the only place a full Literal is kept. Kind checks only touch m_kinds.
+//
+// Tokens are addressed by their absolute index in the file. When a tokenizer
+// is attached the arrays form a ring: tokens are lexed as they are peeked, and
+// tokens behind both the current position and the oldest pin are recycled.
 class TokenStack
 {
 private:
-    unsigned int m_position;
-    std::vector<Token> m_tokens;
+    enum
+    {
+        RING_SIZE = 4096 // initial ring capacity, must be a power of two
+    };
+
+    SourceBuffer* m_source;
+    Tokenizer*    m_lexer; // null once every token has been pushed
+
+    uint32_t m_position;
+    uint32_t m_last_offset; // of the last popped token, which may be recycled
+    uint32_t m_first;    // oldest token still held
+    uint32_t m_count;    // tokens pushed so far
+    uint32_t m_mask;     // index -> slot, all ones when not streaming
+    bool     m_streaming;
+    bool     m_failed; // the lexer stopped on an error, which it has reported
 
-    std::map<strptr, strptr> m_identifier_set;
+    std::vector<uint8_t>  m_kinds;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_payloads;
+    std::vector<Literal>  m_literals; // indexed by slot when streaming
+    uint32_t m_literal_count;
+
+    // positions the parser may still return to
+    std::vector<uint32_t> m_pins;
+    uint32_t m_peak; // most tokens held at once, only the pinned window when streaming
+
+    Interner m_symbols;
+    StringPool m_strings;
+    LineTable m_lines;
+
+private:
+    void fill(uint32_t index);
+
+    // absolute index of the token n past the position, lexed first when
+    // streaming; anything past the end is the last token, normally EOF
+    uint32_t index_of(unsigned int n)
+    {
+        uint32_t index = m_position + n;
+        if(index >= m_count)
+        {
+            fill(index);
+            index = (index < m_count) ? index : (m_count - 1);
+        }
+        return index;
+    }
+    // the oldest token the parser may still return to, the position or a pin
+    uint32_t oldest() const;
+    void make_room();
+
+public:
+    struct Stats
+    {
+        size_t tokens;   // tokens pushed so far
+        size_t literals;
+        size_t bytes;    // bytes in use by the token arrays, the whole ring when streaming
+        size_t reserved; // bytes allocated for them
+        size_t peak;     // most tokens held at once; when streaming, from the oldest pin or the position
+        size_t ring;     // slots in the ring when streaming, else 0
+    };
 
 public:
     TokenStack();
+    ~TokenStack();
+
+    TokenStack(const TokenStack&) = delete;
+    TokenStack& operator=(const TokenStack&) = delete;
+
+    // identifiers and string literals may point into the source buffer, so
+    // the stack takes ownership of it and keeps it alive until destruction
+    void attach_source(SourceBuffer* source);
+    const SourceBuffer* get_source() const;
 
-    void insert_identifier(const strptr& ptr);
-    const char* find_identifier(const strptr& ptr);
+    // takes ownership of the tokenizer and switches to streaming
+    void attach_lexer(Tokenizer* lexer);
+    // sizes the arrays for a source of the given length
+    void reserve(size_t source_size);
+
+    uint32_t intern(const char* ptr, unsigned int len);
+    const Interner& symbols() const;
+    // interns into shared from now on, so ids match those of every other
+    // stack sharing it; call before lexing
+    void share_symbols(SharedInterner* shared);
+
+    // pools a string literal; copy is needed when ptr does not point into
+    // the attached source
+    uint32_t add_string(const char* ptr, unsigned int len, bool copy);
+    const StringPool& strings() const;
+
+    // The cursor. peek_*(n) look n tokens past the current position without
+    // consuming anything, lexing them first when streaming. Literals are
+    // returned by value since lexing further may move or recycle their slot.
+    uint8_t peek_type(unsigned int n = 0)
+    {
+        return m_kinds[index_of(n) & m_mask];
+    }
+
+    uint8_t peek_subtype(unsigned int n = 0);
+    uint32_t peek_identifier(unsigned int n = 0);
+    Literal peek_literal(unsigned int n = 0);
+    // source offset of the token n ahead
+    uint32_t peek_offset(unsigned int n = 0);
+
+    // consumes the current token
+    void advance();
 
     Token pop();
     Token peek();
-    Token look_ahead();
-    
-    void push(const Token& tk);
 
-    const std::vector<Token>& get_tokens();
+    // A mark keeps every token from the current position onwards until it is
+    // released, and rewind() returns to it; both are O(1). Marks nest, the
+    // innermost is released first. While a mark is held, rewind() may also
+    // return to any position() taken after it.
+    uint32_t mark();
+    void rewind(uint32_t mark);
+    void release();
+    uint32_t position() const;
+
+    void push(const Token& tk, uint32_t offset);
+
+    // appends tokens [first, last) of a stack lexed on its own, moving its
+    // identifiers and string literals into this stack's tables. symbols maps
+    // the other stack's symbol ids to ours and is filled in as names are met,
+    // so calling this in token order assigns the same ids as lexing here would.
+    void splice(const TokenStack& other, uint32_t first, uint32_t last, std::vector<uint32_t>& symbols);
+
+    // index of the token starting at the given offset, or NOT_FOUND; only
+    // valid when not streaming
+    static const uint32_t NOT_FOUND = 0xFFFFFFFF;
+    uint32_t find_offset(uint32_t offset) const;
+
+    // whether a streamed source ended early on a lexing error; the EOF token
+    // is then pushed at the error and needs no diagnostic of its own
+    bool failed() const;
+
+    // tokens pushed so far, everything after Tokenizer::Tokenize
+    unsigned int size() const;
+    Token get(unsigned int index) const;
+    uint32_t get_offset(unsigned int index) const;
+
+    // source offset of the token returned by the last pop()
+    uint32_t last_offset() const;
+    // line and column of a source offset, the line table is built on first use
+    SourceLocation locate(uint32_t offset);
+
+    Stats get_stats() const;
 };
 
 #endif // TOKEN_STACK_HPP
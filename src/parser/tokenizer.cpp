@@ -1,18 +1,53 @@
 #include <tokenizer.hpp>
 
 #include <assert.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <ascii.hpp>
-
-#define _strncmp(s0, s1, len) (strncmp((s0), (s1), (len)) == 0)
+#include <diagnostics.hpp>
+#include <scan.hpp>
+#include <trace.hpp>
+#include <number.hpp>
+#include <keywords.hpp>
 
 Tokenizer::Tokenizer()
 {
-	m_file = nullptr;
+	m_begin = nullptr;
+	m_ptr = nullptr;
+	m_end = nullptr;
+	m_token = nullptr;
 	m_stack = nullptr;
+	m_emitted = false;
+	m_finished = false;
+	m_quiet = false;
+}
+
+void Tokenizer::report(const char* format, ...)
+{
+	if(!m_quiet)
+	{
+		// at the start of the token, as the parser reports its errors
+		SourceLocation location = m_stack->locate(offset());
+		Diagnostics::Print("error: %u:%u: ", location.line, location.column);
+
+		va_list args;
+		va_start(args, format);
+		Diagnostics::VPrint(format, args);
+		va_end(args);
+	}
+}
+
+void Tokenizer::emit(const Token& tk)
+{
+	// sources are capped at 4GB, so the offset always fits
+	uint32_t offset = (uint32_t) (m_token - m_begin);
+	TRACE(TRACE_LEXER, token_name(tk.type), offset, m_stack->size());
+
+	m_stack->push(tk, offset);
+	m_emitted = true;
 }
 
 int Tokenizer::read_escape_character()
@@ -45,14 +80,14 @@ int Tokenizer::read_escape_character()
 				else
 				{
 					status = false;
-					printf("error: expected hexadecimal character\n");
+					report("expected hexadecimal character\n");
 				}
 				break;
 			}
 			default:
 			{
 				status = false;
-				printf("error: unknown escape sequence");
+				report("unknown escape sequence\n");
 				break;
 			}
 		}
@@ -68,7 +103,7 @@ bool Tokenizer::expect(char c)
 	if(pop() != c)
 	{
 		status = false;
-		printf("error: expected \"%c\"\n", c);
+		report("expected \"%c\"\n", c);
 	}
 
 	return status;
@@ -81,7 +116,7 @@ bool Tokenizer::read_character_literal()
 	char c = 0;
 	if(status)
 	{
-		if(m_input[0] != '\\')
+		if(peek(0) != '\\')
 		{
 			c = pop();
 		}
@@ -106,7 +141,7 @@ bool Tokenizer::read_character_literal()
 		tk.data.literal.type = LITERAL_CHAR;
 		tk.data.literal.data.character = c;
 
-		m_stack->push(tk);
+		emit(tk);
 		status = expect('\'');
 	}
 
@@ -117,142 +152,106 @@ bool Tokenizer::read_string()
 {
 	bool status = expect('"');
 
-	char c = 0;
-	while(status)
-	{
-        if(m_input[0] == '"')
-        {
-			pop();
-            break;
-        }
-        else if(m_input[0] != '\\')
-		{
-			c = pop();
-		}
-		else
-		{
-			int value = read_escape_character();
-			if(value != -1)
-			{
-				c = (char) value;
-			}
-			else
-			{
-				status = false;
-			}
-		}
-
-		if(status)
-		{
-		    m_buffer.push_back(c);
-		}
+	// strings without escape sequences are referenced in place
+	const char* end = m_ptr;
+	while((end < m_end) && (*end != '"') && (*end != '\\'))
+	{
+		end++;
 	}
 
-	if(status)
+	if(status && (end < m_end) && (*end == '"'))
 	{
-		unsigned int len = m_buffer.size();
-		
-		char* str = new char[len + 1];
-		memcpy(str, m_buffer.data(), len);
-		str[len] = 0; // null terminate
+		uint32_t id = m_stack->add_string(m_ptr, (unsigned int) (end - m_ptr), false);
+		const strptr& str = m_stack->strings().get(id);
 
 		Token tk = { 0, { 0 }};
 		tk.type = TK_LITERAL;
 		tk.data.literal.type = LITERAL_STRING;
-		tk.data.literal.data.string.ptr = str;
-		tk.data.literal.data.string.len = len;
+		tk.data.literal.data.string.ptr = str.ptr;
+		tk.data.literal.data.string.len = str.len;
+		tk.data.literal.data.string.id = id;
 
-		m_stack->push(tk);
-		m_buffer.clear();
+		emit(tk);
+		m_ptr = end + 1;
 	}
-
-	return status;
-}
-
-bool Tokenizer::read_decimal()
-{
-	bool status = true;
-	bool is_float = false;
-
-	char c = 0;
-	while(status)
+	else if(status)
 	{
-		c = m_input[0];
-		if(IS_NUM(c) || (c == '.'))
+		char c = 0;
+		while(status)
 		{
-			pop();
-			if(c == '.')
+			if(peek(0) == '"')
+			{
+				pop();
+				break;
+			}
+			else if(m_ptr >= m_end)
+			{
+				status = false;
+				report("could not find end of string\n");
+			}
+			else if(peek(0) != '\\')
 			{
-				if(!is_float)
+				c = pop();
+			}
+			else
+			{
+				int value = read_escape_character();
+				if(value != -1)
 				{
-					is_float = true;
+					c = (char) value;
 				}
 				else
 				{
 					status = false;
-					printf("error: repeated decimal symbol\n");
 				}
 			}
-			m_buffer.push_back(c);
-		}
-		else
-		{
-			break;
-		}
-	}
 
-	if(status)
-	{
-		m_buffer.push_back(0);
-
-		Token tk = { TK_LITERAL, { 0 }};
-		if(!is_float)
-		{
-			tk.data.literal.type = LITERAL_INTEGER;
-			tk.data.literal.data.integer_value = strtoul(m_buffer.data(), nullptr, 10);
+			if(status)
+			{
+				m_buffer.push_back(c);
+			}
 		}
-		else
+
+		if(status)
 		{
-			tk.data.literal.type = LITERAL_FLOAT;
-			tk.data.literal.data.float_value = strtof(m_buffer.data(), nullptr);
+			// the unescaped contents only exist in m_buffer, so the pool copies them
+			uint32_t id = m_stack->add_string(m_buffer.data(), (unsigned int) m_buffer.size(), true);
+			const strptr& str = m_stack->strings().get(id);
+
+			Token tk = { 0, { 0 }};
+			tk.type = TK_LITERAL;
+			tk.data.literal.type = LITERAL_STRING;
+			tk.data.literal.data.string.ptr = str.ptr;
+			tk.data.literal.data.string.len = str.len;
+			tk.data.literal.data.string.id = id;
+
+			emit(tk);
 		}
 
-		m_stack->push(tk);
 		m_buffer.clear();
 	}
 
 	return status;
 }
 
-bool Tokenizer::read_hexadecimal()
+bool Tokenizer::read_number()
 {
-	bool status = expect('0') ? expect('x') : false;
+	bool status = true;
 
-	char c = 0;
-	while(status)
+	Token tk = { 0, { 0 }};
+	tk.type = TK_LITERAL;
+
+	const char* error = nullptr;
+	const char* next = Number::Read(m_ptr, m_end, &tk.data.literal, &error);
+	if(next == nullptr)
 	{
-		c = m_input[0];
-		if(IS_HEXADECIMAL(c))
-		{
-			m_buffer.push_back(c);
-		}
-		else
-		{
-			break;
-		}
+		status = false;
+		report("%s\n", error);
 	}
-
-	if(status)
+	else
 	{
-		m_buffer.push_back(0);
-		
-		Token tk = { 0, { 0 } };
-		tk.type = TK_LITERAL;
-		tk.data.literal.type = LITERAL_INTEGER;
-		tk.data.literal.data.integer_value = strtoul(m_buffer.data(), nullptr, 16);
-
-		m_stack->push(tk);
-		m_buffer.clear();
+		m_ptr = next;
+		emit(tk);
 	}
 
 	return status;
@@ -262,7 +261,7 @@ bool Tokenizer::read_literal()
 {
 	bool status = true;
 
-	char c = m_input[0];
+	char c = peek(0);
 	if(c == '\'')
 	{
 		status = read_character_literal();
@@ -271,15 +270,10 @@ bool Tokenizer::read_literal()
 	{
 		status = read_string();
 	}
-	else if((c == '0') && (m_input[1]== 'x'))
-	{
-		status = read_hexadecimal();
-	}
 	else
 	{
-		status = read_decimal();
+		status = read_number();
 	}
-	
 
 	return status;
 }
@@ -288,14 +282,10 @@ bool Tokenizer::read_single_line_comment()
 {
 	bool status = expect('/') ? expect('/') : false;
 
-	char c = 0;
-	while(status)
+	if(status)
 	{
-		c = pop();
-		if((c == '\n') || (c == EOF))
-		{
-			break;
-		}
+		const char* newline = Scan::FindNewline(m_ptr, m_end);
+		m_ptr = (newline < m_end) ? (newline + 1) : m_end;
 	}
 
 	return status;
@@ -305,21 +295,17 @@ bool Tokenizer::read_multi_line_comment()
 {
 	bool status = expect('/') ? expect('*') : false;
 
-	char c = 0;
-	while(status)
+	if(status)
 	{
-		c = pop();
-		if(c == '*')
+		const char* close = Scan::FindCommentEnd(m_ptr, m_end);
+		if(close < m_end)
 		{
-			if(pop() == '/')
-			{
-				break;
-			}
+			m_ptr = close + 2;
 		}
-		else if(c == EOF)
+		else
 		{
 			status = false;
-			printf("error: could not find end of multi line comment\n");
+			report("could not find end of multi line comment\n");
 		}
 	}
 
@@ -330,208 +316,36 @@ bool Tokenizer::read_identifier()
 {
 	bool status = true;
 
-	char c = 0;
-	while(status)
-	{
-		c = m_input[0];
-		if(IS_ALPHA_NUM(c) || (c == '_'))
-		{
-			pop();
-			m_buffer.push_back(c);
-		}
-		else
-		{
-			break;
-		}
-	}
+	const char* str = m_ptr;
+	m_ptr = Scan::SkipIdentifier(m_ptr, m_end);
 
-	if(status && (m_buffer.size() == 0))
+	unsigned int len = (unsigned int) (m_ptr - str);
+	if(len == 0)
 	{
 		status = false;
-		printf("error: expected identifier\n");
+		report("expected identifier\n");
 	}
 
 	if(status)
 	{
 		Token tk = { 0, { 0 }};
 
-		m_buffer.push_back(0); // null-terminate
-		const char* str = m_buffer.data();
-		unsigned int len = m_buffer.size();
-
-		switch(len)
+		const Keyword* kw = Keywords::Find(str, len);
+		if(kw != nullptr)
 		{
-			case 3:
-			{
-				switch(str[0])
-				{
-					case 'i': { if(_strncmp(str, "if", 2)) { tk.type = TK_IF; } break; }
-					case 'o': { if(_strncmp(str, "or", 2)) { tk.type = TK_OR; } break; }
-					case 'I':
-					{
-						switch(str[1])
-						{
-							case '8': { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_I8; break; }
-						}
-						break;
-					}
-					case 'U':
-					{
-						switch(str[1])
-						{
-							case '8': { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_U8; break; }
-						}
-						break;
-					}
-				}
-				break;
-			}
-			case 4:
-			{
-				switch(str[0])
-				{
-					case 'a': { if(_strncmp(str, "and", 3)) { tk.type = TK_AND; } break; }
-					case 'f': { if(_strncmp(str, "for", 3)) { tk.type = TK_FOR; } break; }
-					case 'F':
-					{
-						switch(str[1])
-						{
-							case '3': { if(_strncmp(str, "F32", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_F32; } break; }
-							case '6': { if(_strncmp(str, "F64", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_F64; } break; }
-						}
-						break;
-					}
-					case 'I':
-					{
-						switch(str[1])
-						{
-							case '1': { if(_strncmp(str, "I16", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_I16; } break; }
-							case '3': { if(_strncmp(str, "I32", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_I32; } break; }
-							case '6': { if(_strncmp(str, "I64", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_I64; } break; }
-						}
-						break;
-					}
-					case 'U':
-					{
-						switch(str[1])
-						{
-							case '1': { if(_strncmp(str, "U16", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_U16; } break; }
-							case '3': { if(_strncmp(str, "U32", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_U32; } break; }
-							case '6': { if(_strncmp(str, "U64", 3)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_U64; } break; }
-						}
-						break;
-					}
-				}
-				break;
-			}
-			case 5:
-			{
-				switch(str[0])
-				{
-					case 'c':
-					{
-						switch(str[3])
-						{
-							case 'e': { if(_strncmp(str, "case", 4)) { tk.type = TK_CASE; } break; }
-							case 't': { if(_strncmp(str, "cast", 4)) { tk.type = TK_STATIC_CAST; } break; }
-						}
-						break;
-					}
-					case 'e':
-					{
-						switch(str[1])
-						{
-							case 'l': { if(_strncmp(str, "else", 4)) { tk.type = TK_ELSE; } break; }
-							case 'n': { if(_strncmp(str, "enum", 4)) { tk.type = TK_ENUM; } break; }
-						}
-						break;
-					}
-					case 'v': { if(_strncmp(str, "void", 4)) { tk.type = TK_TYPE; tk.data.subtype = TK_TYPE_VOID; } break; }
-				}
-				break;
-			}
-			case 6:
-			{
-				switch(str[0])
-				{
-					case 'c': { if(_strncmp(str, "const", 5)) { tk.type = TK_CONST; } break; }
-					case 'w': { if(_strncmp(str, "while", 5)) { tk.type = TK_WHILE; } break; }
-					case 'u': { if(_strncmp(str, "union", 5)) { tk.type = TK_UNION; } break; }
-				}
-				break;
-			}
-			case 7:
-			{
-				switch(str[0])
-				{
-					case 'e': { if(_strncmp(str, "extern", 6)) { tk.type = TK_EXTERN; } break; }
-					case 'r':
-					{
-						switch(str[1])
-						{
-							case 'e': { if(_strncmp(str, "return", 6)) { tk.type = TK_RETURN; } break; }
-							case '_': { if(_strncmp(str, "r_cast", 6)) { tk.type = TK_REINTERPRET_CAST; } break; }
-						}
-						break;
-					}
-					case 's':
-					{
-						switch(str[1])
-						{
-							case 't': { if(_strncmp(str, "struct", 6)) { tk.type = TK_STRUCT; } break; }
-							case 'w': { if(_strncmp(str, "switch", 6)) { tk.type = TK_SWITCH; } break; }
-						}
-						break;
-					}
-				}
-				break;
-			}
-			case 8:
-			{
-				switch(str[0])
-				{
-					case 'd': { if(_strncmp(str, "default", 7)) { tk.type = TK_DEFAULT; } break; }
-				}
-				break;
-			}
-			case 9:
-			{
-				switch(str[0])
-				{
-					case 'c': { if(_strncmp(str, "continue", 8)) { tk.type = TK_CONTINUE; } break; }
-				}
-				break;
-			}
+			tk.type = kw->token;
+			tk.data.subtype = kw->subtype;
 		}
-	
-		if(tk.type == TK_INVALID) // this is an identifier
+		else // this is an identifier
 		{
-            strptr key = { str, len };
-
-			key.ptr = m_stack->find_identifier(key);
-			if(key.ptr == nullptr)
-			{
-				char* ptr = new char[len];
-				memcpy(ptr, str, len); // 'str' is already null terminated
-
-				key.ptr = ptr;
-				m_stack->insert_identifier(key);
-			}
-			
-
 			tk.type = TK_IDENTIFIER;
-			tk.data.identifier.len = len;
-			tk.data.identifier.ptr = key.ptr;
+			tk.data.identifier = m_stack->intern(str, len);
 		}
 
-		if(status)
-		{
-			m_stack->push(tk);
-			m_buffer.clear();
-		}
+		emit(tk);
 	}
 
-	return true;
+	return status;
 }
 
 bool Tokenizer::read_punctuator()
@@ -569,110 +383,333 @@ bool Tokenizer::read_punctuator()
 		default:
 		{
 			status = false;
-			printf("unknown token '%c'\n", c);
+			report("unknown token '%c'\n", c);
 			break;
 		}
 	}
 
 	if(status)
 	{
-		m_stack->push(tk);
+		emit(tk);
 	}
 
 	return status;
 }
 
-bool Tokenizer::tokenize(FILE* file, TokenStack* stack)
+void Tokenizer::start(const char* data, unsigned int size, TokenStack* stack)
 {
-	bool status = true;
-	
-	m_file = file;
+	m_begin = data;
+	m_ptr = data;
+	m_end = data + size;
 	m_stack = stack;
+	m_finished = false;
 	m_buffer.reserve(256);
-	m_input[0] = fgetc(m_file);
-	m_input[1] = fgetc(m_file);
+}
 
-	char c = 0;
+bool Tokenizer::step()
+{
+	bool status = true;
 
-	while(status)
+	m_token = m_ptr;
+
+	char c = peek(0);
+	if(IS_SPACE(c))
 	{
-		c = m_input[0];
-		if(IS_SPACE(c))
-		{
-			pop();
-		}
-		else if(IS_ALPHA(c))
-		{
-			status = read_identifier();
-		}
-		else if(IS_NUM(c) || (c == '\'') || (c == '"'))
+		m_ptr = Scan::SkipSpace(m_ptr, m_end);
+	}
+	else if(IS_ALPHA(c))
+	{
+		status = read_identifier();
+	}
+	else if(IS_NUM(c) || (c == '\'') || (c == '"'))
+	{
+		status = read_literal();
+	}
+	else
+	{
+		if(m_ptr >= m_end)
 		{
-			status = read_literal();
+			// append EOF token
+			const Token eof = { TK_EOF, {} };
+			emit(eof);
+			m_finished = true;
 		}
 		else
 		{
-			if(c == EOF)
+			if(c == '/')
 			{
-				break;
+				switch(peek(1))
+				{
+					case '/': { status = read_single_line_comment(); break; }
+					case '*': { status = read_multi_line_comment();  break; }
+					default:  { status = read_punctuator(); break; }
+				}
 			}
 			else
 			{
-				if(c == '/')
-				{
-					switch(m_input[1])
-					{
-						case '/': { status = read_single_line_comment(); break; }
-						case '*': { status = read_multi_line_comment();  break; }
-						default:  { status = read_punctuator(); break; }
-					}
-				}
-				else
-				{
-					status = read_punctuator();
-				}
+				status = read_punctuator();
 			}
 		}
 	}
 
-	// append EOF token
-	if (status)
+	return status;
+}
+
+bool Tokenizer::tokenize(const char* data, unsigned int size, TokenStack* stack)
+{
+	bool status = true;
+
+	start(data, size, stack);
+	while(status && !m_finished)
 	{
-		const Token eof = { TK_EOF, {} };
-		stack->push(eof);
+		status = step();
 	}
 
 	return status;
 }
 
+bool Tokenizer::lex_range(const char* ptr, const char* to)
+{
+	bool status = true;
+
+	m_ptr = ptr;
+	while(status && !m_finished && ((m_ptr < to) || (to == m_end)))
+	{
+		status = step();
+	}
+
+	return status;
+}
+
+bool Tokenizer::next()
+{
+	bool status = true;
+
+	m_emitted = false;
+	while(status && !m_emitted)
+	{
+		status = step();
+	}
+
+	return status;
+}
+
+bool Tokenizer::finished() const
+{
+	return m_finished;
+}
+
+uint32_t Tokenizer::offset() const
+{
+	return (uint32_t) (m_token - m_begin);
+}
+
 char Tokenizer::pop()
 {
-	char c = m_input[0];
-	m_input[0] = m_input[1];
-	m_input[1] = fgetc(m_file);
-	return c;
+	return (m_ptr < m_end) ? *m_ptr++ : (char) EOF;
+}
+
+char Tokenizer::peek(unsigned int offset)
+{
+	return (offset < (unsigned int) (m_end - m_ptr)) ? m_ptr[offset] : (char) EOF;
 }
 
 bool Tokenizer::Tokenize(const char* file_path, TokenStack* stack)
 {
 	bool status = true;
 
-	FILE* file = fopen(file_path, "r");
-	if(file == nullptr)
+	SourceBuffer* source = SourceBuffer::Load(file_path);
+	if(source == nullptr)
+	{
+		status = false;
+	}
+
+	if(status)
+	{
+		status = Tokenize(source, stack);
+	}
+
+	return status;
+}
+
+bool Tokenizer::Tokenize(SourceBuffer* source, TokenStack* stack)
+{
+	stack->attach_source(source);
+	stack->reserve(source->size());
+
+	Tokenizer tokenizer;
+	return tokenizer.tokenize(source->data(), source->size(), stack);
+}
+
+namespace
+{
+	// a piece of the source lexed on its own
+	struct Chunk
+	{
+		const char* from;
+		const char* to;
+		const char* stop;    // where its last step ended, or where it failed
+		bool        failed;
+		bool        spliced;
+
+		TokenStack tokens;
+		std::vector<uint32_t> symbols; // chunk symbol id -> global id
+	};
+}
+
+bool Tokenizer::TokenizeParallel(const char* file_path, TokenStack* stack, ThreadPool* pool)
+{
+	bool status = true;
+
+	SourceBuffer* source = SourceBuffer::Load(file_path);
+	if(source == nullptr)
 	{
 		status = false;
-		printf("error: could not open file \"%s\" for reading\n", file_path);
 	}
 
 	if(status)
 	{
+		status = TokenizeParallel(source, stack, pool);
+	}
+
+	return status;
+}
+
+bool Tokenizer::TokenizeParallel(SourceBuffer* source, TokenStack* stack, ThreadPool* pool, unsigned int chunk_size)
+{
+	unsigned int size = source->size();
+	unsigned int count = size / ((chunk_size > 0) ? chunk_size : 1);
+	if(count > pool->size())
+	{
+		count = pool->size();
+	}
+
+	if(count <= 1)
+	{
+		return Tokenize(source, stack);
+	}
+
+	stack->attach_source(source);
+	stack->reserve(size);
+
+	const char* begin = source->data();
+	const char* end = begin + size;
+
+	// cut after the first line break past each even split point; only the
+	// last chunk may reach the end of the source
+	Chunk* chunks = new Chunk[count];
+	const char* from = begin;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		const char* to = end;
+		if(i + 1 < count)
+		{
+			const char* split = begin + (size_t) size * (i + 1) / count;
+			to = Scan::FindNewline((split > from) ? split : from, end);
+			to = (to < end) ? (to + 1) : end;
+		}
+
+		chunks[i].from = from;
+		chunks[i].to = to;
+		from = to;
+
+		if(to == end)
+		{
+			count = i + 1;
+		}
+	}
+
+	pool->run(count, [&](unsigned int i)
+	{
+		Chunk& chunk = chunks[i];
+		chunk.tokens.reserve(chunk.to - chunk.from);
+
+		// offsets are relative to the whole source so they can be matched up
 		Tokenizer tokenizer;
-		status = tokenizer.tokenize(file, stack);
+		tokenizer.m_quiet = true;
+		tokenizer.start(begin, size, &chunk.tokens);
+
+		chunk.failed = !tokenizer.lex_range(chunk.from, chunk.to);
+		chunk.stop = chunk.failed ? tokenizer.m_token : tokenizer.m_ptr;
+		chunk.spliced = false;
+	});
+
+	// walk the source in order. Where a chunk has a token starting exactly
+	// where we are, the chunk was in sync from there on and its tokens are
+	// taken; anywhere else (the start of a chunk that began inside a comment
+	// or string, or the step a chunk failed on) is lexed again here
+	Tokenizer fixer;
+	fixer.start(begin, size, stack);
+
+	bool status = true;
+	bool done = false;
+	const char* ptr = begin;
+	unsigned int k = 0;
+
+	while(status && !done && !fixer.m_finished)
+	{
+		while((k + 1 < count) && (ptr >= chunks[k].to))
+		{
+			k++;
+		}
+
+		Chunk& chunk = chunks[k];
+		uint32_t first = chunk.spliced ? TokenStack::NOT_FOUND : chunk.tokens.find_offset((uint32_t) (ptr - begin));
+		if((first != TokenStack::NOT_FOUND) && (!chunk.failed || (ptr < chunk.stop)))
+		{
+			uint32_t last = chunk.tokens.size();
+			if(chunk.failed)
+			{
+				// leave out whatever the failing step pushed, it is redone
+				uint32_t stop = (uint32_t) (chunk.stop - begin);
+				while((last > first) && (chunk.tokens.get_offset(last - 1) >= stop))
+				{
+					last--;
+				}
+			}
+
+			stack->splice(chunk.tokens, first, last, chunk.symbols);
+			chunk.spliced = true;
+
+			ptr = chunk.stop;
+			done = !chunk.failed && (chunk.to == end); // the EOF token came with it
+		}
+		else
+		{
+			fixer.m_ptr = ptr;
+			status = fixer.step();
+			ptr = fixer.m_ptr;
+		}
+	}
+
+	delete[] chunks;
+
+	return status;
+}
+
+bool Tokenizer::Stream(const char* file_path, TokenStack* stack)
+{
+	bool status = true;
+
+	SourceBuffer* source = SourceBuffer::Load(file_path);
+	if(source == nullptr)
+	{
+		status = false;
 	}
 
-	if(file != nullptr)
+	if(status)
 	{
-		fclose(file);
+		Stream(source, stack);
 	}
 
 	return status;
 }
+
+void Tokenizer::Stream(SourceBuffer* source, TokenStack* stack)
+{
+	stack->attach_source(source);
+
+	Tokenizer* tokenizer = new Tokenizer();
+	tokenizer->start(source->data(), source->size(), stack);
+	stack->attach_lexer(tokenizer);
+}
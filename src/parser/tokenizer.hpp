@@ -7,20 +7,32 @@
 
 #include <token.hpp>
 #include <token_stack.hpp>
+#include <source_buffer.hpp>
+#include <thread_pool.hpp>
 
 class Tokenizer
 {
 private:
-    char m_input[2];
+    const char* m_begin;
+    const char* m_ptr;
+    const char* m_end;
+    const char* m_token; // start of the token being read
 
-    FILE* m_file;
     std::vector<char> m_buffer;
     TokenStack* m_stack;
 
+    bool m_emitted;  // a token was pushed by the current step
+    bool m_finished; // the EOF token was pushed
+    bool m_quiet;    // errors are not printed, used for speculative chunks
+
 private:
     Tokenizer();
 
+    // prints an error located at the start of the token being read
+    void report(const char* format, ...);
+
     bool expect(char c);
+    void emit(const Token& tk);
     
     int read_escape_character();
 
@@ -29,16 +41,42 @@ private:
     bool read_punctuator();
     bool read_string();
     bool read_character_literal();
-    bool read_decimal();
-    bool read_hexadecimal();
+    bool read_number();
     bool read_single_line_comment();
     bool read_multi_line_comment();
 
     char pop();
-    bool tokenize(FILE* m_file, TokenStack* stack);
+    char peek(unsigned int offset);
+
+    void start(const char* data, unsigned int size, TokenStack* stack);
+    bool step();
+    bool tokenize(const char* data, unsigned int size, TokenStack* stack);
+    // steps from ptr until a step starts at or past to; a range ending at the
+    // end of the source runs through to the EOF token
+    bool lex_range(const char* ptr, const char* to);
 
 public:
+    // lexes the whole source into the stack up front
     static bool Tokenize(const char* file_path, TokenStack* stack);
+    static bool Tokenize(SourceBuffer* source, TokenStack* stack);
+
+    // splits the source at line breaks and lexes the pieces on the pool, then
+    // stitches them together in order. A piece that started inside a comment
+    // or string is relexed from where the previous one really ended, so the
+    // result, ids included, is the same as Tokenize's. Pieces are at least
+    // chunk_size bytes and a small source is lexed on the calling thread.
+    static bool TokenizeParallel(const char* file_path, TokenStack* stack, ThreadPool* pool);
+    static bool TokenizeParallel(SourceBuffer* source, TokenStack* stack, ThreadPool* pool, unsigned int chunk_size = 1 << 20);
+
+    // hands a tokenizer to the stack, which lexes on demand as it is read
+    static bool Stream(const char* file_path, TokenStack* stack);
+    static void Stream(SourceBuffer* source, TokenStack* stack);
+
+    // lexes until one more token has been pushed, false on a lexing error
+    bool next();
+    bool finished() const;
+    // where the token being read starts, so where next() found an error
+    uint32_t offset() const;
 };
 
 #endif // TOKENIZER_HPP
@@ -0,0 +1,264 @@
+#include <type_context.hpp>
+
+#include <assert.h>
+
+static uint32_t mix(uint32_t hash, uint64_t value)
+{
+    value *= 0x9E3779B97F4A7C15ull;
+    hash ^= (uint32_t) (value >> 32);
+    return (hash * 0x01000193u) ^ (hash >> 15);
+}
+
+TypeContext::TypeContext(AstArena* arena)
+{
+    m_arena = arena;
+
+    for(unsigned int f = 0; f < FLAG_VALUES; f++)
+    {
+        for(unsigned int t = 0; t < PRIMITIVE_COUNT; t++)
+        {
+            m_primitives[f][t] = Type {};
+            m_primitives[f][t].type = (uint8_t) t;
+            m_primitives[f][t].flags.all = (uint8_t) f;
+            m_primitives[f][t].unqualified = &m_primitives[0][t];
+        }
+    }
+
+    m_slots.resize(INITIAL_SLOTS, Slot { 0, nullptr });
+    m_mask = INITIAL_SLOTS - 1;
+    m_used = 0;
+    m_requests = 0;
+    m_unevaluated = 0;
+}
+
+TypeContext::~TypeContext()
+{
+}
+
+uint32_t TypeContext::Hash(const Key& key)
+{
+    uint32_t hash = mix(key.type, key.flags.all);
+    hash = mix(hash, (uintptr_t) key.first);
+    hash = mix(hash, key.count);
+    if(key.count == Type::Array::UNEVALUATED)
+    {
+        hash = mix(hash, (uintptr_t) key.size);
+    }
+    for(unsigned int i = 0; (key.params != nullptr) && (i < key.count); i++)
+    {
+        hash = mix(hash, (uintptr_t) key.params[i]);
+    }
+    return hash;
+}
+
+bool TypeContext::Matches(const Type* type, const Key& key)
+{
+    bool match = (type->type == key.type) && (type->flags.all == key.flags.all);
+
+    if(match)
+    {
+        switch(type->type)
+        {
+            case TYPE_PTR:       { match = (type->data.pointer == key.first); break; }
+            case TYPE_ARRAY:
+            {
+                const Type::Array& array = type->data.array;
+                match = (array.elements == key.first) && (array.count == key.count);
+                // unevaluated sizes are only the same when they are the same expression
+                match = match && ((key.count != Type::Array::UNEVALUATED) || (array.size == key.size));
+                break;
+            }
+            case TYPE_COMPOSITE: { match = (type->data.composite == key.first); break; }
+            case TYPE_FUNCTION:
+            {
+                const List<Type>& params = type->data.function.parameters;
+                match = (type->data.function.return_type == key.first) && (params.size() == key.count);
+                for(unsigned int i = 0; match && (i < key.count); i++)
+                {
+                    match = (params[i] == key.params[i]);
+                }
+                break;
+            }
+            default:
+            {
+                match = false;
+                break;
+            }
+        }
+    }
+
+    return match;
+}
+
+Type* TypeContext::make(const Key& key)
+{
+    Type* type = m_arena->make<Type>();
+    type->type = key.type;
+    type->flags.all = key.flags.all;
+
+    switch(key.type)
+    {
+        case TYPE_PTR:
+        {
+            type->data.pointer = (Type*) key.first;
+            break;
+        }
+        case TYPE_ARRAY:
+        {
+            type->data.array.size = key.size;
+            type->data.array.elements = (Type*) key.first;
+            type->data.array.count = key.count;
+            break;
+        }
+        case TYPE_COMPOSITE:
+        {
+            type->data.composite = (Composite*) key.first;
+            break;
+        }
+        case TYPE_FUNCTION:
+        {
+            type->data.function.return_type = (Type*) key.first;
+
+            ListBuilder<Type> list(&m_list_stack);
+            for(unsigned int i = 0; i < key.count; i++)
+            {
+                list.insert(key.params[i]);
+            }
+            list.seal(&type->data.function.parameters, m_arena);
+            break;
+        }
+        default:
+        {
+            assert(false);
+            break;
+        }
+    }
+
+    return type;
+}
+
+void TypeContext::grow()
+{
+    std::vector<Slot> slots;
+    slots.swap(m_slots);
+
+    m_mask = (m_mask << 1) | 1;
+    m_slots.resize((size_t) m_mask + 1, Slot { 0, nullptr });
+
+    for(const Slot& slot : slots)
+    {
+        if(slot.type != nullptr)
+        {
+            uint32_t i = slot.hash & m_mask;
+            while(m_slots[i].type != nullptr)
+            {
+                i = (i + 1) & m_mask;
+            }
+            m_slots[i] = slot;
+        }
+    }
+}
+
+Type* TypeContext::intern(const Key& key)
+{
+    // the variant without flags exists before the one that links to it
+    Type* unqualified = nullptr;
+    if(key.flags.all != 0)
+    {
+        Key plain = key;
+        plain.flags.all = 0;
+        unqualified = intern(plain);
+    }
+
+    uint32_t hash = Hash(key);
+    uint32_t i = hash & m_mask;
+    while((m_slots[i].type != nullptr) && ((m_slots[i].hash != hash) || !Matches(m_slots[i].type, key)))
+    {
+        i = (i + 1) & m_mask;
+    }
+
+    Type* type = m_slots[i].type;
+    if(type == nullptr)
+    {
+        type = make(key);
+        type->unqualified = (unqualified != nullptr) ? unqualified : type;
+        m_slots[i] = Slot { hash, type };
+        m_used++;
+
+        // at most half full
+        if(m_used * 2 > m_mask)
+        {
+            grow();
+        }
+    }
+
+    return type;
+}
+
+Type* TypeContext::primitive(uint8_t type, Type::Flags flags)
+{
+    assert((type >= TYPE_VOID) && (type < PRIMITIVE_COUNT) && (flags.all < FLAG_VALUES));
+
+    m_requests++;
+    return &m_primitives[flags.all][type];
+}
+
+Type* TypeContext::pointer(Type* pointee, Type::Flags flags)
+{
+    Key key = { TYPE_PTR, flags, pointee, 0, nullptr, nullptr };
+    m_requests++;
+    return intern(key);
+}
+
+Type* TypeContext::array(Type* elements, Expression* size, Type::Flags flags)
+{
+    uint64_t count = (size != nullptr) ? Type::Array::UNEVALUATED : Type::Array::UNSIZED;
+    Key key = { TYPE_ARRAY, flags, elements, count, nullptr, size };
+    m_requests++;
+    m_unevaluated += (size != nullptr) ? 1 : 0;
+    return intern(key);
+}
+
+Type* TypeContext::array(Type* elements, uint64_t count, Type::Flags flags, Expression* size)
+{
+    assert(count != Type::Array::UNEVALUATED);
+
+    // size is not matched on, the first array of count elements keeps its own
+    Key key = { TYPE_ARRAY, flags, elements, count, nullptr, size };
+    m_requests++;
+    return intern(key);
+}
+
+Type* TypeContext::function(Type* return_type, Type* const* params, unsigned int count, Type::Flags flags)
+{
+    Key key = { TYPE_FUNCTION, flags, return_type, count, params, nullptr };
+    m_requests++;
+    return intern(key);
+}
+
+Type* TypeContext::composite(Composite* composite, Type::Flags flags)
+{
+    Key key = { TYPE_COMPOSITE, flags, composite, 0, nullptr, nullptr };
+    m_requests++;
+    return intern(key);
+}
+
+size_t TypeContext::size() const
+{
+    return m_used;
+}
+
+size_t TypeContext::requests() const
+{
+    return m_requests;
+}
+
+size_t TypeContext::unevaluated() const
+{
+    return m_unevaluated;
+}
+
+void TypeContext::evaluated()
+{
+    m_unevaluated = 0;
+}
@@ -0,0 +1,100 @@
+#ifndef TYPE_CONTEXT_HPP
+#define TYPE_CONTEXT_HPP
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <ast.hpp>
+
+// The canonical types of one AST. Types are only ever built through here and
+// each distinct type exists once: the primitives are singletons per set of
+// flags, and pointer, array, function and composite types are hash-consed on
+// their components and flags. Components are canonical themselves, so two
+// types are the same type exactly when their pointers are equal, and the
+// memory types take grows with the distinct types of a program rather than
+// with how often they are written. Types are immutable once built.
+//
+// A function type is keyed on its return and parameter types only, the
+// names of the parameters belong to the declaration. An array is keyed on
+// the number of its elements, which the parser cannot know: as written, an
+// array of N elements is keyed on the expression N and so is distinct per
+// mention, until ConstantEvaluator::Dimensions evaluates it and replaces it
+// with the array keyed on the count. Every type links to its variant without
+// flags, so two types that only differ in their outermost flags have the same
+// unqualified pointer.
+class TypeContext
+{
+private:
+    enum
+    {
+        INITIAL_SLOTS   = 256,
+        PRIMITIVE_COUNT = TYPE_F64 + 1,
+        FLAG_VALUES     = 4 // every value of Type::Flags::all
+    };
+
+    struct Slot
+    {
+        uint32_t hash;
+        Type*    type; // nullptr when empty
+    };
+
+    // what a composite type is made of, before it exists
+    struct Key
+    {
+        uint8_t     type;
+        Type::Flags flags;
+        const void* first;  // pointee, elements, return type or composite
+        uint64_t    count;  // array elements or parameters
+        Type* const* params;
+        Expression* size;   // array size, only a key while count is UNEVALUATED
+    };
+
+    AstArena* m_arena;
+    Type      m_primitives[FLAG_VALUES][PRIMITIVE_COUNT];
+
+    std::vector<Slot>  m_slots;
+    uint32_t           m_mask;
+    uint32_t           m_used;
+    size_t             m_requests;   // types asked for, shared or not
+    std::vector<void*> m_list_stack; // for sealing parameter lists
+    size_t             m_unevaluated; // arrays made from a size, see unevaluated()
+
+private:
+    static uint32_t Hash(const Key& key);
+    static bool Matches(const Type* type, const Key& key);
+
+    Type* intern(const Key& key);
+    Type* make(const Key& key);
+    void  grow();
+
+public:
+    // the types are allocated from arena, which must outlive the context
+    TypeContext(AstArena* arena);
+    ~TypeContext();
+
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+
+    // type is one of TYPE_VOID to TYPE_F64
+    Type* primitive(uint8_t type, Type::Flags flags);
+    Type* pointer(Type* pointee, Type::Flags flags);
+    // an array as written, size is nullptr for T[]
+    Type* array(Type* elements, Expression* size, Type::Flags flags);
+    // an array of count elements, count is Type::Array::UNSIZED for T[]; size
+    // is what the new type keeps as the expression that gave it
+    Type* array(Type* elements, uint64_t count, Type::Flags flags, Expression* size = nullptr);
+    // the parameter types are copied when the signature is new
+    Type* function(Type* return_type, Type* const* params, unsigned int count, Type::Flags flags);
+    Type* composite(Composite* composite, Type::Flags flags);
+
+    // distinct non-primitive types built so far
+    size_t size() const;
+    // every type asked for, the primitives included
+    size_t requests() const;
+    // arrays made from a size since they were last all evaluated
+    size_t unevaluated() const;
+    void   evaluated();
+};
+
+#endif // TYPE_CONTEXT_HPP
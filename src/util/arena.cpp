@@ -0,0 +1,96 @@
+#include "arena.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+Arena::Arena(size_t chunk_size)
+{
+    m_chunks = nullptr;
+    m_ptr = nullptr;
+    m_end = nullptr;
+    m_chunk_size = chunk_size;
+
+    m_allocated = 0;
+    m_allocations = 0;
+    m_reserved = 0;
+    m_chunk_count = 0;
+}
+
+Arena::~Arena()
+{
+    reset();
+}
+
+void* Arena::grow(size_t size, size_t align)
+{
+    // oversized requests get a dedicated chunk so the current one keeps its space
+    size_t capacity = size + align;
+    if(capacity < m_chunk_size)
+    {
+        capacity = m_chunk_size;
+    }
+
+    Chunk* chunk = (Chunk*) malloc(sizeof(Chunk) + capacity);
+    chunk->size = capacity;
+
+    m_reserved += capacity;
+    m_chunk_count++;
+
+    char* data = (char*) (chunk + 1);
+    uintptr_t ptr = ((uintptr_t) data + (align - 1)) & ~(uintptr_t) (align - 1);
+
+    if((capacity == m_chunk_size) || (m_chunks == nullptr))
+    {
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+
+        m_ptr = (char*) (ptr + size);
+        m_end = data + capacity;
+    }
+    else
+    {
+        // keep bumping from the current chunk
+        chunk->next = m_chunks->next;
+        m_chunks->next = chunk;
+    }
+
+    return (void*) ptr;
+}
+
+char* Arena::copy_string(const char* str, unsigned int len)
+{
+    char* copy = (char*) allocate(len + 1, 1);
+    memcpy(copy, str, len);
+    copy[len] = 0;
+    return copy;
+}
+
+void Arena::reset()
+{
+    for(Chunk* it = m_chunks; it != nullptr;)
+    {
+        Chunk* chunk = it;
+        it = it->next;
+
+        free(chunk);
+    }
+
+    m_chunks = nullptr;
+    m_ptr = nullptr;
+    m_end = nullptr;
+
+    m_allocated = 0;
+    m_allocations = 0;
+    m_reserved = 0;
+    m_chunk_count = 0;
+}
+
+Arena::Stats Arena::get_stats() const
+{
+    Stats stats = {};
+    stats.allocated = m_allocated;
+    stats.allocations = m_allocations;
+    stats.reserved = m_reserved;
+    stats.chunks = m_chunk_count;
+    return stats;
+}
@@ -0,0 +1,70 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump-pointer allocator. Memory is handed out from large chunks and is only
+// ever released all at once, by reset() or by destroying the arena.
+class Arena
+{
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    Chunk* m_chunks;
+    char*  m_ptr;
+    char*  m_end;
+    size_t m_chunk_size;
+
+    size_t m_allocated;   // bytes handed out
+    size_t m_allocations;
+    size_t m_reserved;    // bytes in chunks
+    size_t m_chunk_count;
+
+private:
+    void* grow(size_t size, size_t align);
+
+public:
+    struct Stats
+    {
+        size_t allocated;   // bytes handed out
+        size_t allocations;
+        size_t reserved;    // bytes obtained from malloc, excluding headers
+        size_t chunks;
+    };
+
+public:
+    Arena(size_t chunk_size = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(void*))
+    {
+        m_allocated += size;
+        m_allocations++;
+
+        uintptr_t ptr = ((uintptr_t) m_ptr + (align - 1)) & ~(uintptr_t) (align - 1);
+        if((m_ptr == nullptr) || (ptr + size > (uintptr_t) m_end))
+        {
+            return grow(size, align);
+        }
+        m_ptr = (char*) (ptr + size);
+        return (void*) ptr;
+    }
+
+    // copies [str, str + len) and null-terminates the copy
+    char* copy_string(const char* str, unsigned int len);
+
+    void reset();
+
+    // reserved - allocated is what alignment and chunk tails waste
+    Stats get_stats() const;
+};
+
+#endif // ARENA_HPP
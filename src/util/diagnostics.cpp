@@ -0,0 +1,56 @@
+#include "diagnostics.hpp"
+
+#include <stdio.h>
+
+static thread_local std::string* s_capture = nullptr;
+
+void Diagnostics::Print(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    VPrint(format, args);
+    va_end(args);
+}
+
+void Diagnostics::VPrint(const char* format, va_list args)
+{
+    if(s_capture == nullptr)
+    {
+        vprintf(format, args);
+    }
+    else
+    {
+        char line[512];
+
+        va_list copy;
+        va_copy(copy, args);
+        int length = vsnprintf(line, sizeof(line), format, copy);
+        va_end(copy);
+
+        if(length < 0)
+        {
+            // nothing to keep
+        }
+        else if((size_t) length < sizeof(line))
+        {
+            s_capture->append(line, (size_t) length);
+        }
+        else
+        {
+            size_t offset = s_capture->size();
+            s_capture->resize(offset + (size_t) length + 1);
+            vsnprintf(&(*s_capture)[offset], (size_t) length + 1, format, args);
+            s_capture->resize(offset + (size_t) length);
+        }
+    }
+}
+
+void Diagnostics::Capture(std::string* buffer)
+{
+    s_capture = buffer;
+}
+
+void Diagnostics::Release()
+{
+    s_capture = nullptr;
+}
@@ -0,0 +1,25 @@
+#ifndef DIAGNOSTICS_HPP
+#define DIAGNOSTICS_HPP
+
+#include <stdarg.h>
+
+#include <string>
+
+// Where error messages go. By default they are printed to stdout as they are
+// reported. A thread compiling one file among several can capture its
+// messages into a buffer instead, so that the driver can print each file's
+// messages together and in the order the files were given, whichever thread
+// finished first.
+class Diagnostics
+{
+public:
+    static void Print(const char* format, ...);
+    static void VPrint(const char* format, va_list args);
+
+    // until Release(), messages reported on the calling thread are appended
+    // to buffer instead of being printed
+    static void Capture(std::string* buffer);
+    static void Release();
+};
+
+#endif // DIAGNOSTICS_HPP
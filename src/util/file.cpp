@@ -2,6 +2,8 @@
 
 #include <stdio.h>
 
+#include <diagnostics.hpp>
+
 File::File()
 {
     m_handle = nullptr;
@@ -23,12 +25,12 @@ File* File::Open(const char* path, unsigned int mode)
         handle = fopen(path, modes[mode]);
         if(handle == nullptr)
         {
-            printf("could not find or open file \"%s\"\n", path);
+            Diagnostics::Print("could not find or open file \"%s\"\n", path);
         }
     }
     else
     {
-        printf("invalid file mode\n");
+        Diagnostics::Print("invalid file mode\n");
     }
 
     if(handle != nullptr)
@@ -54,7 +56,7 @@ bool File::seek(unsigned int offset, unsigned int origin)
     if(fseek(m_handle, offset, origin) != 0)
     {
         status = false;
-        printf("fseek failure\n");
+        Diagnostics::Print("fseek failure\n");
     }
     return status;
 }
@@ -64,7 +66,7 @@ long File::position()
     long pos = ftell(m_handle);
     if(pos == -1L)
     {
-        printf("ftell failure\n");
+        Diagnostics::Print("ftell failure\n");
     }
     return pos;
 }
@@ -95,7 +97,7 @@ bool File::read(void* buffer, unsigned int element_size, unsigned int element_co
     if(fread(buffer, element_size, element_count, m_handle) != element_size * element_count)
     {
         status = false;
-        printf("read failure\n");
+        Diagnostics::Print("read failure\n");
     }
     return status;
 }
@@ -120,7 +122,7 @@ char* File::Read(const char* path, unsigned int& buffer_size)
 
             if(!file->read(buffer, 1, size))
             {
-                printf("Error: Failed to read contents of %s\n", path);
+                Diagnostics::Print("Error: Failed to read contents of %s\n", path);
                 
                 delete[] buffer;
                 buffer = nullptr;
@@ -0,0 +1,209 @@
+#include "interner.hpp"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t INITIAL_SLOTS = 1024;
+
+Interner::Interner() : m_strings(256 * 1024)
+{
+    m_count = 0;
+
+    m_table = (Slot*) calloc(INITIAL_SLOTS, sizeof(Slot));
+    m_mask = INITIAL_SLOTS - 1;
+
+    m_old_table = nullptr;
+    m_old_mask = 0;
+    m_migrated = 0;
+
+    m_shared = nullptr;
+
+    // id 0 is reserved for the empty name and never enters the table
+    m_segments.push_back(new strptr[SEGMENT_SIZE]);
+    m_segments[0][0].ptr = "";
+    m_segments[0][0].len = 0;
+    m_count = 1;
+}
+
+Interner::~Interner()
+{
+    free(m_table);
+    free(m_old_table);
+
+    for(unsigned int i = 0; i < m_segments.size(); i++)
+    {
+        delete[] m_segments[i];
+    }
+}
+
+uint32_t Interner::Hash(const char* ptr, unsigned int len)
+{
+    const uint64_t K = 0x9E3779B97F4A7C15ull;
+
+    // eight bytes per step, the tail is zero-padded into one last word
+    uint64_t h = (uint64_t) len * K;
+    while(len >= 8)
+    {
+        uint64_t w = 0;
+        memcpy(&w, ptr, 8);
+
+        h = (h ^ w) * K;
+        h ^= h >> 32;
+
+        ptr += 8;
+        len -= 8;
+    }
+
+    if(len > 0)
+    {
+        uint64_t w = 0;
+        memcpy(&w, ptr, len);
+
+        h = (h ^ w) * K;
+        h ^= h >> 32;
+    }
+
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+
+    return (uint32_t) h;
+}
+
+void Interner::share(SharedInterner* shared)
+{
+    assert(m_count == 1);
+    m_shared = shared;
+}
+
+uint32_t Interner::probe(const Slot* table, uint32_t mask, uint32_t hash, const char* ptr, unsigned int len) const
+{
+    uint32_t id = SYMBOL_NULL;
+
+    for(uint32_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        const Slot& slot = table[i];
+        if(slot.id == 0)
+        {
+            break;
+        }
+        else if(slot.hash == hash)
+        {
+            const strptr& str = get(slot.id);
+            if((str.len == len) && (memcmp(str.ptr, ptr, len) == 0))
+            {
+                id = slot.id;
+                break;
+            }
+        }
+    }
+
+    return id;
+}
+
+void Interner::place(uint32_t hash, uint32_t id)
+{
+    uint32_t i = hash & m_mask;
+    while(m_table[i].id != 0)
+    {
+        i = (i + 1) & m_mask;
+    }
+
+    m_table[i].hash = hash;
+    m_table[i].id = id;
+}
+
+void Interner::migrate()
+{
+    // entries stay in the old table as well, so its probe chains remain intact
+    for(unsigned int i = 0; (i < MIGRATE_STEPS) && (m_old_table != nullptr); i++)
+    {
+        if(m_migrated > m_old_mask)
+        {
+            free(m_old_table);
+            m_old_table = nullptr;
+        }
+        else
+        {
+            const Slot& slot = m_old_table[m_migrated++];
+            if(slot.id != 0)
+            {
+                place(slot.hash, slot.id);
+            }
+        }
+    }
+}
+
+uint32_t Interner::lookup(uint32_t hash, const char* ptr, unsigned int len) const
+{
+    uint32_t id = probe(m_table, m_mask, hash, ptr, len);
+    if((id == SYMBOL_NULL) && (m_old_table != nullptr))
+    {
+        id = probe(m_old_table, m_old_mask, hash, ptr, len);
+    }
+
+    return id;
+}
+
+uint32_t Interner::find(const char* ptr, unsigned int len) const
+{
+    uint32_t id = SYMBOL_NULL;
+    if(m_shared != nullptr)
+    {
+        id = m_shared->find(ptr, len);
+    }
+    else if(len > 0)
+    {
+        id = lookup(Hash(ptr, len), ptr, len);
+    }
+    return id;
+}
+
+uint32_t Interner::insert(const char* ptr, unsigned int len)
+{
+    uint32_t hash = Hash(ptr, len);
+    uint32_t id = (len > 0) ? lookup(hash, ptr, len) : SYMBOL_NULL;
+
+    if((id == SYMBOL_NULL) && (len > 0))
+    {
+        migrate();
+
+        // keep the load factor at or below one half
+        if((m_count + 1) * 2 > m_mask + 1)
+        {
+            while(m_old_table != nullptr)
+            {
+                migrate();
+            }
+
+            m_old_table = m_table;
+            m_old_mask = m_mask;
+            m_migrated = 0;
+
+            // calloc hands large blocks out as untouched zero pages, so this
+            // does not stall on clearing the new table either
+            m_table = (Slot*) calloc((size_t) (m_mask + 1) * 2, sizeof(Slot));
+            m_mask = (m_mask << 1) | 1;
+        }
+
+        id = m_count++;
+        if((id >> SEGMENT_BITS) == m_segments.size())
+        {
+            m_segments.push_back(new strptr[SEGMENT_SIZE]);
+        }
+
+        strptr& str = m_segments[id >> SEGMENT_BITS][id & (SEGMENT_SIZE - 1)];
+        str.ptr = m_strings.copy_string(ptr, len);
+        str.len = len;
+
+        place(hash, id);
+    }
+
+    return id;
+}
+
+uint32_t Interner::intern(const char* ptr, unsigned int len)
+{
+    return (m_shared != nullptr) ? m_shared->intern(ptr, len) : insert(ptr, len);
+}
@@ -0,0 +1,90 @@
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <arena.hpp>
+#include <shared_interner.hpp>
+#include <strptr.hpp>
+
+// id of the empty name, e.g. an unnamed parameter
+static const uint32_t SYMBOL_NULL = 0;
+
+// Maps identifier spellings to dense 32-bit symbol ids, so that two names are
+// equal exactly when their ids are. Strings are copied once into an arena and
+// looked up through an open-addressing table that stores each entry's hash.
+// Growing the table never rehashes in one go: the old table is drained a few
+// slots per insertion while lookups consult both.
+//
+// An interner can instead be pointed at a SharedInterner before its first
+// name, after which it only forwards to it. Token stacks lexed on different
+// threads then share one id space.
+class Interner
+{
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t id; // 0 marks an empty slot
+    };
+
+    enum
+    {
+        SEGMENT_BITS  = 16,
+        SEGMENT_SIZE  = 1 << SEGMENT_BITS,
+        MIGRATE_STEPS = 8
+    };
+
+    Arena m_strings;
+
+    // id -> spelling, in fixed-size segments so growth never moves entries
+    std::vector<strptr*> m_segments;
+    uint32_t m_count;
+
+    Slot*    m_table;
+    uint32_t m_mask;
+
+    Slot*    m_old_table;
+    uint32_t m_old_mask;
+    uint32_t m_migrated;
+
+    SharedInterner* m_shared;
+
+private:
+    uint32_t probe(const Slot* table, uint32_t mask, uint32_t hash, const char* ptr, unsigned int len) const;
+    uint32_t lookup(uint32_t hash, const char* ptr, unsigned int len) const;
+    void     place(uint32_t hash, uint32_t id);
+    void     migrate();
+    uint32_t insert(const char* ptr, unsigned int len);
+
+public:
+    Interner();
+    ~Interner();
+
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    static uint32_t Hash(const char* ptr, unsigned int len);
+
+    // forwards everything to shared from now on; nothing may have been
+    // interned yet, and shared must outlive this interner's users
+    void share(SharedInterner* shared);
+    SharedInterner* shared() const { return m_shared; }
+
+    // returns the id of the spelling, adding it if it is new
+    uint32_t intern(const char* ptr, unsigned int len);
+    // returns the id of the spelling, or SYMBOL_NULL if it was never interned
+    uint32_t find(const char* ptr, unsigned int len) const;
+
+    const strptr& get(uint32_t id) const
+    {
+        return (m_shared != nullptr) ? m_shared->get(id) : m_segments[id >> SEGMENT_BITS][id & (SEGMENT_SIZE - 1)];
+    }
+
+    // number of ids handed out, including SYMBOL_NULL
+    uint32_t size() const { return (m_shared != nullptr) ? m_shared->size() : m_count; }
+};
+
+#endif // INTERNER_HPP
@@ -1,22 +1,95 @@
 #ifndef LIST_HPP
 #define LIST_HPP
 
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include <ast_arena.hpp>
+
+// An immutable list of node pointers. Lists of up to INLINE_CAPACITY
+// elements are stored in the list itself, longer ones in a single array in
+// the AST arena. A zeroed List is empty and lists may be copied freely, so
+// they can sit in the node unions. Lists are filled by a ListBuilder.
 template<typename T>
-class List
+struct List
 {
-public:
-    struct Element
+    enum
     {
-        T* ptr;
-        Element* next;
+        INLINE_CAPACITY = 2
     };
-    
-    Element* head;
-    Element* tail;
-    unsigned int count;
 
-    void free();
-    void insert(T* ptr);
+    uint32_t count;
+
+    union
+    {
+        T*  local[INLINE_CAPACITY];
+        T** items;
+    } data;
+
+    T* const* begin() const { return (count <= INLINE_CAPACITY) ? data.local : data.items; }
+    T* const* end() const   { return begin() + count; }
+
+    unsigned int size() const { return count; }
+    bool empty() const        { return count == 0; }
+
+    T* operator[](unsigned int index) const { return begin()[index]; }
+};
+
+// Collects the elements of one list on a scratch stack shared by every
+// builder of a parser, and copies them out in one go with seal(), so each
+// list is allocated once at its final size. Builders nest like the rules
+// that use them: an inner builder is done with before the outer one adds
+// its next element. Elements left unsealed are dropped on destruction.
+template<typename T>
+class ListBuilder
+{
+private:
+    std::vector<void*>* m_stack;
+    size_t m_start;
+
+public:
+    ListBuilder(std::vector<void*>* stack)
+    {
+        m_stack = stack;
+        m_start = stack->size();
+    }
+
+    ~ListBuilder()
+    {
+        m_stack->resize(m_start);
+    }
+
+    ListBuilder(const ListBuilder&) = delete;
+    ListBuilder& operator=(const ListBuilder&) = delete;
+
+    void insert(T* ptr)
+    {
+        m_stack->push_back(ptr);
+    }
+
+    unsigned int size() const
+    {
+        return (unsigned int) (m_stack->size() - m_start);
+    }
+
+    void seal(List<T>* list, AstArena* arena)
+    {
+        List<T> sealed = {};
+        sealed.count = size();
+
+        T** items = sealed.data.local;
+        if(sealed.count > List<T>::INLINE_CAPACITY)
+        {
+            items = (T**) arena->allocate(sealed.count * sizeof(T*), alignof(T*));
+            sealed.data.items = items;
+        }
+        memcpy(items, m_stack->data() + m_start, sealed.count * sizeof(T*));
+
+        *list = sealed;
+        m_stack->resize(m_start);
+    }
 };
 
-#endif // LIST_HPP
\ No newline at end of file
+#endif // LIST_HPP
@@ -0,0 +1,222 @@
+#include "shared_interner.hpp"
+
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <interner.hpp>
+
+static inline unsigned int last_bit(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse(&index, mask);
+    return (unsigned int) index;
+#else
+    return 31 - (unsigned int) __builtin_clz(mask);
+#endif
+}
+
+SharedInterner::Shard::Shard() : strings(16 * 1024)
+{
+    table.store(NewTable(INITIAL_SLOTS), std::memory_order_relaxed);
+    count = 0;
+}
+
+SharedInterner::SharedInterner()
+{
+    m_shards = new Shard[SHARD_COUNT];
+
+    for(unsigned int i = 0; i < SEGMENT_COUNT; i++)
+    {
+        m_segments[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // id 0 is reserved for the empty name and never enters a table
+    strptr* first = new strptr[(size_t) 1 << FIRST_BITS];
+    first[0].ptr = "";
+    first[0].len = 0;
+    m_segments[0].store(first, std::memory_order_relaxed);
+    m_count.store(1, std::memory_order_relaxed);
+}
+
+SharedInterner::~SharedInterner()
+{
+    for(unsigned int i = 0; i < SHARD_COUNT; i++)
+    {
+        Table* table = m_shards[i].table.load(std::memory_order_relaxed);
+        while(table != nullptr)
+        {
+            Table* retired = table->retired;
+            delete[] table->slots;
+            delete table;
+            table = retired;
+        }
+    }
+    delete[] m_shards;
+
+    for(unsigned int i = 0; i < SEGMENT_COUNT; i++)
+    {
+        delete[] m_segments[i].load(std::memory_order_relaxed);
+    }
+}
+
+SharedInterner::Table* SharedInterner::NewTable(uint32_t slots)
+{
+    Table* table = new Table();
+    table->mask = slots - 1;
+    table->slots = new std::atomic<uint64_t>[slots]();
+    table->retired = nullptr;
+    return table;
+}
+
+uint32_t SharedInterner::SegmentOf(uint32_t id, uint32_t* offset)
+{
+    uint32_t segment = 0;
+    if(id < ((uint32_t) 1 << FIRST_BITS))
+    {
+        *offset = id;
+    }
+    else
+    {
+        unsigned int bit = last_bit(id);
+        segment = bit - FIRST_BITS + 1;
+        *offset = id - ((uint32_t) 1 << bit);
+    }
+    return segment;
+}
+
+uint32_t SharedInterner::probe(const Table* table, uint32_t hash, const char* ptr, unsigned int len) const
+{
+    uint32_t id = SYMBOL_NULL;
+
+    for(uint32_t i = hash & table->mask;; i = (i + 1) & table->mask)
+    {
+        uint64_t slot = table->slots[i].load(std::memory_order_acquire);
+        if(slot == 0)
+        {
+            break;
+        }
+        else if((uint32_t) (slot >> 32) == hash)
+        {
+            const strptr& str = get((uint32_t) slot);
+            if((str.len == len) && (memcmp(str.ptr, ptr, len) == 0))
+            {
+                id = (uint32_t) slot;
+                break;
+            }
+        }
+    }
+
+    return id;
+}
+
+void SharedInterner::place(Table* table, uint32_t hash, uint32_t id)
+{
+    uint32_t i = hash & table->mask;
+    while(table->slots[i].load(std::memory_order_relaxed) != 0)
+    {
+        i = (i + 1) & table->mask;
+    }
+
+    // release, so a reader that sees the pair also sees the spelling
+    table->slots[i].store(((uint64_t) hash << 32) | id, std::memory_order_release);
+}
+
+SharedInterner::Table* SharedInterner::grow(Shard* shard)
+{
+    Table* old_table = shard->table.load(std::memory_order_relaxed);
+    Table* table = NewTable((old_table->mask + 1) * 2);
+
+    for(uint32_t i = 0; i <= old_table->mask; i++)
+    {
+        uint64_t slot = old_table->slots[i].load(std::memory_order_relaxed);
+        if(slot != 0)
+        {
+            place(table, (uint32_t) (slot >> 32), (uint32_t) slot);
+        }
+    }
+
+    table->retired = old_table;
+    shard->table.store(table, std::memory_order_release);
+
+    return table;
+}
+
+strptr& SharedInterner::entry(uint32_t id)
+{
+    uint32_t offset = 0;
+    uint32_t segment = SegmentOf(id, &offset);
+
+    strptr* data = m_segments[segment].load(std::memory_order_acquire);
+    if(data == nullptr)
+    {
+        // shards add names independently, so two of them may race for a new segment
+        strptr* fresh = new strptr[(size_t) 1 << (segment + FIRST_BITS - 1)];
+        if(m_segments[segment].compare_exchange_strong(data, fresh, std::memory_order_acq_rel))
+        {
+            data = fresh;
+        }
+        else
+        {
+            delete[] fresh;
+        }
+    }
+
+    return data[offset];
+}
+
+uint32_t SharedInterner::find(const char* ptr, unsigned int len) const
+{
+    uint32_t id = SYMBOL_NULL;
+    if(len > 0)
+    {
+        uint32_t hash = Interner::Hash(ptr, len);
+        const Shard& shard = m_shards[hash >> (32 - SHARD_BITS)];
+        id = probe(shard.table.load(std::memory_order_acquire), hash, ptr, len);
+    }
+    return id;
+}
+
+uint32_t SharedInterner::intern(const char* ptr, unsigned int len)
+{
+    uint32_t id = SYMBOL_NULL;
+
+    if(len > 0)
+    {
+        uint32_t hash = Interner::Hash(ptr, len);
+        Shard& shard = m_shards[hash >> (32 - SHARD_BITS)];
+
+        id = probe(shard.table.load(std::memory_order_acquire), hash, ptr, len);
+        if(id == SYMBOL_NULL)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            // another thread may have added it since, or grown the table
+            Table* table = shard.table.load(std::memory_order_relaxed);
+            id = probe(table, hash, ptr, len);
+
+            if(id == SYMBOL_NULL)
+            {
+                // keep the load factor at or below one half
+                if((shard.count + 1) * 2 > table->mask + 1)
+                {
+                    table = grow(&shard);
+                }
+
+                id = m_count.fetch_add(1, std::memory_order_relaxed);
+
+                strptr& str = entry(id);
+                str.ptr = shard.strings.copy_string(ptr, len);
+                str.len = len;
+
+                place(table, hash, id);
+                shard.count++;
+            }
+        }
+    }
+
+    return id;
+}
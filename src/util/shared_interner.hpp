@@ -0,0 +1,97 @@
+#ifndef SHARED_INTERNER_HPP
+#define SHARED_INTERNER_HPP
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+
+#include <arena.hpp>
+#include <strptr.hpp>
+
+// An Interner that any number of threads can use at once, so that files lexed
+// on different workers share one copy of each name and one id space: the same
+// spelling gets the same id in every file. Ids are dense and start after
+// SYMBOL_NULL, as with Interner, which can hand its work to one of these.
+// Which id a name gets depends on which thread adds it first.
+//
+// Names are spread over shards by the top bits of their hash. Looking up a
+// name already present takes no lock: each shard's table is an array of
+// atomic hash/id pairs that only ever go from empty to full. Adding a name
+// locks its shard alone, checks again, copies the spelling into the shard's
+// arena and publishes the pair. A shard that fills up gets a table twice the
+// size; the old one is kept until destruction for readers still probing it,
+// and a reader that misses there simply retries under the lock.
+class SharedInterner
+{
+private:
+    enum
+    {
+        SHARD_BITS      = 6,
+        SHARD_COUNT     = 1 << SHARD_BITS,
+        INITIAL_SLOTS   = 256,
+
+        // id -> spelling lives in segments that double in size, segment k > 0
+        // holding ids [2^(k + FIRST_BITS - 1), 2^(k + FIRST_BITS))
+        FIRST_BITS      = 10,
+        SEGMENT_COUNT   = 32 - FIRST_BITS + 1
+    };
+
+    struct Table
+    {
+        uint32_t mask;
+        std::atomic<uint64_t>* slots; // hash << 32 | id, 0 when empty
+        Table* retired;               // the table this one replaced
+    };
+
+    struct Shard
+    {
+        std::atomic<Table*> table;
+        std::mutex mutex;
+        Arena strings;
+        uint32_t count;
+
+        Shard();
+    };
+
+    Shard* m_shards;
+    std::atomic<strptr*> m_segments[SEGMENT_COUNT];
+    std::atomic<uint32_t> m_count;
+
+private:
+    static Table* NewTable(uint32_t slots);
+
+    uint32_t probe(const Table* table, uint32_t hash, const char* ptr, unsigned int len) const;
+    void     place(Table* table, uint32_t hash, uint32_t id);
+    Table*   grow(Shard* shard);
+    strptr&  entry(uint32_t id);
+
+    static uint32_t SegmentOf(uint32_t id, uint32_t* offset);
+
+public:
+    SharedInterner();
+    ~SharedInterner();
+
+    SharedInterner(const SharedInterner&) = delete;
+    SharedInterner& operator=(const SharedInterner&) = delete;
+
+    // returns the id of the spelling, adding it if it is new
+    uint32_t intern(const char* ptr, unsigned int len);
+    // returns the id of the spelling, or SYMBOL_NULL if it was never interned
+    uint32_t find(const char* ptr, unsigned int len) const;
+
+    // id must have been returned by intern(), on any thread that has since
+    // synchronized with this one
+    const strptr& get(uint32_t id) const
+    {
+        uint32_t offset = 0;
+        uint32_t segment = SegmentOf(id, &offset);
+        return m_segments[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    // number of ids handed out, including SYMBOL_NULL; while other threads are
+    // adding names this may count ids whose spelling is not yet published
+    uint32_t size() const { return m_count.load(std::memory_order_relaxed); }
+};
+
+#endif // SHARED_INTERNER_HPP
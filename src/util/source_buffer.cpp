@@ -0,0 +1,226 @@
+#include "source_buffer.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <diagnostics.hpp>
+
+#ifdef _WIN32
+#include <file.hpp>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+SourceBuffer::SourceBuffer()
+{
+    m_data = "";
+    m_size = 0;
+    m_storage = STORAGE_BORROWED;
+}
+
+SourceBuffer::~SourceBuffer()
+{
+    switch(m_storage)
+    {
+        case STORAGE_HEAP:
+        {
+            delete[] m_data;
+            break;
+        }
+#ifndef _WIN32
+        case STORAGE_MAPPED:
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+            break;
+        }
+#endif
+        default: { break; }
+    }
+}
+
+const char* SourceBuffer::data() const
+{
+    return m_data;
+}
+
+unsigned int SourceBuffer::size() const
+{
+    return m_size;
+}
+
+bool SourceBuffer::is_mapped() const
+{
+    return m_storage == STORAGE_MAPPED;
+}
+
+SourceBuffer* SourceBuffer::Wrap(const char* data, unsigned int size)
+{
+    SourceBuffer* buffer = new SourceBuffer();
+    buffer->m_data = data;
+    buffer->m_size = size;
+    return buffer;
+}
+
+#ifdef _WIN32
+
+bool SourceBuffer::map(int, unsigned int)
+{
+    return false;
+}
+
+bool SourceBuffer::read(int)
+{
+    return false;
+}
+
+SourceBuffer* SourceBuffer::Load(const char* path)
+{
+    SourceBuffer* buffer = nullptr;
+
+    unsigned int size = 0;
+    char* data = File::Read(path, size);
+    if(data != nullptr)
+    {
+        buffer = new SourceBuffer();
+        buffer->m_data = data;
+        buffer->m_size = size;
+        buffer->m_storage = STORAGE_HEAP;
+    }
+
+    return buffer;
+}
+
+#else
+
+bool SourceBuffer::map(int fd, unsigned int size)
+{
+    bool status = true;
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr == MAP_FAILED)
+    {
+        status = false;
+    }
+    else
+    {
+#ifdef MADV_SEQUENTIAL
+        madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+        m_data = (const char*) addr;
+        m_size = size;
+        m_storage = STORAGE_MAPPED;
+    }
+
+    return status;
+}
+
+bool SourceBuffer::read(int fd)
+{
+    bool status = true;
+
+    size_t capacity = 64 * 1024;
+    size_t size = 0;
+    char* data = new char[capacity];
+
+    while(status)
+    {
+        if(size == capacity)
+        {
+            char* grown = new char[capacity * 2];
+            memcpy(grown, data, size);
+            delete[] data;
+
+            data = grown;
+            capacity *= 2;
+        }
+
+        ssize_t count = ::read(fd, data + size, capacity - size);
+        if(count > 0)
+        {
+            size += (size_t) count;
+        }
+        else if(count == 0)
+        {
+            break;
+        }
+        else if(errno != EINTR)
+        {
+            status = false;
+            Diagnostics::Print("read failure\n");
+        }
+    }
+
+    if(status && (size > 0xFFFFFFFFu))
+    {
+        status = false;
+        Diagnostics::Print("error: source file is larger than 4GB\n");
+    }
+
+    if(status)
+    {
+        m_data = data;
+        m_size = (unsigned int) size;
+        m_storage = STORAGE_HEAP;
+    }
+    else
+    {
+        delete[] data;
+    }
+
+    return status;
+}
+
+SourceBuffer* SourceBuffer::Load(const char* path)
+{
+    SourceBuffer* buffer = nullptr;
+
+    int fd = open(path, O_RDONLY);
+    if(fd == -1)
+    {
+        Diagnostics::Print("error: could not open file \"%s\" for reading\n", path);
+    }
+    else
+    {
+        bool status = true;
+        buffer = new SourceBuffer();
+
+        struct stat info;
+        if((fstat(fd, &info) == 0) && S_ISREG(info.st_mode))
+        {
+            if((unsigned long long) info.st_size > 0xFFFFFFFFull)
+            {
+                status = false;
+                Diagnostics::Print("error: source file \"%s\" is larger than 4GB\n", path);
+            }
+            else if(info.st_size == 0)
+            {
+                // nothing to map, keep the empty default
+            }
+            else if(!buffer->map(fd, (unsigned int) info.st_size))
+            {
+                status = buffer->read(fd);
+            }
+        }
+        else
+        {
+            // pipes, character devices, etc. cannot be mapped
+            status = buffer->read(fd);
+        }
+
+        if(!status)
+        {
+            delete buffer;
+            buffer = nullptr;
+        }
+
+        close(fd);
+    }
+
+    return buffer;
+}
+
+#endif
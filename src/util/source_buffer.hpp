@@ -0,0 +1,40 @@
+#ifndef SOURCE_BUFFER_HPP
+#define SOURCE_BUFFER_HPP
+
+// Read-only view over the complete contents of a source file. Regular files
+// are memory-mapped so the tokenizer can lex, and tokens can point, straight
+// into the file's bytes. Pipes and other unmappable inputs are read once into
+// a heap buffer instead. The data is NOT null-terminated.
+class SourceBuffer
+{
+private:
+    enum
+    {
+        STORAGE_BORROWED = 0,
+        STORAGE_HEAP     = 1,
+        STORAGE_MAPPED   = 2
+    };
+
+    const char*  m_data;
+    unsigned int m_size;
+    unsigned int m_storage;
+
+private:
+    SourceBuffer();
+
+    bool map(int fd, unsigned int size);
+    bool read(int fd);
+
+public:
+    static SourceBuffer* Load(const char* path);
+    static SourceBuffer* Wrap(const char* data, unsigned int size);
+
+public:
+    ~SourceBuffer();
+
+    const char*  data() const;
+    unsigned int size() const;
+    bool         is_mapped() const;
+};
+
+#endif // SOURCE_BUFFER_HPP
@@ -0,0 +1,119 @@
+#include "string_pool.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <interner.hpp>
+
+static const uint32_t INITIAL_SLOTS = 256;
+
+StringPool::StringPool() : m_storage(16 * 1024)
+{
+    m_bytes = 0;
+
+    m_table = (Slot*) calloc(INITIAL_SLOTS, sizeof(Slot));
+    m_mask = INITIAL_SLOTS - 1;
+}
+
+StringPool::~StringPool()
+{
+    free(m_table);
+}
+
+void StringPool::grow()
+{
+    uint32_t mask = (m_mask << 1) | 1;
+    Slot* table = (Slot*) calloc((size_t) mask + 1, sizeof(Slot));
+
+    for(uint32_t i = 0; i <= m_mask; i++)
+    {
+        const Slot& slot = m_table[i];
+        if(slot.id != 0)
+        {
+            uint32_t j = slot.hash & mask;
+            while(table[j].id != 0)
+            {
+                j = (j + 1) & mask;
+            }
+            table[j] = slot;
+        }
+    }
+
+    free(m_table);
+    m_table = table;
+    m_mask = mask;
+}
+
+uint32_t StringPool::insert(const char* ptr, unsigned int len, bool copy)
+{
+    uint32_t hash = Interner::Hash(ptr, len);
+    uint32_t id = 0;
+
+    uint32_t i = hash & m_mask;
+    for(; m_table[i].id != 0; i = (i + 1) & m_mask)
+    {
+        if(m_table[i].hash == hash)
+        {
+            const strptr& str = m_strings[m_table[i].id - 1];
+            if((str.len == len) && (memcmp(str.ptr, ptr, len) == 0))
+            {
+                break;
+            }
+        }
+    }
+
+    if(m_table[i].id != 0)
+    {
+        id = m_table[i].id - 1;
+    }
+    else
+    {
+        strptr str = { ptr, len };
+        if(copy)
+        {
+            str.ptr = m_storage.copy_string(ptr, len);
+        }
+
+        id = (uint32_t) m_strings.size();
+        m_strings.push_back(str);
+        m_bytes += len;
+
+        m_table[i].hash = hash;
+        m_table[i].id = id + 1;
+
+        // keep the load factor at or below one half
+        if(m_strings.size() * 2 > (size_t) m_mask + 1)
+        {
+            grow();
+        }
+    }
+
+    return id;
+}
+
+uint32_t StringPool::add(const char* ptr, unsigned int len)
+{
+    return insert(ptr, len, false);
+}
+
+uint32_t StringPool::add_copy(const char* ptr, unsigned int len)
+{
+    return insert(ptr, len, true);
+}
+
+void StringPool::emit(std::vector<char>& blob, std::vector<uint32_t>& offsets) const
+{
+    blob.clear();
+    blob.reserve(m_bytes + m_strings.size());
+
+    offsets.resize(m_strings.size());
+
+    for(uint32_t i = 0; i < m_strings.size(); i++)
+    {
+        const strptr& str = m_strings[i];
+
+        offsets[i] = (uint32_t) blob.size();
+        blob.insert(blob.end(), str.ptr, str.ptr + str.len);
+        blob.push_back(0);
+    }
+}
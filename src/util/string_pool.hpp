@@ -0,0 +1,57 @@
+#ifndef STRING_POOL_HPP
+#define STRING_POOL_HPP
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <arena.hpp>
+#include <strptr.hpp>
+
+// Stores each distinct string literal once and numbers them densely. A
+// literal that appears verbatim in the source is referenced in place, so the
+// source must outlive the pool; only literals whose contents differ from
+// their spelling (because of escape sequences) are copied into the arena.
+class StringPool
+{
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t id; // index + 1, 0 marks an empty slot
+    };
+
+    Arena m_storage;
+    std::vector<strptr> m_strings;
+    uint64_t m_bytes; // total length of the distinct strings
+
+    Slot*    m_table;
+    uint32_t m_mask;
+
+private:
+    uint32_t insert(const char* ptr, unsigned int len, bool copy);
+    void     grow();
+
+public:
+    StringPool();
+    ~StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // returns the id of the string, referencing [ptr, ptr + len) if it is new
+    uint32_t add(const char* ptr, unsigned int len);
+    // returns the id of the string, copying it into the pool if it is new
+    uint32_t add_copy(const char* ptr, unsigned int len);
+
+    const strptr& get(uint32_t id) const { return m_strings[id]; }
+
+    uint32_t size() const { return (uint32_t) m_strings.size(); }
+    uint64_t bytes() const { return m_bytes; }
+
+    // lays every string out in one read-only blob, each null-terminated, and
+    // records where string i starts in offsets[i]
+    void emit(std::vector<char>& blob, std::vector<uint32_t>& offsets) const;
+};
+
+#endif // STRING_POOL_HPP
@@ -0,0 +1,94 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    m_running = 0;
+    m_stopping = false;
+
+    if(threads == 0)
+    {
+        threads = 1;
+    }
+
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        m_workers.push_back(std::thread(&ThreadPool::work, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_ready.notify_all();
+
+    for(unsigned int i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+}
+
+unsigned int ThreadPool::HardwareThreads()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    return (threads > 0) ? threads : 1;
+}
+
+unsigned int ThreadPool::size() const
+{
+    return (unsigned int) m_workers.size();
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(true)
+    {
+        m_job_ready.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if(m_jobs.empty())
+        {
+            break; // stopping and drained
+        }
+
+        std::function<void()> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_running++;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        m_running--;
+        if(m_jobs.empty() && (m_running == 0))
+        {
+            m_idle.notify_all();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_job_ready.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && (m_running == 0); });
+}
+
+void ThreadPool::run(unsigned int count, const std::function<void(unsigned int)>& fn)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        submit([&fn, i] { fn(i); });
+    }
+    wait();
+}
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run submitted jobs in FIFO order. wait()
+// blocks until every job submitted so far has finished. A pool created with
+// a single thread runs jobs on that one worker, which keeps ordering simple
+// to reason about when parallelism is turned off.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_ready;
+    std::condition_variable m_idle;
+
+    unsigned int m_running;
+    bool m_stopping;
+
+private:
+    void work();
+
+public:
+    ThreadPool(unsigned int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // number of threads the machine can run at once, at least 1
+    static unsigned int HardwareThreads();
+
+    unsigned int size() const;
+
+    void submit(std::function<void()> job);
+    void wait();
+
+    // runs fn(0) .. fn(count - 1) on the workers and waits for all of them
+    void run(unsigned int count, const std::function<void(unsigned int)>& fn);
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,89 @@
+#include "trace.hpp"
+
+#include <atomic>
+
+namespace
+{
+    // Each slot carries the sequence number of the event it holds, written
+    // after the fields. A reader that sees the same, expected sequence before
+    // and after copying the fields has a complete event; anything else was
+    // overwritten mid-read and is skipped.
+    struct Slot
+    {
+        std::atomic<uint64_t>    sequence; // 0 while empty or being written
+        std::atomic<const char*> name;
+        std::atomic<uint32_t>    a;
+        std::atomic<uint32_t>    b;
+        std::atomic<uint8_t>     category;
+    };
+
+    Slot g_ring[Trace::CAPACITY];
+    std::atomic<uint64_t> g_head(0); // events recorded so far
+}
+
+void Trace::Record(uint8_t category, const char* name, uint32_t a, uint32_t b)
+{
+    uint64_t index = g_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = g_ring[index & (CAPACITY - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.a.store(a, std::memory_order_relaxed);
+    slot.b.store(b, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+unsigned int Trace::Dump(FILE* out)
+{
+    uint64_t head = g_head.load(std::memory_order_acquire);
+    uint64_t first = (head > CAPACITY) ? (head - CAPACITY) : 0;
+
+    unsigned int count = 0;
+    for(uint64_t i = first; i < head; i++)
+    {
+        Slot& slot = g_ring[i & (CAPACITY - 1)];
+
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        const char* name = slot.name.load(std::memory_order_relaxed);
+        uint32_t a = slot.a.load(std::memory_order_relaxed);
+        uint32_t b = slot.b.load(std::memory_order_relaxed);
+        uint8_t category = slot.category.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+
+        if((before == i + 1) && (after == before))
+        {
+            fprintf(out, "trace: %8llu %-6s %-18s %u %u\n", (unsigned long long) i, CategoryName(category), name, a, b);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void Trace::Clear()
+{
+    g_head.store(0, std::memory_order_relaxed);
+    for(unsigned int i = 0; i < CAPACITY; i++)
+    {
+        g_ring[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* Trace::CategoryName(uint8_t category)
+{
+    const char* name = "?";
+    switch(category)
+    {
+        case TRACE_LEXER:  { name = "lexer"; break; }
+        case TRACE_TOKENS: { name = "tokens"; break; }
+        case TRACE_PARSER: { name = "parser"; break; }
+        case TRACE_AST:    { name = "ast"; break; }
+        default: { break; }
+    }
+    return name;
+}
@@ -0,0 +1,53 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Trace categories. A category is compiled in only when its bit is set in
+// C64_TRACE, e.g. -DC64_TRACE=0x6 for token consumption and parser
+// decisions. With the default of 0 every TRACE() is dead code.
+enum TRACE_CATEGORY
+{
+    TRACE_LEXER  = 0x1, // tokens as the tokenizer pushes them
+    TRACE_TOKENS = 0x2, // tokens as the parser pops them
+    TRACE_PARSER = 0x4, // rules the parser picks and errors it hits
+    TRACE_AST    = 0x8  // nodes as they are built
+};
+
+#ifndef C64_TRACE
+#define C64_TRACE 0
+#endif
+
+// An event is a static name and two numbers, recorded into a fixed ring that
+// keeps the most recent CAPACITY events. Recording claims a slot with a single
+// atomic increment and never blocks, so several lexer threads can trace at
+// once. Nothing is printed until Dump() is called.
+class Trace
+{
+public:
+    enum
+    {
+        CAPACITY = 1 << 16 // must be a power of two
+    };
+
+    // name must outlive the trace, in practice a string literal
+    static void Record(uint8_t category, const char* name, uint32_t a, uint32_t b);
+
+    // prints the events still held, oldest first, and returns their count
+    static unsigned int Dump(FILE* out);
+    static void Clear();
+
+    static const char* CategoryName(uint8_t category);
+};
+
+#define TRACE(category, name, a, b)                                                    \
+    do                                                                                 \
+    {                                                                                  \
+        if(((C64_TRACE) & (category)) != 0)                                            \
+        {                                                                              \
+            Trace::Record((uint8_t) (category), (name), (uint32_t) (a), (uint32_t) (b)); \
+        }                                                                              \
+    } while(0)
+
+#endif // TRACE_HPP
@@ -0,0 +1,4 @@
+U32 f()
+{
+    return (U32 (;
+}
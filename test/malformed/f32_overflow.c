@@ -0,0 +1,4 @@
+U32 f()
+{
+    return 3.5e38f32;
+}
@@ -0,0 +1,4 @@
+struct S
+{
+    U32 (;
+};
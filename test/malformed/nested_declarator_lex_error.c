@@ -0,0 +1 @@
+U32 (*0get_pfn())(U32);
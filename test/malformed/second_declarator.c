@@ -0,0 +1 @@
+U32 a, (;
@@ -0,0 +1 @@
+U32 f(U32 a, ) {}
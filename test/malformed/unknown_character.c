@@ -0,0 +1,4 @@
+U32 f(U32 a)
+{
+    return a $ 1;
+}